@@ -9,599 +9,1311 @@
 #include "Button.h"     // Biblioteca do botão
 #include "Led_Matrix.h" // Biblioteca para controle da matriz de LEDs
 #include "ssd1306.h"    // Biblioteca para controle do display OLED
+#include "Region.h"     // Estado das regiões monitoradas
+#include "Telemetry.h"  // Telemetria binária via UDP
+#include "Mqtt.h"       // Publicação dos níveis em um broker MQTT
+#include "Metrics.h"    // Métricas de desempenho (/metrics)
+#include "Trace.h"      // Rastreamento de eventos em anel na RAM
+#include "Console.h"    // Comandos do console USB
+#include "Memory.h"     // Orçamento de memória (pilhas, pools e heaps)
+#include "Idle.h"       // Modo ocioso sem tick fixo
+#include "Wifi.h"       // Conexão Wi-Fi em segundo plano
+#include "Boot.h"       // Linha do tempo do boot
+#include "Config.h"     // Estado das regiões persistido na flash
+#include "Gateway.h"    // Modo gateway: visão da frota
+#include "Sensor.h"     // Sensores de nível analógicos (opcional)
+#include "Webhook.h"    // Webhooks de alerta
+#include "Stream.h"     // Stream binário de amostras pelo USB
+#include "pico/multicore.h" // Núcleo 1 inicializa o OLED em paralelo
+#include "Template.h"   // Renderizador de templates compilados
+#include "Chart.h"      // Gráficos SVG do histórico
+#include "Cache.h"      // Cache de respostas renderizadas
+#include "Admission.h"  // Controle de admissão do servidor HTTP
+#include "Supervisor.h" // Watchdog e post-mortem do laço principal
+#include "dashboard_template.h" // Página principal (gerada de templates/dashboard.html)
+
+#define HTTP_REQUEST_MAX 512  // Parte inicial do request copiada para o tratamento (linha GET e corpo de POST)
+#define ACTUATOR_BATCH_MAX 16 // Comandos aceitos em um POST /api/actuators
 
-// Credenciais WIFI - Tome cuidado se publicar no github!
-#define WIFI_SSID ""   // Nome da rede Wi-Fi
-#define WIFI_PASSWORD "" // Senha da rede Wi-Fi
+char region[20];
 
-#define ALERT_THRESHOLD_A 12
-#define ALERT_THRESHOLD_B 20
+static ssd1306_t ssd;                       // Display OLED; do núcleo 1 até display_ready, depois do laço principal
+static volatile bool display_ready = false; // OLED inicializado pelo núcleo 1
 
-#define ATTENTION_THRESHOLD_A 9
-#define ATTENTION_THRESHOLD_B 16
+static err_t tcp_server_accept(void *arg, struct tcp_pcb *newpcb, err_t err); // Função de callback ao aceitar conexões TCP
 
-#define INITIAL_LEVEL_A 5
-#define INITIAL_LEVEL_B 3
+static err_t tcp_server_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err); // Função de callback para processar requisições HTTP
 
-#define MAX_EVENTS 10
-#define EVENT_LENGTH 32
-#define MAX_READINGS 10
+// Resposta em andamento em cada conexão HTTP
+typedef enum
+{
+    HTTP_IDLE = 0,
+    HTTP_SENDING_PAGE,
+    HTTP_SENDING_CHUNKS,
+    HTTP_SENDING_CACHED
+} http_response;
 
+// Corpo gerado em blocos independentes (/metrics e /api/fleet)
 typedef struct
 {
-    led_color led_color;
-    bool buzzer_on;
-    volatile uint8_t current_level;
-    char led_status_label[EVENT_LENGTH];    // Label para o LED
-    char buzzer_status_label[EVENT_LENGTH]; // Label para o LED
-} region_state;
+    uint16_t (*units)();
+    uint16_t (*render)(uint16_t *cursor, char *buffer, uint16_t size);
+} http_chunked_body;
 
-volatile bool is_region_A = true;
+static const http_chunked_body metrics_body = {metrics_units, metrics_render};
+static const http_chunked_body fleet_body = {gateway_units, gateway_render};
+static const http_chunked_body postmortem_body = {supervisor_units, supervisor_render};
 
-region_state region_A;
-region_state region_B;
+// Linha da tabela da frota no dashboard, copiada de gateway_node_at()
+typedef struct
+{
+    ip_addr_t addr;
+    uint16_t node_id;
+    bool local;
+    bool seen;
+    bool online;
+    uint8_t region_count;
+    telemetry_region regions[TELEMETRY_REGIONS];
+} fleet_row;
+
+// Dados lidos pelos slots fn da página (gráficos, eventos e frota), capturados de uma vez
+typedef struct
+{
+    state_snapshot state;
+    fleet_row fleet[GATEWAY_PEERS_MAX + 1];
+    uint8_t fleet_count;
+} dashboard_snapshot;
 
-uint8_t readings_A[MAX_READINGS] = {INITIAL_LEVEL_A}; // Array para armazenar os níveis de água da região A
-uint8_t readings_B[MAX_READINGS] = {INITIAL_LEVEL_B}; // Array para armazenar os níveis de água da região B
+// Estado de uma conexão HTTP; o pool tem uma entrada por PCB TCP
+typedef struct
+{
+    bool in_use;
+    struct tcp_pcb *pcb;
+    http_response response;
+    template_stream stream;        // Posição no envio da página
+    dashboard_values values;       // Valores capturados no início da resposta
+    dashboard_snapshot snapshot;   // Estado e frota lidos pelos slots fn da mesma resposta
+    const http_chunked_body *body; // Corpo em blocos em andamento
+    uint16_t cursor;               // Próximo bloco do corpo
+    const cache_entry *cached;     // Corpo em cache em andamento (referenciado até a confirmação)
+    uint16_t cached_sent;          // Bytes do corpo em cache já entregues ao TCP
+    uint32_t unacked;              // Bytes entregues ao TCP ainda sem confirmação do cliente
+    uint32_t render_us;            // Tempo acumulado gerando a página
+    uint16_t request_len;          // Bytes do request recebidos até agora
+    uint8_t busy_retry;            // Retry-After do 503 a enviar no primeiro dado (0: conexão admitida)
+    char request[HTTP_REQUEST_MAX + 1];
+} http_connection;
 
-char event_log[MAX_EVENTS][EVENT_LENGTH] = {'\0'}; // Array para armazenar os eventos
-int total_events = 0;
+static http_connection http_connections[MEMP_NUM_TCP_PCB];
 
-char region[20];
+static err_t tcp_server_sent(void *arg, struct tcp_pcb *tpcb, u16_t len); // Função de callback para continuar o envio
 
-static err_t tcp_server_accept(void *arg, struct tcp_pcb *newpcb, err_t err); // Função de callback ao aceitar conexões TCP
+static void tcp_server_err(void *arg, err_t err); // Função de callback para conexões perdidas
 
-static err_t tcp_server_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err); // Função de callback para processar requisições HTTP
+static err_t http_send_busy(struct tcp_pcb *tpcb, http_connection *conn, uint32_t retry_s); // Recusa o request com um 503 curto
 
-void user_request(char **request); // Tratamento do request do usuário
+static void http_release(http_connection *conn); // Libera o estado da conexão e a entrada do cache
 
-void add_reading(uint8_t new_value, uint8_t readings[]); // Move todos os elementos para a esquerda e adiciona novo valor no final
+static bool send_chunks(struct tcp_pcb *tpcb, http_connection *conn); // Envia um corpo gerado em blocos
 
-void convert_readings_to_JSON(uint8_t *readings, char *buffer, int size); // Converte os dados de leitura para JSON
+static bool send_cached(struct tcp_pcb *tpcb, http_connection *conn); // Envia um corpo do cache por referência
 
-void add_event(const char *new_event); // Adiciona um novo evento ao log
+static uint64_t dashboard_version(); // Versão do conteúdo da página principal
 
-void process_led_request(region_state *region, led_color color_on, const char *label_on, const char *label_off, bool turn_on); // Processa o pedido de controle do LED
+static uint16_t render_dashboard(char *buffer, uint16_t size); // Renderiza a página principal inteira (entrada do cache)
+
+static void fill_dashboard_values(dashboard_values *values, dashboard_snapshot *snapshot); // Preenche os slots da página principal
+
+static void http_update_clients(); // Informa ao modo ocioso quantos clientes estão conectados
+
+void user_request(const char *request); // Tratamento do request do usuário
+
+void process_led_request(region_state *region, led_color color_on, peripheral led, bool turn_on); // Processa o pedido de controle do LED
 
 void configure_display(ssd1306_t *ssd); // Configuração do display OLED
 
 void process_buzzer_request(region_state *region, bool turn_on); // Processa o pedido de controle do buzzer
 
-uint32_t last_time_button_J = 0; // Tempo do último pressionamento
-uint32_t last_time_button_A = 0; // Tempo do último pressionamento
-uint32_t last_time_button_B = 0; // Tempo do último pressionamento
+// Periféricos controláveis pelo formulário e por POST /api/actuators
+typedef struct
+{
+    const char *name;       // Valor de "periferico" no formulário
+    const led_color *color; // Cor do LED; NULL para o buzzer
+    peripheral id;          // Código usado nos eventos e no estado exibido
+} actuator;
+
+static const actuator actuators[] = {
+    {"ledO", &ORANGE, PERIPHERAL_LED_ATTENTION},
+    {"ledR", &RED, PERIPHERAL_LED_ALERT},
+    {"ledG", &GREEN, PERIPHERAL_LED_NORMAL},
+    {"buzzer", NULL, PERIPHERAL_BUZZER},
+};
+
+#define ACTUATOR_COUNT (sizeof(actuators) / sizeof(actuators[0]))
+
+typedef struct
+{
+    region_state *region;
+    const actuator *actuator;
+    bool turn_on;
+} actuator_command;
 
-void gpio_irq_handler(uint gpio, uint32_t events)
+// Trata uma borda registrada pela IRQ dos botões (contexto do laço principal)
+static void handle_button_event(const button_event *event)
 {
-    uint32_t now = get_absolute_time();
+    TRACE_BEGIN_ARG(TRACE_BUTTON_EVENT, event->gpio);
+
+    metrics_observe(METRIC_BUTTON_LATENCY, (uint32_t)(time_us_64() - event->time_us));
 
-    if (gpio == BUTTON_J)
+    region_state *selected = is_region_A ? &region_A : &region_B;
+    uint8_t *readings = is_region_A ? readings_A : readings_B;
+
+    if (event->gpio == BUTTON_J)
     {
-        if ((now - last_time_button_J) >= DEBOUNCE_DELAY)
-        {
-            is_region_A = !is_region_A;
-            last_time_button_J = now;
-        }
+        is_region_A = !is_region_A;
+    }
+    else if (event->gpio == BUTTON_A)
+    {
+        selected->current_level++;
+        add_reading(selected->current_level, readings);
+    }
+    else if (event->gpio == BUTTON_B)
+    {
+        if (selected->current_level > 0)
+            selected->current_level--;
+
+        add_reading(selected->current_level, readings);
     }
 
-    else if (gpio == BUTTON_A)
+    publish_state();
+
+    TRACE_END(TRACE_BUTTON_EVENT);
+}
+
+// Estado exibido pelo LED, matriz e display; comparado byte a byte para detectar mudanças
+typedef struct
+{
+    bool is_region_A;
+    uint8_t level_A;
+    uint8_t level_B;
+    led_color color_A;
+    led_color color_B;
+    uint8_t wifi;
+    uint32_t ip;
+    bool display;
+} output_state;
+
+static output_state capture_output_state(const state_snapshot *view)
+{
+    output_state state;
+
+    memset(&state, 0, sizeof(state)); // Zera o padding para o memcmp
+    state.is_region_A = view->is_region_A;
+    state.level_A = view->regions[0].current_level;
+    state.level_B = view->regions[1].current_level;
+    state.color_A = view->regions[0].led_color;
+    state.color_B = view->regions[1].led_color;
+    state.wifi = wifi_get_state();
+    state.ip = netif_default ? ip4_addr_get_u32(netif_ip4_addr(netif_default)) : 0;
+    state.display = display_ready;
+
+    return state;
+}
+
+// Atualiza LED, matriz e display (se já inicializado) com a região selecionada
+static void refresh_outputs(const state_snapshot *view)
+{
+    const region_state *selected = snapshot_selected(view);
+    uint8_t threshold = view->is_region_A ? ALERT_THRESHOLD_A : ALERT_THRESHOLD_B;
+
+    set_led_color(selected->led_color); // Define a cor do LED
+
+    uint32_t matrix_start = time_us_32();
+    update_matrix_from_level(selected->current_level, threshold);
+    metrics_observe(METRIC_MATRIX_UPDATE_TIME, time_us_32() - matrix_start);
+
+    if (!display_ready)
+        return;
+
+    // Define a string com base na variável
+    snprintf(region, sizeof(region), "Regiao: %s", view->is_region_A ? "A" : "B");
+
+    // Exibe no display
+    ssd1306_fill(&ssd, false);
+    if (wifi_get_state() == WIFI_CONNECTED)
     {
-        if ((now - last_time_button_A) >= DEBOUNCE_DELAY)
-        {
-            if (is_region_A)
-            {
-                region_A.current_level++;
-                add_reading(region_A.current_level, readings_A);
-            }
-            else
-            {
-                region_B.current_level++;
-                add_reading(region_B.current_level, readings_B);
-            }
-            last_time_button_A = now;
-        }
+        ssd1306_draw_string(&ssd, ipaddr_ntoa(&netif_default->ip_addr), 5, 5);
+        ssd1306_draw_string(&ssd, "Porta 80", 5, 18);
+    }
+    else
+    {
+        ssd1306_draw_string(&ssd, wifi_get_state() == WIFI_CONNECTING ? "Conectando..." : "Sem Wi-Fi", 5, 5);
+    }
+    ssd1306_draw_string(&ssd, region, 5, 50);
+
+    uint32_t display_start = time_us_32();
+    ssd1306_send_data(&ssd);
+    metrics_observe(METRIC_DISPLAY_SEND_TIME, time_us_32() - display_start);
+}
+
+static struct tcp_pcb *http_listener = NULL;
+
+// Abre o servidor HTTP na porta 80; false se não houver PCB ou a porta estiver ocupada
+static bool http_server_start()
+{
+    // Configura o servidor TCP - cria novos PCBs TCP. É o primeiro passo para estabelecer uma conexão TCP.
+    struct tcp_pcb *server = tcp_new();
+    if (!server)
+        return false;
+
+    // vincula um PCB (Protocol Control Block) TCP a um endereço IP e porta específicos.
+    if (tcp_bind(server, IP_ADDR_ANY, 80) != ERR_OK)
+    {
+        tcp_close(server);
+        return false;
     }
 
-    else if (gpio == BUTTON_B)
+    // Coloca um PCB (Protocol Control Block) TCP em modo de escuta, permitindo que ele aceite conexões de entrada.
+    http_listener = tcp_listen(server);
+    if (!http_listener)
+    {
+        tcp_close(server);
+        return false;
+    }
+
+    // Define uma função de callback para aceitar conexões TCP de entrada. É um passo importante na configuração de servidores TCP.
+    tcp_accept(http_listener, tcp_server_accept);
+    return true;
+}
+
+// Fecha o servidor e aborta as conexões abertas (o enlace caiu)
+static void http_server_stop()
+{
+    if (http_listener)
+    {
+        tcp_close(http_listener);
+        http_listener = NULL;
+    }
+
+    for (int i = 0; i < MEMP_NUM_TCP_PCB; i++)
+    {
+        http_connection *conn = &http_connections[i];
+
+        if (!conn->in_use)
+            continue;
+
+        tcp_arg(conn->pcb, NULL);
+        tcp_recv(conn->pcb, NULL);
+        tcp_sent(conn->pcb, NULL);
+        tcp_err(conn->pcb, NULL);
+        tcp_abort(conn->pcb);
+        http_release(conn);
+    }
+
+    http_update_clients();
+}
+
+// Sobe ou derruba os serviços de rede conforme as transições do Wi-Fi
+static void handle_wifi_event(wifi_event event)
+{
+    switch (event)
     {
-        if ((now - last_time_button_B) >= DEBOUNCE_DELAY)
+    case WIFI_EVENT_STACK_READY:
+        boot_stage_end(BOOT_STAGE_WIFI_STACK);
+        boot_stage_begin(BOOT_STAGE_WIFI_LINK);
+
+        // Consultas aos pares (só com GATEWAY_PEERS definido)
+        configure_gateway();
+
+        // Servidor de telemetria UDP (requisição/resposta e envio periódico)
+        configure_telemetry();
+
+        // Publicador MQTT (conecta em segundo plano, sem bloquear o laço)
+        configure_mqtt();
+        break;
+
+    case WIFI_EVENT_LINK_UP:
+        boot_stage_end(BOOT_STAGE_WIFI_LINK);
+        boot_stage_begin(BOOT_STAGE_HTTP);
+
+        // Sem o servidor HTTP o nó continua operando localmente; a próxima queda/volta tenta de novo
+        cyw43_arch_lwip_begin();
+        if (!http_listener && !http_server_start())
+            printf("Falha ao abrir a porta 80\n");
+        cyw43_arch_lwip_end();
+
+        // Primeira vez com o servidor no ar: fim do boot
+        if (http_listener && !boot_stage_done(BOOT_STAGE_HTTP))
         {
-            if (is_region_A)
-            {
-                if (region_A.current_level > 0)
-                {
-                    region_A.current_level--;
-                    add_reading(region_A.current_level, readings_A);
-                }
-                else
-                    add_reading(region_A.current_level, readings_A);
-            }
-            else
-            {
-                if (region_B.current_level > 0)
-                {
-                    region_B.current_level--;
-                    add_reading(region_B.current_level, readings_B);
-                }
-                else
-                    add_reading(region_B.current_level, readings_B);
-            }
-            last_time_button_B = now;
+            boot_stage_end(BOOT_STAGE_HTTP);
+            boot_report();
         }
+        break;
+
+    case WIFI_EVENT_LINK_DOWN:
+        cyw43_arch_lwip_begin();
+        http_server_stop();
+        cyw43_arch_lwip_end();
+        break;
+
+    default:
+        break;
     }
 }
 
+static absolute_time_t earliest_deadline(absolute_time_t a, absolute_time_t b)
+{
+    return absolute_time_diff_us(a, b) < 0 ? b : a;
+}
+
+// Núcleo 1: inicializa o OLED enquanto o núcleo 0 sobe a rede. Ao retornar, o
+// núcleo 1 volta ao laço de espera do bootrom (fora da flash, o que libera as
+// gravações de Config.h) e o display passa para o laço principal.
+static void display_boot()
+{
+    boot_stage_begin(BOOT_STAGE_DISPLAY);
+    configure_display(&ssd);
+    boot_stage_end(BOOT_STAGE_DISPLAY);
+
+    __dmb();
+    display_ready = true;
+    idle_wake();
+}
+
 int main()
 {
+    boot_stage_end(BOOT_STAGE_RUNTIME);
+
+    configure_trace(); // Spinlock do anel de trace, antes de o núcleo 1 gravar
+
+    configure_memory(); // Preenche as pilhas livres para medir a marca d'água
+
+    // Boot em etapas: primeiro o que mantém os alarmes funcionando, depois
+    // display (núcleo 1) e rede (em segundo plano) em paralelo
+    boot_stage_begin(BOOT_STAGE_CLOCKS);
+    init_system_config(); // Relógio e stdio (o PWM depende do relógio do sistema)
+    boot_stage_end(BOOT_STAGE_CLOCKS);
+
+    boot_stage_begin(BOOT_STAGE_CONFIG);
+    init_regions();                // Estado padrão das regiões
+    bool restored = config_load(); // Estado gravado antes do último desligamento
+    configure_webhook();           // Endpoints e fila de alertas preservada (após restaurar as classes)
+    boot_stage_end(BOOT_STAGE_CONFIG);
+
+    boot_stage_begin(BOOT_STAGE_INPUTS);
     configure_button(BUTTON_J); // Configura o botão J
     configure_button(BUTTON_A); // Configura o botão A
     configure_button(BUTTON_B); // Configura o botão B
-    gpio_set_irq_enabled_with_callback(BUTTON_J, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);
-    gpio_set_irq_enabled_with_callback(BUTTON_A, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);
-    gpio_set_irq_enabled_with_callback(BUTTON_B, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);
+    button_enable_irq(BUTTON_J); // IRQ do botão J (debounce por alarme)
+    button_enable_irq(BUTTON_A); // IRQ do botão A
+    button_enable_irq(BUTTON_B); // IRQ do botão B
+    configure_sensor();          // ADC e filtros de picos (com SENSOR_ENABLED)
+    boot_stage_end(BOOT_STAGE_INPUTS);
 
-    init_system_config(); // Inicializa a configuração do sistema
-
-    ssd1306_t ssd; // Estrutura que representa o display OLED SSD1306
-
-    configure_display(&ssd); // Configuração do display
+    boot_stage_begin(BOOT_STAGE_OUTPUTS);
     configure_leds();        // Configura os LEDs
     configure_buzzer();      // Configura o buzzer
     configure_leds_matrix(); // Configura a matriz de LEDs
 
-    // Limpa o display. O display inicia com todos os pixels apagados.
-    ssd1306_fill(&ssd, false);
+    // Alarmes ativos já com o estado restaurado, antes de display e rede
+    state_snapshot view;
+    read_state(&view);
+    refresh_outputs(&view);
+    buzzer_alert_poll(snapshot_selected(&view)->buzzer_on);
+    boot_stage_end(BOOT_STAGE_OUTPUTS);
 
-    ssd1306_draw_string(&ssd, "Inicializando", 5, 5);
-    ssd1306_send_data(&ssd);
+    // Display no núcleo 1, em paralelo com o cyw43_arch_init do núcleo 0
+    multicore_launch_core1(display_boot);
 
-    // Inicializa a arquitetura do cyw43
-    while (cyw43_arch_init())
-    {
-        ssd1306_fill(&ssd, false);
-        ssd1306_draw_string(&ssd, "Falha", 5, 5);
-        ssd1306_send_data(&ssd);
+    // O Wi-Fi sobe em segundo plano: monitoramento e alarmes não esperam pela rede
+    boot_stage_begin(BOOT_STAGE_WIFI_STACK);
+    configure_wifi();
 
-        sleep_ms(100);
-        return -1;
-    }
+    printf("Estado das regioes: %s\n", restored ? "restaurado da flash" : "padrao");
 
-    // GPIO do CI CYW43 em nível baixo
-    cyw43_arch_gpio_put(LED_PIN, 0);
+    // Uso de memória após a inicialização (também disponível no comando 'M' do console)
+    memory_report();
 
-    // Ativa o Wi-Fi no modo Station, de modo a que possam ser feitas ligações a outros pontos de acesso Wi-Fi.
-    cyw43_arch_enable_sta_mode();
+    // Dorme entre prazos; botões, rede e console acordam o laço (ver Idle.h)
+    configure_idle();
 
-    // Conectar à rede WiFI - fazer um loop até que esteja conectado
+    output_state shown = capture_output_state(&view);
 
-    ssd1306_fill(&ssd, false);
-    ssd1306_draw_string(&ssd, "Conectando...", 5, 5);
-    ssd1306_send_data(&ssd);
+    // Watchdog a partir daqui: cada tarefa do laço tem um prazo (post-mortem do último reset no console)
+    configure_supervisor();
 
-    while (cyw43_arch_wifi_connect_timeout_ms(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK, 20000))
+    while (true)
     {
-        ssd1306_fill(&ssd, false);
-        ssd1306_draw_string(&ssd, "Falha", 5, 5);
-        ssd1306_send_data(&ssd);
+        uint32_t iteration_start = time_us_32();
 
-        sleep_ms(100);
-        return -1;
-    }
+        TRACE_BEGIN(TRACE_LOOP);
 
-    // Configura o servidor TCP - cria novos PCBs TCP. É o primeiro passo para estabelecer uma conexão TCP.
-    struct tcp_pcb *server = tcp_new();
-    if (!server)
-    {
-        ssd1306_fill(&ssd, false);
-        ssd1306_draw_string(&ssd, "Falha no server", 5, 5);
-        ssd1306_send_data(&ssd);
-        return -1;
-    }
+        supervisor_enter(SUPERVISOR_TASK_WIFI);
+        handle_wifi_event(wifi_poll()); // Inicialização, associação e quedas do Wi-Fi
 
-    // vincula um PCB (Protocol Control Block) TCP a um endereço IP e porta específicos.
-    if (tcp_bind(server, IP_ADDR_ANY, 80) != ERR_OK)
-    {
-        ssd1306_fill(&ssd, false);
-        ssd1306_draw_string(&ssd, "Falha porta 80", 5, 5);
-        ssd1306_send_data(&ssd);
-        return -1;
-    }
+        supervisor_enter(SUPERVISOR_TASK_CONSOLE);
+        console_poll();   // Comandos recebidos pelo console USB
+        stream_poll();    // Quadros de amostras do stream USB (com o stream ligado)
 
-    // Coloca um PCB (Protocol Control Block) TCP em modo de escuta, permitindo que ele aceite conexões de entrada.
-    server = tcp_listen(server);
+        // Bordas dos botões registradas pela IRQ e amostras dos sensores; o lock
+        // do lwIP mantém os callbacks HTTP/telemetria fora enquanto os níveis mudam
+        bool network = wifi_stack_ready();
+        button_event event;
 
-    // Define uma função de callback para aceitar conexões TCP de entrada. É um passo importante na configuração de servidores TCP.
-    tcp_accept(server, tcp_server_accept);
+        supervisor_enter(SUPERVISOR_TASK_INPUTS);
+        if (network)
+            cyw43_arch_lwip_begin();
+        while (button_pop(&event))
+            handle_button_event(&event);
+        sensor_poll();
+        if (network)
+            cyw43_arch_lwip_end();
 
-    region_A.led_color = GREEN;
-    region_A.buzzer_on = false;
-    region_A.current_level = INITIAL_LEVEL_A;
-    strcpy(region_A.led_status_label, "🟢 LED-Normal | Ligado");
-    strcpy(region_A.buzzer_status_label, "🔊 Buzzer | Desligado");
+        supervisor_enter(SUPERVISOR_TASK_NETWORK);
+        telemetry_poll(); // Envia o relatório periódico de telemetria
+        mqtt_poll();      // Amostras, alertas e conexão com o broker MQTT
+        gateway_poll();   // Rodadas de consulta aos pares (modo gateway)
+        webhook_poll();   // Transições de alerta e entregas dos webhooks
 
-    region_B.led_color = GREEN;
-    region_B.buzzer_on = false;
-    region_B.current_level = INITIAL_LEVEL_B;
-    strcpy(region_B.led_status_label, "🟢 LED-Normal | Ligado");
-    strcpy(region_B.buzzer_status_label, "🔊 Buzzer | Desligado");
+        // Lotes de comandos são aplicados nos callbacks do lwIP, que podem
+        // interromper o laço: as saídas usam o último lote publicado inteiro
+        supervisor_enter(SUPERVISOR_TASK_OUTPUTS);
+        read_state(&view);
 
-    while (true)
-    {
-        cyw43_arch_poll(); // Necessário para manter o Wi-Fi ativo
-        sleep_ms(100);     // Reduz o uso da CPU
+        // Alerta sonoro da região selecionada, sem bloquear o laço
+        absolute_time_t deadline = buzzer_alert_poll(snapshot_selected(&view)->buzzer_on);
 
-        if (is_region_A)
-        {
-            set_led_color(region_A.led_color); // Define a cor do LED
-            update_matrix_from_level(region_A.current_level, ALERT_THRESHOLD_A);
+        // Saídas só são atualizadas quando o estado que elas mostram muda
+        output_state current = capture_output_state(&view);
 
-            if (region_A.buzzer_on)
-                beep_alert(); // Liga o buzzer
-            else
-                set_buzzer_level(BUZZER_A, 0); // Desliga o buzzer
-        }
-        else
+        if (memcmp(&current, &shown, sizeof(current)) != 0)
         {
-            set_led_color(region_B.led_color); // Define a cor do LED
-            update_matrix_from_level(region_B.current_level, ALERT_THRESHOLD_B);
-
-            if (region_B.buzzer_on)
-                beep_alert(); // Liga o buzzer
-            else
-                set_buzzer_level(BUZZER_A, 0); // Desliga o buzzer
+            refresh_outputs(&view);
+            shown = current;
         }
 
-        // Define a string com base na variável
-        snprintf(region, sizeof(region), "Regiao: %s", is_region_A ? "A" : "B");
+        // A flash só é gravada com o núcleo 1 fora dela (ver display_boot)
+        supervisor_enter(SUPERVISOR_TASK_CONFIG);
+        if (display_ready)
+        {
+            if (network)
+                cyw43_arch_lwip_begin();
+            config_poll();
+            if (network)
+                cyw43_arch_lwip_end();
+        }
 
-        // Exibe no display
-        ssd1306_fill(&ssd, false);
-        ssd1306_draw_string(&ssd, ipaddr_ntoa(&netif_default->ip_addr), 5, 5);
-        ssd1306_draw_string(&ssd, "Porta 80", 5, 18);
-        ssd1306_draw_string(&ssd, region, 5, 50);
-        ssd1306_send_data(&ssd);
+        uint32_t iteration_us = time_us_32() - iteration_start;
+        metrics_observe(METRIC_LOOP_ITERATION_TIME, iteration_us);
+        supervisor_loop_time(iteration_us);
+
+        TRACE_END(TRACE_LOOP);
+
+        deadline = earliest_deadline(deadline, wifi_next_deadline());
+        deadline = earliest_deadline(deadline, telemetry_next_deadline());
+        deadline = earliest_deadline(deadline, mqtt_next_deadline());
+        deadline = earliest_deadline(deadline, gateway_next_deadline());
+        deadline = earliest_deadline(deadline, sensor_next_deadline());
+        deadline = earliest_deadline(deadline, webhook_next_deadline());
+        deadline = earliest_deadline(deadline, stream_next_deadline());
+        if (display_ready)
+            deadline = earliest_deadline(deadline, config_next_deadline());
+        supervisor_enter(SUPERVISOR_TASK_IDLE);
+        idle_until(deadline);
     }
 
     // Desligar a arquitetura CYW43.
-    cyw43_arch_deinit();
+    if (wifi_stack_ready())
+        cyw43_arch_deinit();
     return 0;
 }
 
+// Conexões HTTP com estado alocado
+static uint http_connections_in_use()
+{
+    uint count = 0;
+
+    for (int i = 0; i < MEMP_NUM_TCP_PCB; i++)
+        count += http_connections[i].in_use ? 1 : 0;
+
+    return count;
+}
+
+// Informa ao modo ocioso quantos clientes HTTP estão conectados (power-save do CYW43)
+static void http_update_clients()
+{
+    idle_set_clients(http_connections_in_use());
+}
+
 // Função de callback ao aceitar conexões TCP
 static err_t tcp_server_accept(void *arg, struct tcp_pcb *newpcb, err_t err)
 {
+    http_connection *conn = NULL;
+    uint from_client = 0;
+
+    TRACE_BEGIN(TRACE_TCP_ACCEPT);
+
+    for (int i = 0; i < MEMP_NUM_TCP_PCB; i++)
+    {
+        http_connection *slot = &http_connections[i];
+
+        if (!slot->in_use)
+        {
+            if (!conn)
+                conn = slot;
+        }
+        else if (ip_addr_cmp(&slot->pcb->remote_ip, &newpcb->remote_ip))
+        {
+            from_client++;
+        }
+    }
+
+    bool admitted = admission_accept(conn != NULL, from_client);
+
+    // Sem estado livre: 503 imediato, sem esperar o request
+    if (!conn)
+    {
+        err_t result = http_send_busy(newpcb, NULL, 1);
+        TRACE_END(TRACE_TCP_ACCEPT);
+        return result;
+    }
+
+    memset(conn, 0, sizeof(*conn));
+    conn->in_use = true;
+    conn->pcb = newpcb;
+    conn->busy_retry = admitted ? 0 : 1; // Acima do limite do cliente: o 503 sai quando o request chegar
+    http_update_clients();
+
+    // Até mandar o request a conexão é a primeira que o lwIP derruba quando faltam PCBs
+    tcp_setprio(newpcb, TCP_PRIO_MIN);
+
+    tcp_arg(newpcb, conn);
     tcp_recv(newpcb, tcp_server_recv);
+    tcp_sent(newpcb, tcp_server_sent);
+    tcp_err(newpcb, tcp_server_err);
+
+    TRACE_END(TRACE_TCP_ACCEPT);
     return ERR_OK;
 }
 
-// Tratamento do request do usuário
-void user_request(char **request_ptr)
+// Aplica um comando com as funções de processamento (que registram o evento)
+static void apply_command(const actuator_command *cmd)
+{
+    if (cmd->actuator->color)
+        process_led_request(cmd->region, *cmd->actuator->color, cmd->actuator->id, cmd->turn_on);
+    else
+        process_buzzer_request(cmd->region, cmd->turn_on);
+}
+
+// true se o comando altera o estado da região (LED, status exibido ou buzzer)
+static bool command_changes_state(const actuator_command *cmd)
 {
-    char *request = *request_ptr;
+    if (!cmd->actuator->color)
+        return cmd->region->buzzer_on != cmd->turn_on;
+
+    led_color target = cmd->turn_on ? *cmd->actuator->color : DARK;
+
+    return memcmp(&target, &cmd->region->led_color, sizeof(target)) != 0 ||
+           cmd->region->led_status != cmd->actuator->id || cmd->region->led_status_on != cmd->turn_on;
+}
 
+// Tratamento do request do usuário
+void user_request(const char *request)
+{
     bool turn_on = strstr(request, "acao=ligar") != NULL;
     bool regiao_A = strstr(request, "regiao=A") != NULL;
     bool regiao_B = strstr(request, "regiao=B") != NULL;
 
     region_state *target_region = regiao_A ? &region_A : (regiao_B ? &region_B : NULL);
 
-    if (target_region != NULL)
+    if (target_region == NULL)
+        return;
+
+    for (size_t i = 0; i < ACTUATOR_COUNT; i++)
     {
-        if (strstr(request, "periferico=ledO"))
-        {
-            process_led_request(target_region, ORANGE, "🟠 LED-Atenção | Ligado", "🟠 LED-Atenção | Desligado", turn_on);
-        }
-        else if (strstr(request, "periferico=ledR"))
+        char field[24];
+
+        snprintf(field, sizeof(field), "periferico=%s", actuators[i].name);
+        if (strstr(request, field))
         {
-            process_led_request(target_region, RED, "🔴 LED-Alerta | Ligado", "🔴 LED-Alerta | Desligado", turn_on);
+            actuator_command cmd = {target_region, &actuators[i], turn_on};
+            apply_command(&cmd);
+            publish_state();
+            break;
         }
-        else if (strstr(request, "periferico=ledG"))
+    }
+}
+
+// Interpreta "regiao:periferico:acao" (ex.: "A:ledR:ligar"); acao aceita ligar/desligar ou on/off
+static bool parse_command(char *text, actuator_command *cmd)
+{
+    char *save = NULL;
+    char *region = strtok_r(text, ":", &save);
+    char *name = strtok_r(NULL, ":", &save);
+    char *action = strtok_r(NULL, ":", &save);
+
+    if (!region || !name || !action || strtok_r(NULL, ":", &save))
+        return false;
+
+    if (strcmp(region, "A") == 0)
+        cmd->region = &region_A;
+    else if (strcmp(region, "B") == 0)
+        cmd->region = &region_B;
+    else
+        return false;
+
+    if (strcmp(action, "ligar") == 0 || strcmp(action, "on") == 0)
+        cmd->turn_on = true;
+    else if (strcmp(action, "desligar") == 0 || strcmp(action, "off") == 0)
+        cmd->turn_on = false;
+    else
+        return false;
+
+    cmd->actuator = NULL;
+    for (size_t i = 0; i < ACTUATOR_COUNT; i++)
+    {
+        if (strcmp(name, actuators[i].name) == 0)
+            cmd->actuator = &actuators[i];
+    }
+
+    return cmd->actuator != NULL;
+}
+
+// POST /api/actuators: valida o lote inteiro e só então aplica, com um único
+// incremento de state_version; escreve em status o resultado em texto curto.
+// Retorna false (nada aplicado) se algum comando for inválido.
+static bool apply_actuator_batch(char *body, char *status, size_t status_size)
+{
+    static actuator_command batch[ACTUATOR_BATCH_MAX];
+    uint count = 0;
+    char *save = NULL;
+
+    for (char *item = strtok_r(body, ",;\r\n ", &save); item; item = strtok_r(NULL, ",;\r\n ", &save))
+    {
+        if (count == ACTUATOR_BATCH_MAX)
         {
-            process_led_request(target_region, GREEN, "🟢 LED-Normal | Ligado", "🟢 LED-Normal | Desligado", turn_on);
+            snprintf(status, status_size, "erro: mais de %d comandos\n", ACTUATOR_BATCH_MAX);
+            return false;
         }
-        else if (strstr(request, "periferico=buzzer"))
+
+        if (!parse_command(item, &batch[count]))
         {
-            process_buzzer_request(target_region, turn_on);
+            snprintf(status, status_size, "erro: comando %u invalido\n", count + 1);
+            return false;
         }
+
+        count++;
     }
+
+    if (count == 0)
+    {
+        snprintf(status, status_size, "erro: lote vazio\n");
+        return false;
+    }
+
+    // Os callbacks do lwIP não são interrompidos pelo laço principal: o lote é aplicado de uma vez
+    uint changed = 0;
+
+    for (uint i = 0; i < count; i++)
+    {
+        if (!command_changes_state(&batch[i]))
+            continue;
+
+        apply_command(&batch[i]);
+        changed++;
+    }
+
+    if (changed > 0)
+    {
+        publish_state();
+        idle_wake();
+    }
+
+    snprintf(status, status_size, "ok comandos=%u alterados=%u versao=%lu\n",
+             count, changed, (unsigned long)state_version);
+    return true;
 }
 
-void process_led_request(region_state *region, led_color color_on, const char *label_on, const char *label_off, bool turn_on)
+void process_led_request(region_state *region, led_color color_on, peripheral led, bool turn_on)
 {
-    if (turn_on)
+    region->led_color = turn_on ? color_on : DARK;
+    set_led_color(region->led_color);
+    region->led_status = led;
+    region->led_status_on = turn_on;
+    add_event(EVENT_LED, region, led, turn_on);
+}
+
+void process_buzzer_request(region_state *region, bool turn_on)
+{
+    region->buzzer_on = turn_on;
+    add_event(EVENT_BUZZER, region, PERIPHERAL_BUZZER, turn_on);
+}
+
+// Libera o estado da conexão e a entrada do cache que ela referencia
+static void http_release(http_connection *conn)
+{
+    cache_release(conn->cached);
+    conn->cached = NULL;
+    conn->in_use = false;
+}
+
+// Libera o estado da conexão e fecha o PCB; ERR_ABRT se foi preciso abortar
+static err_t http_close(struct tcp_pcb *tpcb, http_connection *conn)
+{
+    if (conn)
+    {
+        http_release(conn);
+        http_update_clients();
+    }
+
+    tcp_arg(tpcb, NULL);
+    tcp_recv(tpcb, NULL);
+    tcp_sent(tpcb, NULL);
+    tcp_err(tpcb, NULL);
+
+    if (tcp_close(tpcb) != ERR_OK)
     {
-        region->led_color = color_on;
-        set_led_color(color_on);
-        strcpy(region->led_status_label, label_on);
-        add_event(label_on);
+        tcp_abort(tpcb);
+        return ERR_ABRT;
     }
+
+    return ERR_OK;
+}
+
+// Responde com uma linha de status em texto e fecha a conexão
+static err_t http_send_status(struct tcp_pcb *tpcb, http_connection *conn, const char *status, const char *body)
+{
+    static char response[256];
+    int len = snprintf(response, sizeof(response),
+                       "HTTP/1.1 %s\r\n"
+                       "Content-Type: text/plain; charset=utf-8\r\n"
+                       "Content-Length: %u\r\n"
+                       "Connection: close\r\n"
+                       "\r\n"
+                       "%s",
+                       status, (unsigned)strlen(body), body);
+
+    if (tcp_write(tpcb, response, len, TCP_WRITE_FLAG_COPY) != ERR_OK)
+        metrics_inc(METRIC_TCP_WRITE_FAILURES);
     else
+        metrics_add(METRIC_HTTP_BYTES_SENT, len);
+
+    return http_close(tpcb, conn);
+}
+
+// Recusa o request com um 503 curto e fecha a conexão
+static err_t http_send_busy(struct tcp_pcb *tpcb, http_connection *conn, uint32_t retry_s)
+{
+    static char response[128];
+    int len = snprintf(response, sizeof(response),
+                       "HTTP/1.1 503 Service Unavailable\r\n"
+                       "Retry-After: %lu\r\n"
+                       "Content-Length: 0\r\n"
+                       "Connection: close\r\n"
+                       "\r\n",
+                       (unsigned long)retry_s);
+
+    if (tcp_write(tpcb, response, len, TCP_WRITE_FLAG_COPY) != ERR_OK)
+        metrics_inc(METRIC_TCP_WRITE_FAILURES);
+    else
+        metrics_add(METRIC_HTTP_BYTES_SENT, len);
+
+    return http_close(tpcb, conn);
+}
+
+// Valor de Content-Length nos cabeçalhos (0 se ausente)
+static uint32_t http_content_length(const char *request, const char *headers_end)
+{
+    static const char name[] = "\r\ncontent-length:";
+
+    for (const char *line = request; line && line < headers_end; line = strstr(line + 2, "\r\n"))
     {
-        region->led_color = DARK;
-        set_led_color(DARK);
-        strcpy(region->led_status_label, label_off);
-        add_event(label_off);
+        if (strncasecmp(line, name, sizeof(name) - 1) == 0)
+            return (uint32_t)strtoul(line + sizeof(name) - 1, NULL, 10);
     }
+
+    return 0;
 }
 
-void process_buzzer_request(region_state *region, bool turn_on)
+// Conexão perdida (RST ou falta de memória): o PCB já foi liberado pelo lwIP
+static void tcp_server_err(void *arg, err_t err)
 {
-    region->buzzer_on = turn_on;
-    const char *label = turn_on ? "🔊 Buzzer | Ligado" : "🔊 Buzzer | Desligado";
-    strcpy(region->buzzer_status_label, label);
-    add_event(label);
+    http_connection *conn = (http_connection *)arg;
+
+    if (conn)
+    {
+        // Derrubada pelo lwIP (tcp_kill_prio) antes de mandar o request
+        if (err == ERR_ABRT && conn->response == HTTP_IDLE && conn->request_len == 0)
+            admission_evicted();
+
+        http_release(conn);
+        http_update_clients();
+    }
+}
+
+// Continua a resposta em andamento; fecha a conexão quando ela termina
+static err_t http_continue(struct tcp_pcb *tpcb, http_connection *conn)
+{
+    bool done;
+
+    if (conn->response == HTTP_SENDING_CHUNKS)
+    {
+        done = send_chunks(tpcb, conn);
+    }
+    else if (conn->response == HTTP_SENDING_CACHED)
+    {
+        done = send_cached(tpcb, conn);
+    }
+    else
+    {
+        uint32_t bytes_sent = 0;
+        uint32_t render_start = time_us_32();
+
+        done = template_stream_send(&conn->stream, tpcb, &bytes_sent);
+
+        conn->render_us += time_us_32() - render_start;
+        metrics_add(METRIC_HTTP_BYTES_SENT, bytes_sent);
+
+        if (done)
+            metrics_observe(METRIC_HTTP_RENDER_TIME, conn->render_us);
+    }
+
+    return done ? http_close(tpcb, conn) : ERR_OK;
+}
+
+// Continuação do envio quando o cliente confirma dados
+static err_t tcp_server_sent(void *arg, struct tcp_pcb *tpcb, u16_t len)
+{
+    http_connection *conn = (http_connection *)arg;
+    err_t result = ERR_OK;
+
+    TRACE_BEGIN(TRACE_TCP_SENT);
+
+    if (conn)
+        conn->unacked -= len < conn->unacked ? len : conn->unacked;
+
+    if (conn && conn->response != HTTP_IDLE)
+        result = http_continue(tpcb, conn);
+
+    TRACE_END(TRACE_TCP_SENT);
+    return result;
 }
 
 static err_t tcp_server_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err)
 {
+    http_connection *conn = (http_connection *)arg;
+    static const char page_header[] =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/html\r\n"
+        "Connection: close\r\n"
+        "\r\n";
+    static const char metrics_header[] =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+        "Connection: close\r\n"
+        "\r\n";
+    static const char json_header[] =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: application/json\r\n"
+        "Connection: close\r\n"
+        "\r\n";
+
+    TRACE_BEGIN(TRACE_TCP_RECV);
+
     if (!p)
     {
-        tcp_close(tpcb);
-        tcp_recv(tpcb, NULL);
+        // FIN no meio do corpo em cache: os segmentos apontam para a entrada e o
+        // TCP ainda os envia e retransmite. A conexão segue até a confirmação de
+        // tudo (tcp_sent) ou até cair (tcp_server_err), que soltam a entrada
+        if (conn && conn->response == HTTP_SENDING_CACHED)
+        {
+            TRACE_END(TRACE_TCP_RECV);
+            return ERR_OK;
+        }
+
+        err_t result = http_close(tpcb, conn);
+        TRACE_END(TRACE_TCP_RECV);
+        return result;
+    }
+
+    tcp_recved(tpcb, p->tot_len);
+
+    // Com uma resposta em andamento, novos dados (pipelining) são descartados
+    if (!conn || conn->response != HTTP_IDLE)
+    {
+        pbuf_free(p);
+        TRACE_END(TRACE_TCP_RECV);
         return ERR_OK;
     }
 
-    // Alocação do request na memória dinâmica
-    char *request = (char *)malloc(p->len + 1);
-    memcpy(request, p->payload, p->len);
-    request[p->len] = '\0';
+    // Conexão acima do limite do cliente: recusada assim que o request começa a chegar
+    if (conn->busy_retry)
+    {
+        pbuf_free(p);
+        err_t result = http_send_busy(tpcb, conn, conn->busy_retry);
+        TRACE_END(TRACE_TCP_RECV);
+        return result;
+    }
 
-    // Tratamento de request - Controle dos LEDs
-    user_request(&request);
+    // Acumula o request: cabeçalhos e corpo podem chegar em segmentos separados
+    conn->request_len += pbuf_copy_partial(p, conn->request + conn->request_len, HTTP_REQUEST_MAX - conn->request_len, 0);
+    conn->request[conn->request_len] = '\0';
+    pbuf_free(p);
 
-    char class_region_A[16];
-    char class_region_B[16];
+    bool full = conn->request_len == HTTP_REQUEST_MAX;
+    char *headers_end = strstr(conn->request, "\r\n\r\n");
 
-    // Região A
-    if (region_A.current_level >= ALERT_THRESHOLD_A)
+    // Requests maiores que o buffer são tratados com a parte inicial
+    if (!headers_end && !full)
     {
-        strcpy(class_region_A, "Alerta");
+        TRACE_END(TRACE_TCP_RECV);
+        return ERR_OK;
     }
-    else if (region_A.current_level >= ATTENTION_THRESHOLD_A)
+
+    const char *request = conn->request;
+    bool is_post = strncmp(request, "POST ", 5) == 0;
+    uint32_t content_length = is_post && headers_end ? http_content_length(request, headers_end) : 0;
+    char *body = headers_end ? headers_end + 4 : conn->request + conn->request_len;
+    uint32_t body_len = conn->request + conn->request_len - body;
+
+    if (body_len < content_length && !full)
     {
-        strcpy(class_region_A, "Atenção");
+        TRACE_END(TRACE_TCP_RECV);
+        return ERR_OK;
     }
-    else
+
+    metrics_inc(METRIC_HTTP_REQUESTS);
+
+    // Admissão: a página cede lugar a comandos e APIs e só renderiza dentro do balde
+    http_route route = admission_route(request);
+    bool render = route == HTTP_ROUTE_PAGE && !cache_fresh(render_dashboard, dashboard_version());
+    uint32_t retry_s = admission_request(route, render);
+
+    if (retry_s)
+    {
+        err_t result = http_send_busy(tpcb, conn, retry_s);
+        TRACE_END(TRACE_TCP_RECV);
+        return result;
+    }
+
+    // Admitida: fora do alcance do tcp_kill_prio (que só derruba abaixo da prioridade do listener)
+    tcp_setprio(tpcb, route == HTTP_ROUTE_PAGE ? TCP_PRIO_NORMAL : TCP_PRIO_MAX);
+
+    // Lote de comandos: resposta curta, sem renderizar o dashboard
+    if (strncmp(request, "POST /api/actuators", 19) == 0)
     {
-        strcpy(class_region_A, "Normal");
+        static char status[96];
+        uint32_t parse_start = time_us_32();
+        err_t result;
+
+        if (body_len < content_length)
+        {
+            result = http_send_status(tpcb, conn, "413 Payload Too Large", "erro: lote maior que o buffer\n");
+        }
+        else
+        {
+            body[content_length] = '\0';
+            bool ok = apply_actuator_batch(body, status, sizeof(status));
+            metrics_observe(METRIC_HTTP_PARSE_TIME, time_us_32() - parse_start);
+            result = http_send_status(tpcb, conn, ok ? "200 OK" : "400 Bad Request", status);
+        }
+
+        TRACE_END(TRACE_TCP_RECV);
+        return result;
     }
 
-    // Região B
-    if (region_B.current_level >= ALERT_THRESHOLD_B)
+    const char *header;
+
+    // Página de métricas: texto simples, enviado em partes
+    if (strncmp(request, "GET /metrics", 12) == 0)
     {
-        strcpy(class_region_B, "Alerta");
+        conn->response = HTTP_SENDING_CHUNKS;
+        conn->body = &metrics_body;
+        conn->cursor = 0;
+        header = metrics_header;
     }
-    else if (region_B.current_level >= ATTENTION_THRESHOLD_B)
+    // Visão da frota (modo gateway) em JSON
+    else if (strncmp(request, "GET /api/fleet", 14) == 0)
     {
-        strcpy(class_region_B, "Atenção");
+        conn->response = HTTP_SENDING_CHUNKS;
+        conn->body = &fleet_body;
+        conn->cursor = 0;
+        header = json_header;
     }
-    else
+    // Post-mortem do último reset pelo watchdog em JSON
+    else if (strncmp(request, "GET /api/postmortem", 19) == 0)
     {
-        strcpy(class_region_B, "Normal");
+        conn->response = HTTP_SENDING_CHUNKS;
+        conn->body = &postmortem_body;
+        conn->cursor = 0;
+        header = json_header;
     }
+    else
+    {
+        uint32_t parse_start = time_us_32();
 
-    // Função para converter arrays uint8_t para string JSON, para JS usar nos gráficos:
-    char readings_A_str[300] = {0};
-    char readings_B_str[300] = {0};
+        // Tratamento de request - Controle dos LEDs
+        user_request(request);
+        idle_wake();
 
-    // Converta antes do snprintf principal
-    convert_readings_to_JSON(readings_A, readings_A_str, sizeof(readings_A_str));
-    convert_readings_to_JSON(readings_B, readings_B_str, sizeof(readings_B_str));
+        metrics_observe(METRIC_HTTP_PARSE_TIME, time_us_32() - parse_start);
 
-    char events_html[1024] = {'\0'};
+        // Estado inalterado desde a última renderização: os bytes saem direto do cache
+        conn->cached = cache_acquire(render_dashboard, dashboard_version());
 
-    if (total_events > 0)
-    {
-        for (int i = total_events - 1; i >= 0; i--)
+        if (conn->cached)
+        {
+            conn->response = HTTP_SENDING_CACHED;
+            conn->cached_sent = 0;
+        }
+        else
         {
-            char line[128];
-            snprintf(line, sizeof(line), "<tr><td>%s</td><tr>", event_log[i]);
-            strncat(events_html, line, sizeof(events_html) - strlen(events_html) - 1);
+            // Sem entrada livre: valores, estado e frota são capturados agora, na
+            // conexão, e o template é enviado conforme o buffer TCP libera espaço
+            fill_dashboard_values(&conn->values, &conn->snapshot);
+            template_stream_init(&conn->stream, &dashboard_template, &conn->values, &conn->snapshot);
+            conn->response = HTTP_SENDING_PAGE;
+            conn->render_us = 0;
         }
+        header = page_header;
     }
 
-    char html[7144];
-
-    snprintf(html, sizeof(html),
-             "HTTP/1.1 200 OK\r\n"
-             "Content-Type: text/html\r\n"
-             "Connection: close\r\n"
-             "\r\n"
-             "<!DOCTYPE html>"
-             "<html>"
-             "<head>"
-             "<meta charset='UTF-8'>"
-             "<meta name='viewport' content='width=device-width, initial-scale=1.0'>"
-             "<title>FloodSense</title>"
-             "<script src='https://cdn.jsdelivr.net/npm/chart.js'></script>"
-             "<style>"
-             "body{font-family:sans-serif;background:#f0f0f0;padding:20px;text-align:center;}"
-             ".b{display:block;margin:10px auto;padding:20px;border-radius:10px;box-shadow:0 0 5px #ccc;background:#fff;font-weight:bold;width:fit-content;max-width:100%;}"
-             ".bk{display:inline-block;vertical-align:top;margin:10px;}"
-             ".value{color:#1976d2;font-size:20px;}"
-             ".status{padding:4px 8px;border-radius:4px;display:inline-block;}"
-             ".Alerta{background:#e53935;color:#fff;}"
-             ".Normal{background:#43a047;color:#fff;}"
-             ".Atenção{background:#fb8c00;color:#fff;}"
-             ".Blue{background:#1976d2;color:#fff;}"
-             "button,input,select{padding:6px;margin:4px;border-radius:5px;border:1px solid #838282;font-size:14px;}"
-             "table{margin:0 auto;border-collapse:collapse;}"
-             "th,td{padding:4px 8px;border:1px solid #ccc;}"
-             ".tab-btn{margin:10px;padding:10px;color:#fff;border:none;border-radius:5px;cursor:pointer;}"
-             ".hidden{display:none;}"
-             "</style>"
-             "</head>"
-             "<body>"
-             "<h1>FloodSense Monitor</h1>"
-
-             "<div>"
-             "<button class='tab-btn Blue' onclick=\"showTab('monitor')\">👁️ Monitoramento</button>"
-             "<button class='tab-btn Blue' onclick=\"showTab('controle')\">⚙️ Controle Manual</button>"
-             "</div>"
-
-             "<div id='monitor'>"
-
-             "<div style='display: flex; flex-wrap: wrap; justify-content: center; gap:20px;'>"
-
-             "<div>"
-             "<div class='b bk'>"
-             "<h2>Região A</h2>"
-             "<p class='value'>Nível: %dm</p>"
-             "<p class='status %s'>%s</p>"
-             "<table style='text-align:left;'>"
-             "<tr><td>%s</td><tr>"
-             "<tr><td>%s</td><tr>"
-             "</table>"
-             "</div>"
-
-             "<div class='b bk'>"
-             "<h2>Região B</h2>"
-             "<p class='value'>Nível: %dm</p>"
-             "<p class='status %s'>%s</p>"
-             "<table style='text-align:left;'>"
-             "<tr><td>%s</td><tr>"
-             "<tr><td>%s</td><tr>"
-             "</table>"
-             "</div>"
-
-             "<div class='b bk'>"
-             "<h2>Limiares</h2>"
-             "<table>"
-             "<tr><th>Região</th><th>Atenção (m)</th><th>Alerta (m)</th></tr>"
-             "<tr><td>A</td><td>%d</td><td>%d</td></tr>"
-             "<tr><td>B</td><td>%d</td><td>%d</td></tr>"
-             "</table>"
-             "</div>"
-
-             "<div class='b'>"
-             "<h2>Histórico de Níveis</h2>"
-             "<div class='b bk'><canvas id='nivelChartA' width='300' height='200'></canvas></div>"
-             "<div class='b bk'><canvas id='nivelChartB' width='300' height='200'></canvas></div>"
-             "</div>"
-             "</div>"
-             "<div>"
-             "<div class='b bk'>"
-             "<h2>Últimos Eventos</h2>"
-             "<table style='text-align:left;'>%s</table>"
-             "</div>"
-             "</div>"
-             "</div>"
-             "</div>"
-
-             "<div id='controle' class='hidden'>"
-             "<div class='b'>"
-             "<h2>Controle Manual</h2>"
-             "<form method='GET' action='/'>"
-
-             "<label for='regiao'>Região:</label><br>"
-             "<select name='regiao'>"
-             "<option value=''>---</option>"
-             "<option value='A'>Região A</option>"
-             "<option value='B'>Região B</option>"
-             "</select><br><br>"
-
-             "<label for='periferico'>Periférico:</label><br>"
-             "<select name='periferico'>"
-             "<option value=''>---</option>"
-             "<option value='buzzer'>Buzzer</option>"
-             "<option value='ledG'>LED - Normal</option>"
-             "<option value='ledO'>LED - Atenção</option>"
-             "<option value='ledR'>LED - Alerta</option>"
-             "</select><br><br>"
-
-             "<button class='tab-btn Normal' type='submit' name='acao' value='ligar'>Ligar</button>"
-             "<button class='tab-btn Alerta' type='submit' name='acao' value='desligar'>Desligar</button>"
-             "</form>"
-             "</div>"
-             "</div>"
-
-             "<script>"
-             "function showTab(tabId){"
-             "document.getElementById('monitor').classList.add('hidden');"
-             "document.getElementById('controle').classList.add('hidden');"
-             "document.getElementById(tabId).classList.remove('hidden');"
-             "}"
-             "new Chart(document.getElementById('nivelChartA').getContext('2d'),{type:'line',data:{labels:['1','2','3','4','5','6','7','8','9','10'],datasets:[{label:'Região A (m)',data:%s,borderColor:'#1976d2',backgroundColor:'rgba(25,118,210,0.2)',fill:true,tension:0.3}]},options:{scales:{x:{type:'linear',position:'bottom',min:1,max:%d},y:{beginAtZero:true}}}});"
-             "new Chart(document.getElementById('nivelChartB').getContext('2d'),{type:'line',data:{labels:['1','2','3','4','5','6','7','8','9','10'],datasets:[{label:'Região B (m)',data:%s,borderColor:'#1976d2',backgroundColor:'rgba(25,118,210,0.2)',fill:true,tension:0.3}]},options:{scales:{x:{type:'linear',position:'bottom',min:1,max:%d},y:{beginAtZero:true}}}});"
-             "</script>"
-
-             "<script>(function(){setInterval(()=>{const controle=document.getElementById('controle');if(controle&&controle.classList.contains('hidden')){window.location.href='/';}},8000);})();</script>"
-             "</body>"
-             "</html>",
-
-             // Variáveis para mostrar níveis atuais e classes:
-             region_A.current_level, class_region_A, class_region_A,
-             region_A.led_status_label, region_A.buzzer_status_label,
-             
-             region_B.current_level, class_region_B, class_region_B,
-             region_B.led_status_label, region_B.buzzer_status_label,
-
-             // Limiares:
-             ATTENTION_THRESHOLD_A, ALERT_THRESHOLD_A,
-             ATTENTION_THRESHOLD_B, ALERT_THRESHOLD_B,
-
-             // Eventos:
-             events_html,
-
-             // dados dos arrays:
-             readings_A_str, MAX_READINGS,
-             readings_B_str, MAX_READINGS);
-
-    // Escreve dados para envio (mas não os envia imediatamente).
-    tcp_write(tpcb, html, strlen(html), TCP_WRITE_FLAG_COPY);
-
-    // Envia a mensagem
-    tcp_output(tpcb);
-
-    // libera memória alocada dinamicamente
-    free(request);
+    err_t result;
 
-    // libera um buffer de pacote (pbuf) que foi alocado anteriormente
-    pbuf_free(p);
+    if (tcp_write(tpcb, header, strlen(header), 0) != ERR_OK)
+    {
+        metrics_inc(METRIC_TCP_WRITE_FAILURES);
+        result = http_close(tpcb, conn);
+    }
+    else
+    {
+        metrics_add(METRIC_HTTP_BYTES_SENT, strlen(header));
+        conn->unacked += strlen(header);
+        result = http_continue(tpcb, conn);
+    }
 
-    return ERR_OK;
+    TRACE_END(TRACE_TCP_RECV);
+    return result;
 }
 
-// Move todos os elementos para a esquerda e adiciona novo valor no final
-void add_reading(uint8_t new_value, uint8_t readings[])
+// Envia um corpo gerado em blocos; retorna true quando todos foram entregues ao TCP
+static bool send_chunks(struct tcp_pcb *tpcb, http_connection *conn)
 {
-    for (int i = 0; i < MAX_READINGS - 1; i++)
+    static char chunk[METRICS_CHUNK_SIZE];
+    uint16_t units = conn->body->units();
+
+    while (conn->cursor < units)
     {
-        readings[i] = readings[i + 1];
+        uint16_t space = tcp_sndbuf(tpcb) < sizeof(chunk) ? tcp_sndbuf(tpcb) : sizeof(chunk);
+        uint16_t next = conn->cursor;
+        uint16_t len = conn->body->render(&next, chunk, space);
+
+        if (len == 0)
+        {
+            // Bloco maior que o chunk ou que o buffer TCP inteiro: é omitido para o envio não travar
+            if (space == sizeof(chunk) || tcp_sndbuf(tpcb) >= TCP_SND_BUF)
+            {
+                conn->cursor++;
+                continue;
+            }
+
+            // Sem espaço para o próximo bloco: continua em tcp_sent
+            break;
+        }
+
+        if (tcp_write(tpcb, chunk, len, TCP_WRITE_FLAG_COPY) != ERR_OK)
+        {
+            metrics_inc(METRIC_TCP_WRITE_FAILURES);
+            break;
+        }
+
+        metrics_add(METRIC_HTTP_BYTES_SENT, len);
+        conn->cursor = next;
     }
-    readings[MAX_READINGS - 1] = new_value;
+
+    tcp_output(tpcb);
+
+    return conn->cursor >= units;
 }
 
-// Converte os dados de leitura para JSON
-void convert_readings_to_JSON(uint8_t *readings, char *buffer, int size)
+// Envia o corpo em cache sem cópia; retorna true só quando o cliente confirmou
+// todos os bytes, pois até lá o TCP ainda pode retransmitir a partir da entrada
+static bool send_cached(struct tcp_pcb *tpcb, http_connection *conn)
 {
-    int len = 0;
-    len += snprintf(buffer + len, size - len, "[");
-    for (int i = 0; i < MAX_READINGS; i++)
+    const cache_entry *entry = conn->cached;
+
+    while (conn->cached_sent < entry->len)
     {
-        len += snprintf(buffer + len, size - len, "{\"x\":%d,\"y\":%d}%s", i + 1, readings[i], (i < MAX_READINGS - 1) ? "," : "");
-        if (len >= size)
+        uint16_t len = entry->len - conn->cached_sent;
+
+        if (len > tcp_sndbuf(tpcb))
+            len = tcp_sndbuf(tpcb);
+        if (len == 0)
+            break;
+
+        // Sem espaço na fila de segmentos: continua em tcp_sent
+        if (tcp_write(tpcb, entry->body + conn->cached_sent, len, 0) != ERR_OK)
+        {
+            metrics_inc(METRIC_TCP_WRITE_FAILURES);
             break;
+        }
+
+        metrics_add(METRIC_HTTP_BYTES_SENT, len);
+        conn->cached_sent += len;
+        conn->unacked += len;
     }
-    snprintf(buffer + len, size - len, "]");
+
+    tcp_output(tpcb);
+
+    return conn->cached_sent == entry->len && conn->unacked == 0;
+}
+
+// Os slots fn leem o dashboard_snapshot da renderização em w->context: a cópia
+// da conexão no envio em partes, ou a da renderização do cache, que termina
+// antes de qualquer outra começar. Valores e slots (inclusive a frota) saem
+// sempre da mesma captura.
+
+// Gráficos do histórico de cada região (SVG gerado no nó)
+static void write_chart_A(template_writer *w)
+{
+    const state_snapshot *state = &((const dashboard_snapshot *)w->context)->state;
+    chart_write_svg(w, state->readings[0], MAX_READINGS, &state->regions[0]);
+}
+
+static void write_chart_B(template_writer *w)
+{
+    const state_snapshot *state = &((const dashboard_snapshot *)w->context)->state;
+    chart_write_svg(w, state->readings[1], MAX_READINGS, &state->regions[1]);
 }
 
-void add_event(const char *new_event)
+// Escreve o histórico de eventos, do mais recente para o mais antigo
+static void write_events_html(template_writer *w)
 {
-    if (total_events < MAX_EVENTS)
+    const state_snapshot *state = &((const dashboard_snapshot *)w->context)->state;
+
+    for (int i = state->event_count - 1; i >= 0; i--)
     {
-        total_events++;
+        const event_record *event = &state->events[i];
+
+        template_put_str(w, "<tr><td>");
+        template_put_int(w, (int32_t)(event->time_ms / 1000));
+        template_put_str(w, " s</td><td>");
+        template_put_str(w, region_name(event->region));
+        template_put_str(w, "</td><td>");
+        template_put_str(w, peripheral_label(event->peripheral, event->on));
+        template_put_str(w, "</td></tr>");
     }
-    else
+}
+
+// Escreve a tabela da frota (modo gateway): uma linha por nó, uma coluna por região.
+// As tags de fechamento de td/tr são omitidas (opcionais no HTML) para a tabela
+// com GATEWAY_PEERS_MAX pares caber em um bloco do template.
+static void write_fleet_html(template_writer *w)
+{
+    const dashboard_snapshot *snapshot = w->context;
+    char id[8];
+
+    if (snapshot->fleet_count == 0)
+        return;
+
+    template_put_str(w, "<div class='b'><h2>Frota</h2><table>"
+                        "<tr><th>Nó</th><th>Endereço</th><th>A (m)</th><th>B (m)</th></tr>");
+
+    for (uint i = 0; i < snapshot->fleet_count; i++)
     {
-        for (int i = 1; i < MAX_EVENTS; i++)
+        const fleet_row *node = &snapshot->fleet[i];
+
+        snprintf(id, sizeof(id), "%04x", node->node_id);
+        template_put_str(w, "<tr><td>");
+        template_put_str(w, node->seen ? id : "-");
+        template_put_str(w, "<td>");
+        template_put_str(w, node->local ? "local" : ipaddr_ntoa(&node->addr));
+
+        if (!node->online)
+        {
+            template_put_str(w, "<td colspan='2'>offline");
+            continue;
+        }
+
+        for (int r = 0; r < node->region_count; r++)
         {
-            strncpy(event_log[i - 1], event_log[i], EVENT_LENGTH);
+            template_put_str(w, "<td class='");
+            template_put_str(w, level_class_name((level_class)node->regions[r].class));
+            template_put_str(w, "'>");
+            template_put_int(w, node->regions[r].level);
         }
     }
 
-    strncpy(event_log[total_events - 1], new_event, EVENT_LENGTH - 1);
-    event_log[total_events - 1][EVENT_LENGTH - 1] = '\0';
+    template_put_str(w, "</table></div>");
+}
+
+// Copia a frota (modo gateway) para a tabela do dashboard; vazia sem pares
+static void capture_fleet(dashboard_snapshot *snapshot)
+{
+    snapshot->fleet_count = 0;
+
+    if (!gateway_enabled())
+        return;
+
+    for (uint i = 0; i < gateway_node_count(); i++)
+    {
+        const gateway_node *node = gateway_node_at(i);
+        fleet_row *row = &snapshot->fleet[snapshot->fleet_count++];
+
+        row->addr = node->addr;
+        row->node_id = node->report.node_id;
+        row->local = node->local;
+        row->seen = node->seen;
+        row->online = node->online;
+        row->region_count = node->report.region_count;
+        memcpy(row->regions, node->report.regions, sizeof(row->regions));
+    }
+}
+
+// Preenche os slots de templates/dashboard.html com o último estado publicado e a frota, capturados em snapshot
+static void fill_dashboard_values(dashboard_values *values, dashboard_snapshot *snapshot)
+{
+    const region_state *a = &snapshot->state.regions[0];
+    const region_state *b = &snapshot->state.regions[1];
+
+    read_state(&snapshot->state);
+    capture_fleet(snapshot);
+
+    values->level_a = a->current_level;
+    values->class_a = level_class_name(classify_region(a));
+    values->led_a = peripheral_label(a->led_status, a->led_status_on);
+    values->buzzer_a = peripheral_label(PERIPHERAL_BUZZER, a->buzzer_on);
+
+    values->level_b = b->current_level;
+    values->class_b = level_class_name(classify_region(b));
+    values->led_b = peripheral_label(b->led_status, b->led_status_on);
+    values->buzzer_b = peripheral_label(PERIPHERAL_BUZZER, b->buzzer_on);
+
+    values->attention_a = a->attention_threshold;
+    values->alert_a = a->alert_threshold;
+    values->attention_b = b->attention_threshold;
+    values->alert_b = b->alert_threshold;
+
+    values->events = write_events_html;
+    values->fleet = write_fleet_html;
+    values->chart_a = write_chart_A;
+    values->chart_b = write_chart_B;
+}
+
+// Versão do conteúdo da página: estado das regiões e, no modo gateway, a frota
+static uint64_t dashboard_version()
+{
+    return ((uint64_t)gateway_version() << 32) | state_version;
+}
+
+// Renderiza a página principal inteira (entrada do cache)
+static uint16_t render_dashboard(char *buffer, uint16_t size)
+{
+    static dashboard_values values;
+    static dashboard_snapshot snapshot; // Só a renderização síncrona do cache usa esta cópia
+
+    fill_dashboard_values(&values, &snapshot);
+    return template_render(&dashboard_template, &values, &snapshot, buffer, size);
 }
 
 // Função para configurar o display
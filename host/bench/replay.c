@@ -0,0 +1,432 @@
+/*
+  Replay de traces gravados pelo pipeline dos sensores, na simulação em Linux.
+
+  Uso: Flood_Sense_replay [-q] [--repeat N] trace.csv|trace.bin ...
+
+  Cada amostra do trace entra como uma leitura do ADC (sensor_set_source) e
+  percorre o mesmo caminho do firmware: conversão, filtro de picos,
+  publicação do nível a cada SENSOR_COMMIT_MS, add_reading e publish_state.
+  O relógio é virtual: time_us_64() devolve o instante da amostra (ou da
+  publicação) no trace, então horas de gravação rodam na velocidade da CPU e
+  os eventos saem com o horário da gravação.
+
+  Formatos:
+  - CSV "time_ms,level_a,level_b" (níveis em metros), o mesmo do
+    Flood_Sense_filter_bench e do tools/stream_capture.py --trace;
+  - binário com os quadros do stream USB (tools/stream_capture.py --bin),
+    com as leituras brutas do ADC; quadros com CRC errado são descartados.
+  O formato é detectado pelo conteúdo (o binário tem bytes 0x00).
+
+  Cada mudança de classe (Normal, Atenção, Alerta) de uma região é impressa
+  com o instante virtual, e o resumo termina numa assinatura (CRC-32 das
+  transições e dos níveis finais). A saída padrão é igual entre execuções e
+  pode ser comparada com diff; a vazão, que depende da máquina, vai para o
+  stderr. --repeat N repete cada trace N vezes em sequência (medição de vazão
+  com traces curtos); -q imprime só os resumos.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Sensor.h"
+#include "Stream.h"
+#include "Metrics.h"
+
+#define REPLAY_MAX_TRACES 16
+
+typedef struct
+{
+    uint64_t time_us; // Instante da amostra na gravação
+    uint16_t raw[2];  // Leitura do ADC por região
+} replay_sample;
+
+typedef struct
+{
+    const char *name;
+    replay_sample *samples;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t bad_frames; // Quadros binários descartados
+} trace;
+
+typedef struct
+{
+    uint64_t samples;
+    uint64_t commits;
+    uint64_t publishes;    // Publicações com nível novo (add_reading)
+    uint32_t transitions;  // Mudanças de classe
+    uint32_t alert_entries;
+    uint32_t signature;
+} replay_stats;
+
+// Relógio virtual: o instante corrente do trace
+static uint64_t virtual_us = 0;
+
+// Símbolos do firmware usados por Sensor.c e Region.c fora do caminho do replay
+const led_color GREEN = {0, 255, 0};
+
+uint64_t time_us_64(void)
+{
+    return virtual_us;
+}
+
+uint32_t time_us_32(void)
+{
+    return (uint32_t)virtual_us;
+}
+
+void adc_init(void) {}
+void adc_gpio_init(uint gpio) {}
+void adc_select_input(uint input) {}
+uint16_t adc_read(void) { return 0; }
+void metrics_inc(metric_counter id) {}
+bool stream_active() { return false; }
+
+// Mesmo CRC-32 de src/General.c (o resto daquele arquivo depende do HAL)
+uint32_t crc32(const uint8_t *data, size_t len)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+
+    while (len--)
+    {
+        crc ^= *data++;
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+    }
+
+    return ~crc;
+}
+
+static void append(trace *t, uint64_t time_us, uint16_t raw_a, uint16_t raw_b)
+{
+    if (t->count == t->capacity)
+    {
+        t->capacity = t->capacity ? t->capacity * 2 : 4096;
+        t->samples = realloc(t->samples, t->capacity * sizeof(replay_sample));
+        if (!t->samples)
+        {
+            fprintf(stderr, "sem memória\n");
+            exit(1);
+        }
+    }
+
+    t->samples[t->count++] = (replay_sample){time_us, {raw_a, raw_b}};
+}
+
+// Metros -> leitura do ADC, o inverso de raw_to_level() (Sensor.c)
+static uint16_t level_to_raw(double level)
+{
+    double raw = level * 4095 / SENSOR_RANGE_M + 0.5;
+
+    return raw < 0 ? 0 : raw > 4095 ? 4095 : (uint16_t)raw;
+}
+
+static void load_csv(trace *t, const char *data, size_t size)
+{
+    const char *line = data;
+    const char *end = data + size;
+
+    while (line < end)
+    {
+        const char *next = memchr(line, '\n', end - line);
+        double time_ms, a, b;
+
+        next = next ? next + 1 : end;
+        if (line[0] >= '0' && line[0] <= '9' && sscanf(line, "%lf,%lf,%lf", &time_ms, &a, &b) == 3)
+            append(t, (uint64_t)(time_ms * 1000 + 0.5), level_to_raw(a), level_to_raw(b));
+        line = next;
+    }
+}
+
+// COBS: devolve o tamanho decodificado ou 0 se o bloco estiver malformado
+static size_t cobs_decode(const uint8_t *data, size_t len, uint8_t *out, size_t out_size)
+{
+    size_t pos = 0;
+    size_t i = 0;
+
+    while (i < len)
+    {
+        uint8_t code = data[i];
+
+        if (code == 0 || i + code > len || pos + code - 1 > out_size)
+            return 0;
+
+        memcpy(out + pos, data + i + 1, code - 1);
+        pos += code - 1;
+        i += code;
+
+        if (code < 0xFF && i < len)
+        {
+            if (pos == out_size)
+                return 0;
+            out[pos++] = 0;
+        }
+    }
+
+    return pos;
+}
+
+static void decode_frame(trace *t, const uint8_t *chunk, size_t len, uint64_t *epoch_us, uint32_t *last_time)
+{
+    uint8_t payload[sizeof(stream_header) + STREAM_BLOCK_SAMPLES * sizeof(stream_record) + sizeof(uint32_t)];
+    size_t size = cobs_decode(chunk, len, payload, sizeof(payload));
+    stream_header header;
+    uint32_t crc;
+
+    if (size < sizeof(header) + sizeof(crc))
+    {
+        t->bad_frames += len > 0 && (chunk[0] < ' ' || chunk[0] > '~'); // Texto do console não conta
+        return;
+    }
+
+    size -= sizeof(crc);
+    memcpy(&crc, payload + size, sizeof(crc));
+    memcpy(&header, payload, sizeof(header));
+
+    if (crc32(payload, size) != crc || header.version != STREAM_VERSION ||
+        size != sizeof(header) + header.count * sizeof(stream_record))
+    {
+        t->bad_frames++;
+        return;
+    }
+
+    // Instante em 32 bits: desfaz a volta do contador (~71 min)
+    if (t->count > 0 && header.time_us < *last_time)
+        *epoch_us += 1ull << 32;
+    *last_time = header.time_us;
+
+    for (uint32_t i = 0; i < header.count; i++)
+    {
+        stream_record record;
+
+        memcpy(&record, payload + sizeof(header) + i * sizeof(record), sizeof(record));
+        append(t, *epoch_us + header.time_us + (uint64_t)i * header.period_us,
+               record.raw[0] & 0x0FFF, record.raw[1] & 0x0FFF);
+    }
+}
+
+static void load_binary(trace *t, const uint8_t *data, size_t size)
+{
+    uint64_t epoch_us = 0;
+    uint32_t last_time = 0;
+    size_t start = 0;
+
+    for (size_t i = 0; i <= size; i++)
+    {
+        if (i == size || data[i] == 0)
+        {
+            decode_frame(t, data + start, i - start, &epoch_us, &last_time);
+            start = i + 1;
+        }
+    }
+}
+
+static bool load_trace(trace *t, const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    uint8_t *data = NULL;
+    size_t size = 0;
+
+    if (!file)
+    {
+        perror(path);
+        return false;
+    }
+
+    fseek(file, 0, SEEK_END);
+    size = (size_t)ftell(file);
+    fseek(file, 0, SEEK_SET);
+    data = malloc(size + 1);
+    if (!data || fread(data, 1, size, file) != size)
+    {
+        fprintf(stderr, "%s: erro de leitura\n", path);
+        fclose(file);
+        free(data);
+        return false;
+    }
+    fclose(file);
+    data[size] = 0;
+
+    memset(t, 0, sizeof(*t));
+    t->name = path;
+
+    if (memchr(data, 0, size))
+        load_binary(t, data, size);
+    else
+        load_csv(t, (const char *)data, size);
+
+    free(data);
+
+    if (t->count == 0)
+    {
+        fprintf(stderr, "%s: nenhuma amostra\n", path);
+        return false;
+    }
+
+    return true;
+}
+
+// Amostra em curso, lida pelo pipeline no lugar do ADC
+static const replay_sample *current;
+
+static uint16_t replay_source(uint channel)
+{
+    return current->raw[channel];
+}
+
+static uint32_t signature_add(uint32_t signature, const void *data, size_t len)
+{
+    uint8_t buffer[4 + 16];
+
+    memcpy(buffer, &signature, sizeof(signature));
+    memcpy(buffer + 4, data, len);
+    return crc32(buffer, 4 + len);
+}
+
+// Classe de cada região após uma publicação; registra as mudanças
+static void check_transitions(replay_stats *stats, level_class last[2], bool quiet)
+{
+    state_snapshot view;
+
+    read_state(&view);
+
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        level_class class = classify_region(&view.regions[i]);
+
+        if (class == last[i])
+            continue;
+
+        uint32_t record[4] = {(uint32_t)(virtual_us / 1000), i, (uint32_t)last[i] << 8 | class, view.regions[i].current_level};
+
+        stats->signature = signature_add(stats->signature, record, sizeof(record));
+        stats->transitions++;
+        stats->alert_entries += class == LEVEL_ALERT;
+
+        if (!quiet)
+            printf("  %12.3f s  regiao %s  %-8s -> %-8s %3u m\n", virtual_us / 1e6, region_name(i),
+                   level_class_name(last[i]), level_class_name(class), view.regions[i].current_level);
+
+        last[i] = class;
+    }
+}
+
+static void replay(const trace *t, uint32_t repeat, replay_stats *stats, bool quiet)
+{
+    const uint64_t commit_us = SENSOR_COMMIT_MS * 1000u;
+    uint64_t first = t->samples[0].time_us;
+    uint64_t span = t->samples[t->count - 1].time_us - first;
+    uint64_t period = t->count > 1 ? span / (t->count - 1) : commit_us;
+    level_class last[2];
+    sensor_sample sample;
+
+    memset(stats, 0, sizeof(*stats));
+
+    // Estado do boot: níveis iniciais, filtros vazios, trace no lugar do ADC
+    virtual_us = first;
+    init_regions();
+    configure_sensor();
+    sensor_set_source(replay_source);
+    last[0] = classify_region(&region_A);
+    last[1] = classify_region(&region_B);
+
+    uint64_t next_commit = first + commit_us;
+
+    for (uint32_t r = 0; r < repeat; r++)
+    {
+        // Repetições seguidas, um período depois da última amostra
+        uint64_t offset = r * (span + period);
+
+        for (uint32_t i = 0; i < t->count; i++)
+        {
+            uint64_t time_us = t->samples[i].time_us + offset;
+
+            // Publicações vencidas até esta amostra, cada uma no seu instante
+            while (next_commit <= time_us)
+            {
+                virtual_us = next_commit;
+                stats->commits++;
+                if (sensor_commit())
+                {
+                    stats->publishes++;
+                    check_transitions(stats, last, quiet);
+                }
+                next_commit += commit_us;
+            }
+
+            virtual_us = time_us;
+            current = &t->samples[i];
+            sensor_acquire(&sample);
+        }
+    }
+
+    stats->samples = (uint64_t)t->count * repeat;
+
+    uint8_t levels[2] = {region_A.current_level, region_B.current_level};
+    stats->signature = signature_add(stats->signature, levels, sizeof(levels));
+
+    sensor_set_source(NULL);
+}
+
+static double now_s()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv)
+{
+    static trace traces[REPLAY_MAX_TRACES];
+    uint32_t repeat = 1;
+    bool quiet = false;
+    int count = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-q") == 0)
+            quiet = true;
+        else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+            repeat = (uint32_t)atoi(argv[++i]);
+        else if (count < REPLAY_MAX_TRACES && load_trace(&traces[count], argv[i]))
+            count++;
+    }
+
+    if (count == 0 || repeat == 0)
+    {
+        fprintf(stderr, "uso: %s [-q] [--repeat N] trace.csv|trace.bin ...\n", argv[0]);
+        return 2;
+    }
+
+    printf("janela %d, k=%d, piso %.2f m, ewma 1/%d, publicação a cada %d ms\n", FILTER_WINDOW, FILTER_REJECT_K,
+           FILTER_MIN_DEVIATION / (double)FILTER_ONE, 1 << FILTER_EWMA_SHIFT, SENSOR_COMMIT_MS);
+
+    for (int t = 0; t < count; t++)
+    {
+        const trace *tr = &traces[t];
+        replay_stats stats;
+        double virtual_s = (tr->samples[tr->count - 1].time_us - tr->samples[0].time_us) / 1e6;
+
+        printf("%s: %u amostras, %.1f s gravados", tr->name, tr->count, virtual_s);
+        if (tr->bad_frames)
+            printf(", %u quadros descartados", tr->bad_frames);
+        printf("\n");
+
+        double start = now_s();
+        replay(tr, repeat, &stats, quiet);
+        double elapsed = now_s() - start;
+
+        printf("%s: %llu amostras, %llu publicações (%llu com nível novo), rejeitadas A %u B %u, "
+               "transições %u (%u entradas em alerta), níveis finais A %u B %u m, assinatura %08x\n",
+               tr->name, (unsigned long long)stats.samples, (unsigned long long)stats.commits,
+               (unsigned long long)stats.publishes, sensor_filter(0)->rejected, sensor_filter(1)->rejected,
+               stats.transitions, stats.alert_entries, region_A.current_level, region_B.current_level,
+               stats.signature);
+        fprintf(stderr, "%s: vazão %.2f M amostras/s (%.1f ns/amostra), %.0fx o tempo real\n", tr->name,
+                stats.samples / elapsed / 1e6, elapsed * 1e9 / stats.samples, virtual_s * repeat / elapsed);
+    }
+
+    return 0;
+}
@@ -0,0 +1,211 @@
+/*
+  Teste de estresse do estado publicado (Region.h) na simulação em Linux.
+
+  Uso: Flood_Sense_state_stress [segundos] [leitores]
+
+  Uma thread escritora publica lotes sem parar; cada lote tem todos os campos
+  derivados do número da versão, então qualquer mistura de dois lotes é
+  detectável. Threads leitoras chamam read_state() e conferem cada cópia.
+  Além disso, a escritora recebe sinais em alta frequência e o tratador lê o
+  estado no meio da publicação, como uma IRQ ou callback do lwIP que
+  interrompe o laço no mesmo núcleo: ele nunca pode esperar pela escritora.
+
+  Para comparação, uma leitora ingênua copia as variáveis de trabalho direto,
+  sem o seqlock, e conta as misturas que encontra.
+*/
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <time.h>
+#include "Region.h"
+
+#define STRESS_MAX_READERS 16
+
+// Símbolos do firmware usados por Region.c fora do caminho testado
+const led_color GREEN = {0, 255, 0};
+
+uint64_t time_us_64(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+typedef struct
+{
+    uint64_t reads;
+    uint64_t torn;
+} reader_stats;
+
+static atomic_bool running = true;
+static reader_stats readers[STRESS_MAX_READERS];
+static reader_stats naive;
+static volatile uint64_t irq_reads = 0;
+static volatile uint64_t irq_torn = 0;
+
+// Lote da versão v: todos os campos saem de v
+static void write_batch(uint32_t v)
+{
+    is_region_A = v & 1;
+    region_A.current_level = (uint8_t)v;
+    region_B.current_level = (uint8_t)(v * 7);
+    region_A.alert_threshold = (uint8_t)(v >> 8);
+    region_B.alert_threshold = (uint8_t)(v >> 16);
+    region_A.buzzer_on = v & 2;
+
+    for (int i = 0; i < MAX_READINGS; i++)
+    {
+        readings_A[i] = (uint8_t)(v + i);
+        readings_B[i] = (uint8_t)(v - i);
+    }
+
+    total_events = v % (MAX_EVENTS + 1);
+    for (int i = 0; i < MAX_EVENTS; i++)
+        event_log[i].time_ms = v;
+}
+
+// true se a cópia é um lote inteiro (os campos batem com a versão)
+static bool coherent(const state_snapshot *s)
+{
+    uint32_t v = s->version;
+    bool ok = s->is_region_A == (v & 1) &&
+              s->regions[0].current_level == (uint8_t)v &&
+              s->regions[1].current_level == (uint8_t)(v * 7) &&
+              s->regions[0].alert_threshold == (uint8_t)(v >> 8) &&
+              s->regions[1].alert_threshold == (uint8_t)(v >> 16) &&
+              s->regions[0].buzzer_on == ((v & 2) != 0) &&
+              s->event_count == v % (MAX_EVENTS + 1);
+
+    for (int i = 0; ok && i < MAX_READINGS; i++)
+        ok = s->readings[0][i] == (uint8_t)(v + i) && s->readings[1][i] == (uint8_t)(v - i);
+
+    for (int i = 0; ok && i < MAX_EVENTS; i++)
+        ok = s->events[i].time_ms == v;
+
+    return ok;
+}
+
+// "IRQ" no meio da publicação: lê e confere sem nunca esperar pela escritora
+static void irq_handler(int signal)
+{
+    state_snapshot s;
+
+    read_state(&s);
+    irq_reads++;
+    irq_torn += !coherent(&s);
+}
+
+static void *writer_main(void *arg)
+{
+    uint64_t *publishes = arg;
+
+    while (atomic_load_explicit(&running, memory_order_relaxed))
+    {
+        write_batch(state_version + 1);
+        publish_state();
+        (*publishes)++;
+    }
+
+    return NULL;
+}
+
+static void *reader_main(void *arg)
+{
+    reader_stats *stats = arg;
+    state_snapshot s;
+
+    while (atomic_load_explicit(&running, memory_order_relaxed))
+    {
+        read_state(&s);
+        stats->reads++;
+        stats->torn += !coherent(&s);
+    }
+
+    return NULL;
+}
+
+// Leitora sem proteção: copia as variáveis de trabalho como o código fazia antes
+static void *naive_main(void *arg)
+{
+    state_snapshot s;
+
+    while (atomic_load_explicit(&running, memory_order_relaxed))
+    {
+        s.version = state_version;
+        s.is_region_A = is_region_A;
+        s.regions[0] = region_A;
+        s.regions[1] = region_B;
+        memcpy(s.readings[0], readings_A, sizeof(readings_A));
+        memcpy(s.readings[1], readings_B, sizeof(readings_B));
+        memcpy(s.events, event_log, sizeof(event_log));
+        s.event_count = (uint8_t)total_events;
+
+        naive.reads++;
+        naive.torn += !coherent(&s);
+    }
+
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    double seconds = argc > 1 ? atof(argv[1]) : 3.0;
+    int count = argc > 2 ? atoi(argv[2]) : 3;
+    pthread_t writer, naive_thread, threads[STRESS_MAX_READERS];
+    uint64_t publishes = 0;
+
+    if (count < 1)
+        count = 1;
+    if (count > STRESS_MAX_READERS)
+        count = STRESS_MAX_READERS;
+
+    write_batch(1);
+    publish_state();
+
+    signal(SIGUSR1, irq_handler);
+    pthread_create(&writer, NULL, writer_main, &publishes);
+    pthread_create(&naive_thread, NULL, naive_main, NULL);
+    for (int i = 0; i < count; i++)
+        pthread_create(&threads[i], NULL, reader_main, &readers[i]);
+
+    uint64_t start = time_us_64();
+    uint64_t end = start + (uint64_t)(seconds * 1e6);
+    struct timespec pause = {0, 20000}; // "IRQs" na escritora a cada ~20 us (mais o atraso do escalonador)
+
+    while (time_us_64() < end)
+    {
+        pthread_kill(writer, SIGUSR1);
+        nanosleep(&pause, NULL);
+    }
+
+    atomic_store(&running, false);
+    pthread_join(writer, NULL);
+    pthread_join(naive_thread, NULL);
+
+    reader_stats total = {0};
+    for (int i = 0; i < count; i++)
+    {
+        pthread_join(threads[i], NULL);
+        total.reads += readers[i].reads;
+        total.torn += readers[i].torn;
+    }
+
+    double elapsed = (time_us_64() - start) / 1e6;
+
+    printf("%.1f s, %d leitoras, snapshot de %zu bytes\n", elapsed, count, sizeof(state_snapshot));
+    printf("publicações: %llu (%.2f M/s)\n", (unsigned long long)publishes, publishes / elapsed / 1e6);
+    printf("read_state: %llu leituras (%.2f M/s), %llu incoerentes\n",
+           (unsigned long long)total.reads, total.reads / elapsed / 1e6, (unsigned long long)total.torn);
+    printf("read_state na \"IRQ\" da escritora: %llu leituras, %llu incoerentes\n",
+           (unsigned long long)irq_reads, (unsigned long long)irq_torn);
+    printf("leitora sem seqlock: %llu leituras, %llu incoerentes\n",
+           (unsigned long long)naive.reads, (unsigned long long)naive.torn);
+
+    return total.torn == 0 && irq_torn == 0 ? 0 : 1;
+}
@@ -0,0 +1,11 @@
+#ifndef HOST_HARDWARE_ADC_H
+#define HOST_HARDWARE_ADC_H
+
+#include "hardware/gpio.h"
+
+void adc_init(void);
+void adc_gpio_init(uint gpio);
+void adc_select_input(uint input);
+uint16_t adc_read(void);
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef HOST_HARDWARE_FLASH_H
+#define HOST_HARDWARE_FLASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FLASH_PAGE_SIZE (1u << 8)
+#define FLASH_SECTOR_SIZE (1u << 12)
+
+#ifndef PICO_FLASH_SIZE_BYTES
+#define PICO_FLASH_SIZE_BYTES (2 * 1024 * 1024) // Flash do Pico W
+#endif
+
+// Como no chip, apagar leva os bytes a 0xFF e gravar só zera bits
+void flash_range_erase(uint32_t flash_offs, size_t count);
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count);
+
+// Conteúdo da flash simulada a partir do deslocamento (equivale a XIP_BASE + offset)
+const uint8_t *host_flash_contents(uint32_t flash_offs);
+
+#endif
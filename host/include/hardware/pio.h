@@ -0,0 +1,25 @@
+#ifndef HOST_HARDWARE_PIO_H
+#define HOST_HARDWARE_PIO_H
+
+#include "hardware/gpio.h"
+
+typedef struct host_pio_inst *PIO;
+
+extern struct host_pio_inst host_pio0;
+#define pio0 (&host_pio0)
+
+typedef struct
+{
+    uint32_t clkdiv;
+} pio_sm_config;
+
+typedef struct
+{
+    uint8_t length;
+} pio_program_t;
+
+int pio_claim_unused_sm(PIO pio, bool required);
+uint pio_add_program(PIO pio, const pio_program_t *program);
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef HOST_HARDWARE_SYNC_H
+#define HOST_HARDWARE_SYNC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Na simulação as "IRQs" só rodam dentro de host_poll(), nunca no meio de
+// uma seção crítica; desabilitar interrupções não precisa fazer nada
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void restore_interrupts(uint32_t status) { (void)status; }
+
+// Um único núcleo executa de cada vez na simulação: o spinlock só guarda o estado
+typedef volatile uint32_t spin_lock_t;
+
+static inline spin_lock_t *spin_lock_instance(unsigned int lock_num)
+{
+    static spin_lock_t locks[32];
+    return &locks[lock_num & 31];
+}
+
+static inline int spin_lock_claim_unused(bool required) { (void)required; return 0; }
+static inline uint32_t spin_lock_blocking(spin_lock_t *lock) { *lock = 1; return 0; }
+static inline void spin_unlock(spin_lock_t *lock, uint32_t status) { (void)status; *lock = 0; }
+
+static inline void __wfe(void) {}
+static inline void __sev(void) {}
+static inline void __dmb(void) { __sync_synchronize(); }
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef HOST_HARDWARE_WATCHDOG_H
+#define HOST_HARDWARE_WATCHDOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Watchdog simulado: sem alimentação por delay_ms, a simulação é encerrada
+// (o equivalente ao reset). Nenhuma execução começa depois de um reset do
+// watchdog, então o registro em RAM não inicializada nunca é reportado.
+void watchdog_enable(uint32_t delay_ms, bool pause_on_debug);
+void watchdog_update(void);
+bool watchdog_caused_reboot(void);
+bool watchdog_enable_caused_reboot(void);
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+// Interface interna da simulação em Linux: laço de eventos que faz o papel
+// das interrupções e acesso aos framebuffers do OLED e da matriz.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define HOST_OLED_BUFSIZE (128 * 64 / 8)
+#define HOST_MATRIX_PIXELS 25
+
+// Opções de linha de comando da simulação
+typedef struct
+{
+    int port_offset;        // Somado a todas as portas vinculadas (vários nós no mesmo host)
+    bool quiet;             // Suprime a saída padrão do firmware
+    const char *flash_path; // Arquivo que guarda a flash simulada (NULL: só em memória)
+} host_options;
+
+extern host_options host_opts;
+
+// Processa rede, alarmes e entradas por até timeout_us microssegundos
+void host_poll(uint64_t timeout_us);
+
+// Alarmes vencidos (hal_time.c); retorna em quantos microssegundos vence o próximo
+uint64_t host_alarm_poll(void);
+
+// Rede (lwip_shim.c): espera eventos de sockets e despacha callbacks
+void host_net_poll(int timeout_ms);
+
+// Converte uma porta do firmware na porta real do host
+uint16_t host_map_port(uint16_t port);
+
+// Entrada do console: 'a', 'b' e 'j' simulam os botões; o resto vai para o firmware
+void host_stdin_poll(void);
+
+// Liga/desliga o ponto de acesso simulado (queda e volta do enlace)
+void host_wifi_toggle(void);
+
+// Simula o pressionamento de um botão (borda de descida)
+void host_gpio_press(unsigned int gpio);
+
+// Libera os botões simulados cujo tempo de pressionamento terminou
+void host_gpio_poll(void);
+
+// Framebuffers dos periféricos simulados
+const uint8_t *host_oled_framebuffer(void);
+const uint32_t *host_matrix_framebuffer(void);
+void host_dump_framebuffers(void);
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef HOST_LWIP_IP_ADDR_H
+#define HOST_LWIP_IP_ADDR_H
+
+#include "lwip/opt.h"
+#include "lwip/err.h"
+
+// Apenas IPv4, como no firmware (ip_addr_t == ip4_addr_t)
+typedef struct ip4_addr
+{
+    u32_t addr; // Ordem de bytes da rede
+} ip4_addr_t;
+
+typedef ip4_addr_t ip_addr_t;
+
+extern const ip_addr_t ip_addr_any;
+extern const ip_addr_t ip_addr_broadcast;
+
+#define IP_ADDR_ANY (&ip_addr_any)
+#define IP4_ADDR_ANY (&ip_addr_any)
+#define IP_ADDR_BROADCAST (&ip_addr_broadcast)
+
+#define IP4_ADDR(ipaddr, a, b, c, d) \
+    (ipaddr)->addr = ((u32_t)(a) | ((u32_t)(b) << 8) | ((u32_t)(c) << 16) | ((u32_t)(d) << 24))
+
+#define ip4_addr_get_u32(ipaddr) ((ipaddr)->addr)
+#define ip4_addr_set_u32(ipaddr, value) ((ipaddr)->addr = (value))
+#define ip_addr_get_ip4_u32(ipaddr) ip4_addr_get_u32(ipaddr)
+#define ip_addr_cmp(a, b) ((a)->addr == (b)->addr)
+#define ip_addr_set_zero(ipaddr) ((ipaddr)->addr = 0)
+#define ip_addr_isany(ipaddr) ((ipaddr) == NULL || (ipaddr)->addr == 0)
+#define ip_2_ip4(ipaddr) (ipaddr)
+
+char *ipaddr_ntoa(const ip_addr_t *addr);
+char *ipaddr_ntoa_r(const ip_addr_t *addr, char *buf, int buflen);
+int ipaddr_aton(const char *cp, ip_addr_t *addr);
+
+#endif
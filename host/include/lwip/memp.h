@@ -0,0 +1,13 @@
+#ifndef HOST_LWIP_MEMP_H
+#define HOST_LWIP_MEMP_H
+
+#include "lwip/opt.h"
+
+typedef enum
+{
+#define LWIP_MEMPOOL(name, num, size, desc) MEMP_##name,
+#include "lwip/priv/memp_std.h"
+    MEMP_MAX
+} memp_t;
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef HOST_LWIP_NETIF_H
+#define HOST_LWIP_NETIF_H
+
+#include "lwip/opt.h"
+#include "lwip/ip_addr.h"
+
+#define NETIF_FLAG_UP 0x01U
+#define NETIF_FLAG_LINK_UP 0x04U
+
+struct netif
+{
+    ip_addr_t ip_addr;
+    ip_addr_t netmask;
+    ip_addr_t gw;
+    u8_t flags;
+};
+
+extern struct netif *netif_default;
+
+#define netif_is_up(netif) (((netif)->flags & NETIF_FLAG_UP) ? 1 : 0)
+#define netif_is_link_up(netif) (((netif)->flags & NETIF_FLAG_LINK_UP) ? 1 : 0)
+#define netif_ip4_addr(netif) (&((netif)->ip_addr))
+
+#endif
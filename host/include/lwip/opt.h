@@ -0,0 +1,36 @@
+#ifndef HOST_LWIP_OPT_H
+#define HOST_LWIP_OPT_H
+
+// Mesmas opções do firmware, com os padrões do lwIP para o que não é definido
+
+#include "lwipopts.h"
+
+#ifndef TCP_MSS
+#define TCP_MSS 536
+#endif
+
+#ifndef TCP_SND_BUF
+#define TCP_SND_BUF (2 * TCP_MSS)
+#endif
+
+#ifndef TCP_SND_QUEUELEN
+#define TCP_SND_QUEUELEN ((4 * (TCP_SND_BUF) + (TCP_MSS - 1)) / (TCP_MSS))
+#endif
+
+#ifndef MEMP_NUM_TCP_PCB_LISTEN
+#define MEMP_NUM_TCP_PCB_LISTEN 8
+#endif
+
+#ifndef MEMP_NUM_UDP_PCB
+#define MEMP_NUM_UDP_PCB 4
+#endif
+
+#ifndef PBUF_POOL_SIZE
+#define PBUF_POOL_SIZE 16
+#endif
+
+#ifndef PBUF_POOL_BUFSIZE
+#define PBUF_POOL_BUFSIZE (TCP_MSS + 54)
+#endif
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef HOST_LWIP_PBUF_H
+#define HOST_LWIP_PBUF_H
+
+#include <stddef.h>
+#include "lwip/opt.h"
+#include "lwip/err.h"
+
+typedef enum
+{
+    PBUF_TRANSPORT,
+    PBUF_IP,
+    PBUF_LINK,
+    PBUF_RAW
+} pbuf_layer;
+
+typedef enum
+{
+    PBUF_RAM,
+    PBUF_ROM,
+    PBUF_REF,
+    PBUF_POOL
+} pbuf_type;
+
+struct pbuf
+{
+    struct pbuf *next;
+    void *payload;
+    u16_t tot_len;
+    u16_t len;
+    u8_t type_internal;
+    u8_t flags;
+    u16_t ref;
+    u16_t alloc_len; // Interno da simulação: tamanho alocado (estatísticas do heap)
+};
+
+struct pbuf *pbuf_alloc(pbuf_layer layer, u16_t length, pbuf_type type);
+u8_t pbuf_free(struct pbuf *p);
+void pbuf_cat(struct pbuf *head, struct pbuf *tail);
+err_t pbuf_take(struct pbuf *buf, const void *dataptr, u16_t len);
+u16_t pbuf_copy_partial(const struct pbuf *p, void *dataptr, u16_t len, u16_t offset);
+
+#endif
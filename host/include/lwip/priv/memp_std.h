@@ -0,0 +1,14 @@
+// Pools emulados pela simulação, no formato X-macro do lwIP (sem guarda de
+// inclusão: o arquivo é incluído várias vezes com LWIP_MEMPOOL diferentes)
+
+#ifndef LWIP_PBUF_MEMPOOL
+#define LWIP_PBUF_MEMPOOL(name, num, payload, desc) LWIP_MEMPOOL(name, num, payload, desc)
+#endif
+
+LWIP_MEMPOOL(UDP_PCB, MEMP_NUM_UDP_PCB, 0, "UDP_PCB")
+LWIP_MEMPOOL(TCP_PCB, MEMP_NUM_TCP_PCB, 0, "TCP_PCB")
+LWIP_MEMPOOL(TCP_PCB_LISTEN, MEMP_NUM_TCP_PCB_LISTEN, 0, "TCP_PCB_LISTEN")
+LWIP_PBUF_MEMPOOL(PBUF_POOL, PBUF_POOL_SIZE, PBUF_POOL_BUFSIZE, "PBUF_POOL")
+
+#undef LWIP_MEMPOOL
+#undef LWIP_PBUF_MEMPOOL
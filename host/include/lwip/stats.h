@@ -0,0 +1,29 @@
+#ifndef HOST_LWIP_STATS_H
+#define HOST_LWIP_STATS_H
+
+#include "lwip/opt.h"
+#include "lwip/err.h"
+#include "lwip/memp.h"
+
+typedef u16_t STAT_COUNTER;
+typedef u16_t mem_size_t;
+
+struct stats_mem
+{
+    STAT_COUNTER err;
+    mem_size_t avail;
+    mem_size_t used;
+    mem_size_t max;
+    STAT_COUNTER illegal;
+};
+
+// Subconjunto de struct stats_ usado pelo firmware
+struct stats_
+{
+    struct stats_mem mem;
+    struct stats_mem *memp[MEMP_MAX];
+};
+
+extern struct stats_ lwip_stats;
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef HOST_LWIP_TCP_H
+#define HOST_LWIP_TCP_H
+
+// API "raw" de TCP do lwIP emulada sobre sockets do Linux. Os PCBs vêm de um
+// pool estático de MEMP_NUM_TCP_PCB entradas, como no dispositivo, para que
+// o esgotamento de conexões se reproduza na simulação.
+
+#include "lwip/opt.h"
+#include "lwip/err.h"
+#include "lwip/ip_addr.h"
+#include "lwip/pbuf.h"
+
+#define TCP_WRITE_FLAG_COPY 0x01
+#define TCP_WRITE_FLAG_MORE 0x02
+
+#define TCP_PRIO_MIN 1
+#define TCP_PRIO_NORMAL 64
+#define TCP_PRIO_MAX 127
+
+struct tcp_pcb;
+
+typedef err_t (*tcp_accept_fn)(void *arg, struct tcp_pcb *newpcb, err_t err);
+typedef err_t (*tcp_recv_fn)(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err);
+typedef err_t (*tcp_sent_fn)(void *arg, struct tcp_pcb *tpcb, u16_t len);
+typedef err_t (*tcp_poll_fn)(void *arg, struct tcp_pcb *tpcb);
+typedef void (*tcp_err_fn)(void *arg, err_t err);
+typedef err_t (*tcp_connected_fn)(void *arg, struct tcp_pcb *tpcb, err_t err);
+
+enum tcp_state
+{
+    CLOSED = 0,
+    LISTEN = 1,
+    SYN_SENT = 2,
+    ESTABLISHED = 4,
+    CLOSING = 8
+};
+
+struct tcp_pcb
+{
+    ip_addr_t local_ip;
+    ip_addr_t remote_ip;
+    u16_t local_port;
+    u16_t remote_port;
+    enum tcp_state state;
+    u8_t prio;
+
+    void *callback_arg;
+    tcp_accept_fn accept;
+    tcp_recv_fn recv;
+    tcp_sent_fn sent;
+    tcp_poll_fn poll;
+    tcp_err_fn errf;
+    tcp_connected_fn connected;
+    u8_t pollinterval;
+
+    u16_t snd_buf;      // Espaço livre no buffer de envio
+    u16_t snd_queuelen; // Segmentos enfileirados
+
+    // Estado interno do shim
+    int fd;
+    bool in_use;
+    bool listening;
+    bool fin_sent;
+    u32_t poll_tick;
+    struct pbuf *refused_data;
+    u16_t out_len;
+    u8_t out[TCP_SND_BUF];
+};
+
+#define tcp_sndbuf(pcb) ((pcb)->snd_buf)
+#define tcp_sndqueuelen(pcb) ((pcb)->snd_queuelen)
+#define tcp_listen(pcb) tcp_listen_with_backlog(pcb, 255)
+
+struct tcp_pcb *tcp_new(void);
+struct tcp_pcb *tcp_new_ip_type(u8_t type);
+err_t tcp_bind(struct tcp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port);
+struct tcp_pcb *tcp_listen_with_backlog(struct tcp_pcb *pcb, u8_t backlog);
+err_t tcp_connect(struct tcp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port, tcp_connected_fn connected);
+
+void tcp_arg(struct tcp_pcb *pcb, void *arg);
+void tcp_accept(struct tcp_pcb *pcb, tcp_accept_fn accept);
+void tcp_recv(struct tcp_pcb *pcb, tcp_recv_fn recv);
+void tcp_sent(struct tcp_pcb *pcb, tcp_sent_fn sent);
+void tcp_poll(struct tcp_pcb *pcb, tcp_poll_fn poll, u8_t interval);
+void tcp_err(struct tcp_pcb *pcb, tcp_err_fn err);
+void tcp_setprio(struct tcp_pcb *pcb, u8_t prio);
+void tcp_recved(struct tcp_pcb *pcb, u16_t len);
+
+err_t tcp_write(struct tcp_pcb *pcb, const void *dataptr, u16_t len, u8_t apiflags);
+err_t tcp_output(struct tcp_pcb *pcb);
+err_t tcp_close(struct tcp_pcb *pcb);
+void tcp_abort(struct tcp_pcb *pcb);
+
+#endif
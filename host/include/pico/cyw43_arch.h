@@ -0,0 +1,52 @@
+#ifndef HOST_PICO_CYW43_ARCH_H
+#define HOST_PICO_CYW43_ARCH_H
+
+// Shim do pico_cyw43_arch: o "Wi-Fi" é a interface de loopback do host e o
+// processamento de rede acontece em cyw43_arch_poll() e nas esperas.
+
+#include "pico/stdlib.h"
+#include "lwip/netif.h"
+
+#define CYW43_WL_GPIO_LED_PIN 0
+
+#define CYW43_AUTH_OPEN 0
+#define CYW43_AUTH_WPA2_AES_PSK 0x00400004
+
+#define CYW43_ITF_STA 0
+
+// Modos de power-save (valores simbólicos; no host apenas são registrados)
+#define CYW43_NO_POWERSAVE_MODE 0
+#define CYW43_PERFORMANCE_PM 1
+#define CYW43_AGGRESSIVE_PM 2
+#define CYW43_DEFAULT_PM 3
+
+typedef struct
+{
+    uint32_t pm;
+} cyw43_t;
+
+extern cyw43_t cyw43_state;
+
+#define CYW43_LINK_DOWN 0
+#define CYW43_LINK_JOIN 1
+#define CYW43_LINK_NOIP 2
+#define CYW43_LINK_UP 3
+#define CYW43_LINK_FAIL -1
+#define CYW43_LINK_NONET -2
+#define CYW43_LINK_BADAUTH -3
+
+int cyw43_arch_init(void);
+void cyw43_arch_deinit(void);
+void cyw43_arch_enable_sta_mode(void);
+int cyw43_arch_wifi_connect_timeout_ms(const char *ssid, const char *pw, uint32_t auth, uint32_t timeout);
+int cyw43_arch_wifi_connect_async(const char *ssid, const char *pw, uint32_t auth);
+int cyw43_tcpip_link_status(cyw43_t *self, int itf);
+int cyw43_wifi_leave(cyw43_t *self, int itf);
+void cyw43_arch_gpio_put(uint wl_gpio, bool value);
+void cyw43_arch_poll(void);
+int cyw43_wifi_pm(cyw43_t *self, uint32_t pm);
+
+static inline void cyw43_arch_lwip_begin(void) {}
+static inline void cyw43_arch_lwip_end(void) {}
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef HOST_PICO_MULTICORE_H
+#define HOST_PICO_MULTICORE_H
+
+// A simulação tem uma única thread: a função do núcleo 1 roda até o fim dentro
+// da própria chamada. Só serve para funções que retornam (inicializações).
+static inline void multicore_launch_core1(void (*entry)(void))
+{
+    entry();
+}
+
+#endif
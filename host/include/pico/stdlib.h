@@ -0,0 +1,63 @@
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+// Shim do pico/stdlib.h para a simulação em Linux. Reproduz apenas a parte
+// do Pico SDK usada pelo firmware; o tempo é o relógio monotônico do host.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "hardware/gpio.h"
+
+#ifndef PICO_ON_DEVICE
+#define PICO_ON_DEVICE 0
+#endif
+
+#define PICO_ERROR_TIMEOUT -1
+
+// RAM não inicializada pelo runtime: no host é estática comum (zerada a cada execução)
+#define __uninitialized_ram(name) name
+
+typedef uint64_t absolute_time_t;
+
+#define at_the_end_of_time ((absolute_time_t)INT64_MAX)
+
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+
+static inline absolute_time_t get_absolute_time(void) { return time_us_64(); }
+static inline uint64_t to_us_since_boot(absolute_time_t t) { return t; }
+static inline absolute_time_t from_us_since_boot(uint64_t us) { return us; }
+static inline uint32_t to_ms_since_boot(absolute_time_t t) { return (uint32_t)(t / 1000); }
+static inline absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us) { return t + us; }
+static inline absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms) { return t + (uint64_t)ms * 1000; }
+static inline absolute_time_t make_timeout_time_us(uint64_t us) { return time_us_64() + us; }
+static inline absolute_time_t make_timeout_time_ms(uint32_t ms) { return time_us_64() + (uint64_t)ms * 1000; }
+static inline int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) { return (int64_t)(to - from); }
+
+// As esperas processam rede, alarmes e botões simulados, como as IRQs no dispositivo
+void sleep_us(uint64_t us);
+void sleep_ms(uint32_t ms);
+void busy_wait_us(uint64_t us);
+
+// Espera eventos até o prazo; retorna true se o prazo foi atingido. No host o
+// "evento" é qualquer atividade atendida em host_poll()
+bool best_effort_wfe_or_timeout(absolute_time_t timeout_timestamp);
+
+// Alarmes do timer: os callbacks rodam dentro de host_poll(), como a IRQ do timer
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data);
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past);
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past);
+bool cancel_alarm(alarm_id_t alarm_id);
+
+bool stdio_init_all(void);
+int getchar_timeout_us(uint32_t timeout_us);
+void stdio_set_chars_available_callback(void (*fn)(void *), void *param);
+
+bool set_sys_clock_khz(uint32_t freq_khz, bool required);
+
+static inline void tight_loop_contents(void) {}
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef HOST_PICO_UNIQUE_ID_H
+#define HOST_PICO_UNIQUE_ID_H
+
+#include <stdint.h>
+
+#define PICO_UNIQUE_BOARD_ID_SIZE_BYTES 8
+
+typedef struct
+{
+    uint8_t id[PICO_UNIQUE_BOARD_ID_SIZE_BYTES];
+} pico_unique_board_id_t;
+
+// No host o ID deriva do deslocamento de portas, distinguindo nós no mesmo computador
+void pico_get_unique_board_id(pico_unique_board_id_t *id_out);
+
+#endif
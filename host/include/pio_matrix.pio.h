@@ -0,0 +1,19 @@
+#ifndef HOST_PIO_MATRIX_PIO_H
+#define HOST_PIO_MATRIX_PIO_H
+
+// Substitui o header gerado pelo pioasm: no host a matriz é um framebuffer em memória
+
+#include "hardware/pio.h"
+#include "hardware/clocks.h"
+
+static const pio_program_t pio_matrix_program = {.length = 8};
+
+static inline void pio_matrix_program_init(PIO pio, uint sm, uint offset, uint pin)
+{
+    (void)pio;
+    (void)sm;
+    (void)offset;
+    (void)pin;
+}
+
+#endif
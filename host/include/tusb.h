@@ -0,0 +1,17 @@
+#ifndef HOST_TUSB_H
+#define HOST_TUSB_H
+
+// Shim da parte de CDC do TinyUSB usada pelo firmware. Na simulação o "USB"
+// é a saída padrão, a mesma do printf, como o stdio USB no dispositivo.
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CFG_TUD_CDC_TX_BUFSIZE 256 // Como no stdio USB do SDK
+
+bool tud_cdc_connected(void);
+uint32_t tud_cdc_write_available(void);
+uint32_t tud_cdc_write(const void *buffer, uint32_t bufsize);
+uint32_t tud_cdc_write_flush(void);
+
+#endif
@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include "pico/cyw43_arch.h"
+#include "pico/unique_id.h"
+#include "host_hal.h"
+
+static struct netif host_netif;
+struct netif *netif_default = NULL;
+cyw43_t cyw43_state;
+
+#define HOST_WIFI_JOIN_US 300000 // Duração simulada da associação + DHCP
+
+static bool ap_available = true; // Alternado pela tecla 'w'
+static bool joining = false;
+static uint64_t join_done_at = 0;
+
+int cyw43_arch_init(void)
+{
+    IP4_ADDR(&host_netif.ip_addr, 127, 0, 0, 1);
+    IP4_ADDR(&host_netif.netmask, 255, 0, 0, 0);
+    IP4_ADDR(&host_netif.gw, 127, 0, 0, 1);
+    host_netif.flags = NETIF_FLAG_UP;
+    netif_default = &host_netif;
+    return 0;
+}
+
+void cyw43_arch_deinit(void)
+{
+    netif_default = NULL;
+}
+
+void cyw43_arch_enable_sta_mode(void)
+{
+}
+
+// A "associação" é imediata: o loopback está sempre disponível
+int cyw43_arch_wifi_connect_timeout_ms(const char *ssid, const char *pw, uint32_t auth, uint32_t timeout)
+{
+    (void)ssid;
+    (void)pw;
+    (void)auth;
+    (void)timeout;
+    host_netif.flags |= NETIF_FLAG_LINK_UP;
+    return 0;
+}
+
+// A associação termina após HOST_WIFI_JOIN_US se o ponto de acesso estiver no ar
+int cyw43_arch_wifi_connect_async(const char *ssid, const char *pw, uint32_t auth)
+{
+    (void)ssid;
+    (void)pw;
+    (void)auth;
+    joining = true;
+    join_done_at = time_us_64() + HOST_WIFI_JOIN_US;
+    host_netif.flags &= ~NETIF_FLAG_LINK_UP;
+    return 0;
+}
+
+int cyw43_tcpip_link_status(cyw43_t *self, int itf)
+{
+    (void)self;
+    (void)itf;
+
+    if (joining && time_us_64() >= join_done_at)
+    {
+        joining = false;
+        if (!ap_available)
+            return CYW43_LINK_NONET;
+        host_netif.flags |= NETIF_FLAG_LINK_UP;
+    }
+
+    if (joining)
+        return CYW43_LINK_JOIN;
+
+    return (host_netif.flags & NETIF_FLAG_LINK_UP) ? CYW43_LINK_UP : CYW43_LINK_DOWN;
+}
+
+int cyw43_wifi_leave(cyw43_t *self, int itf)
+{
+    (void)self;
+    (void)itf;
+    joining = false;
+    host_netif.flags &= ~NETIF_FLAG_LINK_UP;
+    return 0;
+}
+
+void host_wifi_toggle(void)
+{
+    ap_available = !ap_available;
+
+    if (!ap_available)
+        host_netif.flags &= ~NETIF_FLAG_LINK_UP;
+
+    fprintf(stderr, "[host] ponto de acesso %s\n", ap_available ? "no ar" : "fora do ar");
+}
+
+void cyw43_arch_gpio_put(uint wl_gpio, bool value)
+{
+    (void)wl_gpio;
+    (void)value;
+}
+
+int cyw43_wifi_pm(cyw43_t *self, uint32_t pm)
+{
+    self->pm = pm;
+    return 0;
+}
+
+void cyw43_arch_poll(void)
+{
+    host_poll(0);
+}
+
+void pico_get_unique_board_id(pico_unique_board_id_t *id_out)
+{
+    uint16_t node = (uint16_t)(0x4653 + host_opts.port_offset);
+
+    for (int i = 0; i < PICO_UNIQUE_BOARD_ID_SIZE_BYTES; i++)
+        id_out->id[i] = 0;
+
+    id_out->id[PICO_UNIQUE_BOARD_ID_SIZE_BYTES - 2] = node >> 8;
+    id_out->id[PICO_UNIQUE_BOARD_ID_SIZE_BYTES - 1] = node & 0xFF;
+}
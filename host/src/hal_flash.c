@@ -0,0 +1,82 @@
+#include <stdio.h>
+#include <string.h>
+#include "hardware/flash.h"
+#include "host_hal.h"
+
+// Flash simulada: começa apagada ou com o conteúdo do arquivo de --flash,
+// que é regravado a cada operação (o estado sobrevive a reinícios da simulação)
+static uint8_t flash[PICO_FLASH_SIZE_BYTES];
+static bool flash_loaded = false;
+
+static void flash_load(void)
+{
+    if (flash_loaded)
+        return;
+
+    flash_loaded = true;
+    memset(flash, 0xFF, sizeof(flash));
+
+    if (!host_opts.flash_path)
+        return;
+
+    FILE *file = fopen(host_opts.flash_path, "rb");
+    if (file)
+    {
+        if (fread(flash, 1, sizeof(flash), file) == 0)
+            memset(flash, 0xFF, sizeof(flash));
+        fclose(file);
+    }
+}
+
+static void flash_store(uint32_t offset, size_t count)
+{
+    if (!host_opts.flash_path)
+        return;
+
+    FILE *file = fopen(host_opts.flash_path, "r+b");
+    if (!file)
+        file = fopen(host_opts.flash_path, "w+b");
+    if (!file)
+        return;
+
+    // Arquivo novo: grava a imagem inteira para os deslocamentos baterem
+    fseek(file, 0, SEEK_END);
+    if (ftell(file) < (long)sizeof(flash))
+    {
+        offset = 0;
+        count = sizeof(flash);
+    }
+
+    fseek(file, offset, SEEK_SET);
+    fwrite(flash + offset, 1, count, file);
+    fclose(file);
+}
+
+void flash_range_erase(uint32_t flash_offs, size_t count)
+{
+    flash_load();
+
+    if (flash_offs % FLASH_SECTOR_SIZE || count % FLASH_SECTOR_SIZE || flash_offs + count > sizeof(flash))
+        return;
+
+    memset(flash + flash_offs, 0xFF, count);
+    flash_store(flash_offs, count);
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count)
+{
+    flash_load();
+
+    if (flash_offs % FLASH_PAGE_SIZE || count % FLASH_PAGE_SIZE || flash_offs + count > sizeof(flash))
+        return;
+
+    for (size_t i = 0; i < count; i++)
+        flash[flash_offs + i] &= data[i];
+    flash_store(flash_offs, count);
+}
+
+const uint8_t *host_flash_contents(uint32_t flash_offs)
+{
+    flash_load();
+    return flash + flash_offs;
+}
@@ -0,0 +1,104 @@
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "host_hal.h"
+
+#define PRESS_DURATION_US 50000 // Tempo que o botão simulado fica pressionado
+
+static bool gpio_level[NUM_BANK0_GPIOS];
+static bool gpio_pulled_up[NUM_BANK0_GPIOS];
+static uint32_t gpio_irq_mask[NUM_BANK0_GPIOS];
+static uint64_t gpio_release_at[NUM_BANK0_GPIOS];
+static gpio_irq_callback_t gpio_callback = NULL;
+
+void gpio_init(uint gpio)
+{
+    gpio_level[gpio] = false;
+}
+
+void gpio_set_dir(uint gpio, bool out)
+{
+    (void)gpio;
+    (void)out;
+}
+
+void gpio_pull_up(uint gpio)
+{
+    gpio_pulled_up[gpio] = true;
+    gpio_level[gpio] = true;
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn)
+{
+    (void)gpio;
+    (void)fn;
+}
+
+bool gpio_get(uint gpio)
+{
+    return gpio_level[gpio];
+}
+
+void gpio_put(uint gpio, bool value)
+{
+    gpio_level[gpio] = value;
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t events, bool enabled)
+{
+    if (enabled)
+        gpio_irq_mask[gpio] |= events;
+    else
+        gpio_irq_mask[gpio] &= ~events;
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events, bool enabled, gpio_irq_callback_t callback)
+{
+    gpio_set_irq_enabled(gpio, events, enabled);
+    gpio_callback = callback;
+}
+
+// As bordas não ficam latchadas na simulação: não há o que reconhecer
+void gpio_acknowledge_irq(uint gpio, uint32_t events)
+{
+    (void)gpio;
+    (void)events;
+}
+
+static void gpio_set_level(uint gpio, bool level)
+{
+    bool previous = gpio_level[gpio];
+    gpio_level[gpio] = level;
+
+    if (previous == level || gpio_callback == NULL)
+        return;
+
+    uint32_t event = level ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+
+    if (gpio_irq_mask[gpio] & event)
+        gpio_callback(gpio, event);
+}
+
+// Pressiona o botão agora e agenda a liberação
+void host_gpio_press(unsigned int gpio)
+{
+    if (gpio >= NUM_BANK0_GPIOS)
+        return;
+
+    gpio_set_level(gpio, false);
+    gpio_release_at[gpio] = time_us_64() + PRESS_DURATION_US;
+}
+
+// Libera os botões cujo tempo de pressionamento terminou
+void host_gpio_poll(void)
+{
+    uint64_t now = time_us_64();
+
+    for (uint gpio = 0; gpio < NUM_BANK0_GPIOS; gpio++)
+    {
+        if (gpio_release_at[gpio] != 0 && now >= gpio_release_at[gpio])
+        {
+            gpio_release_at[gpio] = 0;
+            gpio_set_level(gpio, gpio_pulled_up[gpio]);
+        }
+    }
+}
@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/pwm.h"
+#include "hardware/pio.h"
+#include "hardware/i2c.h"
+#include "hardware/adc.h"
+#include "host_hal.h"
+
+struct host_pio_inst
+{
+    uint32_t fifo_count; // Palavras recebidas no quadro atual
+};
+
+struct host_i2c_inst
+{
+    uint baudrate;
+};
+
+struct host_pio_inst host_pio0;
+i2c_inst_t host_i2c1;
+
+static uint16_t pwm_levels[8][2];
+static uint8_t oled_gram[HOST_OLED_BUFSIZE];      // GRAM do SSD1306 (endereçamento vertical)
+static uint32_t matrix_frame[HOST_MATRIX_PIXELS]; // Último quadro completo da matriz
+static uint32_t matrix_pending[HOST_MATRIX_PIXELS];
+static uint16_t adc_value[5];
+static uint adc_input = 0;
+
+void pwm_set_clkdiv(uint slice_num, float divider)
+{
+    (void)slice_num;
+    (void)divider;
+}
+
+void pwm_set_wrap(uint slice_num, uint16_t wrap)
+{
+    (void)slice_num;
+    (void)wrap;
+}
+
+void pwm_set_enabled(uint slice_num, bool enabled)
+{
+    (void)slice_num;
+    (void)enabled;
+}
+
+void pwm_set_chan_level(uint slice_num, uint chan, uint16_t level)
+{
+    pwm_levels[slice_num & 7u][chan & 1u] = level;
+}
+
+uint16_t host_pwm_get_chan_level(uint slice_num, uint chan)
+{
+    return pwm_levels[slice_num & 7u][chan & 1u];
+}
+
+int pio_claim_unused_sm(PIO pio, bool required)
+{
+    (void)pio;
+    (void)required;
+    return 0;
+}
+
+uint pio_add_program(PIO pio, const pio_program_t *program)
+{
+    (void)pio;
+    (void)program;
+    return 0;
+}
+
+// Cada 25 palavras enviadas formam um quadro da matriz
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data)
+{
+    (void)sm;
+    matrix_pending[pio->fifo_count++] = data;
+
+    if (pio->fifo_count == HOST_MATRIX_PIXELS)
+    {
+        memcpy(matrix_frame, matrix_pending, sizeof(matrix_frame));
+        pio->fifo_count = 0;
+    }
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate)
+{
+    i2c->baudrate = baudrate;
+    return baudrate;
+}
+
+// Interpreta o protocolo do SSD1306: comandos (0x80) são ignorados e dados (0x40) vão para a GRAM
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop)
+{
+    (void)i2c;
+    (void)addr;
+    (void)nostop;
+
+    if (len > 1 && src[0] == 0x40)
+    {
+        size_t n = len - 1 < sizeof(oled_gram) ? len - 1 : sizeof(oled_gram);
+        memcpy(oled_gram, src + 1, n);
+    }
+
+    return (int)len;
+}
+
+void adc_init(void)
+{
+}
+
+void adc_gpio_init(uint gpio)
+{
+    (void)gpio;
+}
+
+void adc_select_input(uint input)
+{
+    adc_input = input % 5;
+}
+
+uint16_t adc_read(void)
+{
+    return adc_value[adc_input];
+}
+
+const uint8_t *host_oled_framebuffer(void)
+{
+    return oled_gram;
+}
+
+const uint32_t *host_matrix_framebuffer(void)
+{
+    return matrix_frame;
+}
+
+// Desenha o OLED e a matriz no terminal (tecla 'v')
+void host_dump_framebuffers(void)
+{
+    for (int y = 0; y < 64; y += 2)
+    {
+        char line[129];
+
+        for (int x = 0; x < 128; x++)
+        {
+            bool top = oled_gram[x * 8 + (y >> 3)] & (1u << (y & 7));
+            bool bottom = oled_gram[x * 8 + ((y + 1) >> 3)] & (1u << ((y + 1) & 7));
+            line[x] = top && bottom ? '#' : (top ? '"' : (bottom ? '.' : ' '));
+        }
+
+        line[128] = '\0';
+        printf("|%s|\n", line);
+    }
+
+    for (int row = 4; row >= 0; row--)
+    {
+        printf("  ");
+        for (int col = 0; col < 5; col++)
+        {
+            printf("%c", matrix_frame[row * 5 + col] ? 'O' : '.');
+        }
+        printf("\n");
+    }
+}
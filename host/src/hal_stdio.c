@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include "pico/stdlib.h"
+#include "tusb.h"
+#include "host_hal.h"
+
+#define STDIN_RING_SIZE 256
+
+static uint8_t stdin_ring[STDIN_RING_SIZE];
+static uint16_t stdin_head = 0;
+static uint16_t stdin_tail = 0;
+static bool stdin_closed = false;
+static void (*chars_available)(void *) = NULL;
+static void *chars_available_param = NULL;
+
+bool stdio_init_all(void)
+{
+    int flags = fcntl(STDIN_FILENO, F_GETFL, 0);
+
+    if (flags >= 0)
+        fcntl(STDIN_FILENO, F_SETFL, flags | O_NONBLOCK);
+
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    return true;
+}
+
+// Lê o que houver no stdin; as teclas de botão são desviadas para o GPIO simulado
+void host_stdin_poll(void)
+{
+    uint8_t buffer[64];
+
+    if (stdin_closed)
+        return;
+
+    ssize_t n = read(STDIN_FILENO, buffer, sizeof(buffer));
+
+    if (n == 0)
+    {
+        stdin_closed = true;
+        return;
+    }
+
+    for (ssize_t i = 0; i < n; i++)
+    {
+        switch (buffer[i])
+        {
+        case 'a':
+            host_gpio_press(5);
+            break;
+        case 'b':
+            host_gpio_press(6);
+            break;
+        case 'j':
+            host_gpio_press(22);
+            break;
+        case 'v':
+            host_dump_framebuffers();
+            break;
+        case 'w':
+            host_wifi_toggle();
+            break;
+        default:
+            if ((uint16_t)(stdin_head + 1) % STDIN_RING_SIZE != stdin_tail)
+            {
+                stdin_ring[stdin_head] = buffer[i];
+                stdin_head = (stdin_head + 1) % STDIN_RING_SIZE;
+            }
+
+            if (chars_available)
+                chars_available(chars_available_param);
+            break;
+        }
+    }
+}
+
+void stdio_set_chars_available_callback(void (*fn)(void *), void *param)
+{
+    chars_available = fn;
+    chars_available_param = param;
+}
+
+int getchar_timeout_us(uint32_t timeout_us)
+{
+    uint64_t deadline = time_us_64() + timeout_us;
+
+    do
+    {
+        host_stdin_poll();
+
+        if (stdin_tail != stdin_head)
+        {
+            int c = stdin_ring[stdin_tail];
+            stdin_tail = (stdin_tail + 1) % STDIN_RING_SIZE;
+            return c;
+        }
+
+        if (timeout_us > 0)
+            host_poll(1000);
+    } while (time_us_64() < deadline);
+
+    return PICO_ERROR_TIMEOUT;
+}
+
+bool tud_cdc_connected(void)
+{
+    return true;
+}
+
+// A saída padrão não enche: cabe sempre uma FIFO inteira
+uint32_t tud_cdc_write_available(void)
+{
+    return CFG_TUD_CDC_TX_BUFSIZE;
+}
+
+uint32_t tud_cdc_write(const void *buffer, uint32_t bufsize)
+{
+    return (uint32_t)fwrite(buffer, 1, bufsize, stdout);
+}
+
+uint32_t tud_cdc_write_flush(void)
+{
+    fflush(stdout);
+    return 0;
+}
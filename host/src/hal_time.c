@@ -0,0 +1,224 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/watchdog.h"
+#include "host_hal.h"
+
+#define HOST_WFE_SLICE_US 10000 // Maior espera contínua em best_effort_wfe_or_timeout()
+
+#define HOST_ALARMS_MAX 16       // Alarmes simultâneos (o pool padrão do SDK também é limitado)
+
+typedef struct
+{
+    alarm_callback_t callback;
+    void *user_data;
+    uint64_t due_us;
+} host_alarm;
+
+static host_alarm alarms[HOST_ALARMS_MAX];
+static uint64_t watchdog_delay_us = 0; // 0: watchdog desligado
+static uint64_t watchdog_fed_us;
+static uint64_t boot_us = 0; // Instante do "boot" no relógio monotônico do host
+
+static uint64_t monotonic_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+uint64_t time_us_64(void)
+{
+    if (boot_us == 0)
+        boot_us = monotonic_us();
+
+    return monotonic_us() - boot_us;
+}
+
+uint32_t time_us_32(void)
+{
+    return (uint32_t)time_us_64();
+}
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past)
+{
+    (void)fire_if_past;
+
+    for (int i = 0; i < HOST_ALARMS_MAX; i++)
+    {
+        if (!alarms[i].callback)
+        {
+            alarms[i] = (host_alarm){callback, user_data, time_us_64() + us};
+            return i + 1; // 0 é reservado (alarme já vencido) no SDK
+        }
+    }
+
+    return -1;
+}
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past)
+{
+    return add_alarm_in_us((uint64_t)ms * 1000u, callback, user_data, fire_if_past);
+}
+
+bool cancel_alarm(alarm_id_t alarm_id)
+{
+    if (alarm_id < 1 || alarm_id > HOST_ALARMS_MAX || !alarms[alarm_id - 1].callback)
+        return false;
+
+    alarms[alarm_id - 1].callback = NULL;
+    return true;
+}
+
+// Dispara os alarmes vencidos; retorna em quantos microssegundos vence o próximo
+uint64_t host_alarm_poll(void)
+{
+    uint64_t next = UINT64_MAX;
+
+    for (int i = 0; i < HOST_ALARMS_MAX; i++)
+    {
+        host_alarm *alarm = &alarms[i];
+
+        if (!alarm->callback)
+            continue;
+
+        uint64_t now = time_us_64();
+
+        if (now >= alarm->due_us)
+        {
+            alarm_callback_t callback = alarm->callback;
+            alarm->callback = NULL;
+
+            // Retorno > 0: reagenda relativo ao prazo anterior; < 0: relativo a agora
+            int64_t again = callback(i + 1, alarm->user_data);
+            if (again != 0 && !alarm->callback)
+            {
+                alarm->callback = callback;
+                alarm->due_us = again > 0 ? alarm->due_us + (uint64_t)again : now + (uint64_t)-again;
+            }
+        }
+
+        if (alarm->callback)
+        {
+            uint64_t left = alarm->due_us > now ? alarm->due_us - now : 0;
+            if (left < next)
+                next = left;
+        }
+    }
+
+    return next;
+}
+
+// Faz o papel das interrupções: entradas, botões, alarmes e rede são atendidos aqui
+void watchdog_enable(uint32_t delay_ms, bool pause_on_debug)
+{
+    (void)pause_on_debug;
+    watchdog_delay_us = (uint64_t)delay_ms * 1000u;
+    watchdog_fed_us = time_us_64();
+}
+
+void watchdog_update(void)
+{
+    watchdog_fed_us = time_us_64();
+}
+
+bool watchdog_caused_reboot(void)
+{
+    return false;
+}
+
+bool watchdog_enable_caused_reboot(void)
+{
+    return false;
+}
+
+// Sem alimentação dentro do prazo o nó seria reiniciado: a simulação termina
+static void watchdog_poll(void)
+{
+    if (watchdog_delay_us && time_us_64() - watchdog_fed_us > watchdog_delay_us)
+    {
+        fprintf(stderr, "[host] watchdog expirou sem alimentação: reset do nó (simulação encerrada)\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void host_poll(uint64_t timeout_us)
+{
+    static bool dispatching = false;
+
+    if (dispatching)
+    {
+        // Chamada reentrante (espera dentro de um callback): apenas aguarda
+        usleep((useconds_t)timeout_us);
+        return;
+    }
+
+    dispatching = true;
+    host_stdin_poll();
+    host_gpio_poll();
+
+    // A espera da rede termina a tempo do próximo alarme
+    uint64_t next_alarm = host_alarm_poll();
+    if (next_alarm < timeout_us)
+        timeout_us = next_alarm;
+
+    host_net_poll((int)((timeout_us + 999) / 1000));
+    host_alarm_poll();
+    watchdog_poll();
+    dispatching = false;
+}
+
+void sleep_us(uint64_t us)
+{
+    uint64_t deadline = time_us_64() + us;
+    uint64_t now;
+
+    while ((now = time_us_64()) < deadline)
+    {
+        host_poll(deadline - now);
+    }
+}
+
+void sleep_ms(uint32_t ms)
+{
+    sleep_us((uint64_t)ms * 1000u);
+}
+
+// Espera em fatias curtas: o stdin não entra no poll() da rede
+bool best_effort_wfe_or_timeout(absolute_time_t timeout_timestamp)
+{
+    uint64_t now = time_us_64();
+
+    if (now >= timeout_timestamp)
+        return true;
+
+    uint64_t wait = timeout_timestamp - now;
+    host_poll(wait < HOST_WFE_SLICE_US ? wait : HOST_WFE_SLICE_US);
+
+    return time_us_64() >= timeout_timestamp;
+}
+
+void busy_wait_us(uint64_t us)
+{
+    uint64_t deadline = time_us_64() + us;
+
+    while (time_us_64() < deadline)
+    {
+    }
+}
+
+bool set_sys_clock_khz(uint32_t freq_khz, bool required)
+{
+    (void)freq_khz;
+    (void)required;
+    return true;
+}
+
+uint32_t clock_get_hz(enum clock_index clk_index)
+{
+    (void)clk_index;
+    return 128000000u;
+}
@@ -0,0 +1,50 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_hal.h"
+
+// O main() do firmware é renomeado para flood_sense_main() na compilação do host
+int flood_sense_main(void);
+
+host_options host_opts = {0};
+
+static void usage(const char *program)
+{
+    fprintf(stderr,
+            "Uso: %s [--port-offset N] [--quiet] [--flash ARQUIVO]\n"
+            "  --port-offset N  soma N a todas as portas (HTTP 80 -> 8080+N)\n"
+            "  --quiet          descarta a saída padrão do firmware\n"
+            "  --flash ARQUIVO  guarda a flash simulada no arquivo (estado persiste entre execuções)\n"
+            "Teclas: a/b/j = botões A/B/joystick, v = mostra OLED e matriz, w = derruba/religa o Wi-Fi;\n"
+            "demais teclas vão para o console do firmware (? lista os comandos)\n",
+            program);
+}
+
+int main(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--port-offset") == 0 && i + 1 < argc)
+        {
+            host_opts.port_offset = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--flash") == 0 && i + 1 < argc)
+        {
+            host_opts.flash_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--quiet") == 0)
+        {
+            host_opts.quiet = true;
+        }
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (host_opts.quiet)
+        freopen("/dev/null", "w", stdout);
+
+    return flood_sense_main();
+}
@@ -0,0 +1,981 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "pico/stdlib.h"
+#include "lwip/tcp.h"
+#include "lwip/udp.h"
+#include "lwip/stats.h"
+#include "host_hal.h"
+
+// Emulação da API "raw" do lwIP sobre sockets não bloqueantes. Cada PCB é
+// uma entrada de pool estático; os callbacks são chamados apenas a partir de
+// host_net_poll(), que faz o papel da IRQ de rede do CYW43.
+
+#define TCP_SLOW_INTERVAL_US 500000 // Período do temporizador lento do TCP (tcp_poll)
+#define TCP_LINGER_US 2000000       // Tempo máximo em FIN_WAIT antes de liberar o PCB
+// TCP_NODELAY do Linux; netinet/tcp.h não é incluído porque redefine TCP_MSS
+#define SOCKET_TCP_NODELAY 1
+#define POLL_FDS_MAX (MEMP_NUM_TCP_PCB + MEMP_NUM_TCP_PCB_LISTEN + MEMP_NUM_UDP_PCB)
+
+const ip_addr_t ip_addr_any = {0x00000000u};
+const ip_addr_t ip_addr_broadcast = {0xffffffffu};
+
+static struct tcp_pcb tcp_pcb_pool[MEMP_NUM_TCP_PCB];
+static struct tcp_pcb tcp_listen_pool[MEMP_NUM_TCP_PCB_LISTEN];
+static struct udp_pcb udp_pcb_pool[MEMP_NUM_UDP_PCB];
+static uint64_t tcp_close_deadline[MEMP_NUM_TCP_PCB];
+static u16_t tcp_acked[MEMP_NUM_TCP_PCB];
+static bool tcp_peer_closed[MEMP_NUM_TCP_PCB];
+static uint64_t next_slow_tick = 0;
+static uint16_t pbuf_pool_used = 0;
+
+// Estatísticas dos pools no mesmo formato do lwIP (MEMP_STATS/MEM_STATS)
+static struct stats_mem memp_stats[MEMP_MAX] = {
+#define LWIP_MEMPOOL(name, num, size, desc) [MEMP_##name] = {.avail = num},
+#include "lwip/priv/memp_std.h"
+};
+
+struct stats_ lwip_stats = {
+    .mem = {.avail = MEM_SIZE},
+    .memp = {
+#define LWIP_MEMPOOL(name, num, size, desc) [MEMP_##name] = &memp_stats[MEMP_##name],
+#include "lwip/priv/memp_std.h"
+    },
+};
+
+static void stats_alloc(struct stats_mem *stats, mem_size_t amount)
+{
+    stats->used += amount;
+    if (stats->used > stats->max)
+        stats->max = stats->used;
+}
+
+static void stats_free(struct stats_mem *stats, mem_size_t amount)
+{
+    stats->used -= amount;
+}
+
+// ---------------------------------------------------------------------------
+// Endereços
+
+char *ipaddr_ntoa_r(const ip_addr_t *addr, char *buf, int buflen)
+{
+    const uint8_t *b = (const uint8_t *)&addr->addr;
+    snprintf(buf, buflen, "%u.%u.%u.%u", b[0], b[1], b[2], b[3]);
+    return buf;
+}
+
+char *ipaddr_ntoa(const ip_addr_t *addr)
+{
+    static char buffer[16];
+    return ipaddr_ntoa_r(addr, buffer, sizeof(buffer));
+}
+
+int ipaddr_aton(const char *cp, ip_addr_t *addr)
+{
+    struct in_addr in;
+
+    if (inet_aton(cp, &in) == 0)
+        return 0;
+
+    if (addr)
+        addr->addr = in.s_addr;
+
+    return 1;
+}
+
+uint16_t host_map_port(uint16_t port)
+{
+    // Portas privilegiadas vão para a faixa 8000+ (ex.: 80 -> 8080)
+    uint32_t mapped = port < 1024 ? port + 8000u : port;
+    return (uint16_t)(mapped + host_opts.port_offset);
+}
+
+static void fill_sockaddr(struct sockaddr_in *sa, const ip_addr_t *ip, uint16_t port)
+{
+    memset(sa, 0, sizeof(*sa));
+    sa->sin_family = AF_INET;
+    sa->sin_port = htons(port);
+    sa->sin_addr.s_addr = ip ? ip->addr : INADDR_ANY;
+
+    // O broadcast global sai pela interface padrão; na simulação usa o do loopback
+    if (sa->sin_addr.s_addr == INADDR_BROADCAST)
+        sa->sin_addr.s_addr = htonl(0x7fffffffu);
+}
+
+static int set_nonblocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+// ---------------------------------------------------------------------------
+// pbuf
+
+struct pbuf *pbuf_alloc(pbuf_layer layer, u16_t length, pbuf_type type)
+{
+    (void)layer;
+
+    if (type == PBUF_POOL && pbuf_pool_used >= PBUF_POOL_SIZE)
+    {
+        memp_stats[MEMP_PBUF_POOL].err++;
+        return NULL;
+    }
+
+    if (type == PBUF_RAM && lwip_stats.mem.used + length > lwip_stats.mem.avail)
+    {
+        lwip_stats.mem.err++;
+        return NULL;
+    }
+
+    struct pbuf *p = malloc(sizeof(struct pbuf) + length);
+
+    if (!p)
+        return NULL;
+
+    p->next = NULL;
+    p->payload = (uint8_t *)(p + 1);
+    p->tot_len = length;
+    p->len = length;
+    p->type_internal = (u8_t)type;
+    p->flags = 0;
+    p->ref = 1;
+    p->alloc_len = length;
+
+    if (type == PBUF_POOL)
+    {
+        pbuf_pool_used++;
+        stats_alloc(&memp_stats[MEMP_PBUF_POOL], 1);
+    }
+    else if (type == PBUF_RAM)
+    {
+        stats_alloc(&lwip_stats.mem, length);
+    }
+
+    return p;
+}
+
+u8_t pbuf_free(struct pbuf *p)
+{
+    u8_t count = 0;
+
+    while (p && --p->ref == 0)
+    {
+        struct pbuf *next = p->next;
+
+        if (p->type_internal == PBUF_POOL)
+        {
+            pbuf_pool_used--;
+            stats_free(&memp_stats[MEMP_PBUF_POOL], 1);
+        }
+        else if (p->type_internal == PBUF_RAM)
+        {
+            stats_free(&lwip_stats.mem, p->alloc_len);
+        }
+
+        free(p);
+        count++;
+        p = next;
+    }
+
+    return count;
+}
+
+void pbuf_cat(struct pbuf *head, struct pbuf *tail)
+{
+    struct pbuf *p = head;
+
+    while (p->next)
+    {
+        p->tot_len += tail->tot_len;
+        p = p->next;
+    }
+
+    p->tot_len += tail->tot_len;
+    p->next = tail;
+}
+
+err_t pbuf_take(struct pbuf *buf, const void *dataptr, u16_t len)
+{
+    const uint8_t *src = dataptr;
+
+    if (!buf || buf->tot_len < len)
+        return ERR_ARG;
+
+    for (struct pbuf *p = buf; p && len > 0; p = p->next)
+    {
+        u16_t n = len < p->len ? len : p->len;
+        memcpy(p->payload, src, n);
+        src += n;
+        len -= n;
+    }
+
+    return ERR_OK;
+}
+
+u16_t pbuf_copy_partial(const struct pbuf *p, void *dataptr, u16_t len, u16_t offset)
+{
+    uint8_t *dst = dataptr;
+    u16_t copied = 0;
+
+    for (; p && copied < len; p = p->next)
+    {
+        if (offset >= p->len)
+        {
+            offset -= p->len;
+            continue;
+        }
+
+        u16_t n = p->len - offset;
+        if (n > len - copied)
+            n = len - copied;
+
+        memcpy(dst + copied, (const uint8_t *)p->payload + offset, n);
+        copied += n;
+        offset = 0;
+    }
+
+    return copied;
+}
+
+// ---------------------------------------------------------------------------
+// TCP
+
+static int tcp_slot(const struct tcp_pcb *pcb)
+{
+    return (int)(pcb - tcp_pcb_pool);
+}
+
+static bool tcp_is_active(const struct tcp_pcb *pcb)
+{
+    return pcb >= tcp_pcb_pool && pcb < tcp_pcb_pool + MEMP_NUM_TCP_PCB;
+}
+
+static void tcp_reset_pcb(struct tcp_pcb *pcb)
+{
+    memset(pcb, 0, sizeof(*pcb));
+    pcb->fd = -1;
+    pcb->prio = TCP_PRIO_NORMAL;
+    pcb->snd_buf = TCP_SND_BUF;
+}
+
+static struct tcp_pcb *tcp_alloc_from(struct tcp_pcb *pool, int count, memp_t type)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (!pool[i].in_use)
+        {
+            tcp_reset_pcb(&pool[i]);
+            pool[i].in_use = true;
+            stats_alloc(&memp_stats[type], 1);
+            return &pool[i];
+        }
+    }
+
+    memp_stats[type].err++;
+    return NULL;
+}
+
+static void tcp_free(struct tcp_pcb *pcb)
+{
+    if (pcb->fd >= 0)
+        close(pcb->fd);
+
+    if (pcb->refused_data)
+        pbuf_free(pcb->refused_data);
+
+    if (pcb->in_use)
+        stats_free(&memp_stats[tcp_is_active(pcb) ? MEMP_TCP_PCB : MEMP_TCP_PCB_LISTEN], 1);
+
+    tcp_reset_pcb(pcb);
+}
+
+struct tcp_pcb *tcp_new(void)
+{
+    return tcp_alloc_from(tcp_pcb_pool, MEMP_NUM_TCP_PCB, MEMP_TCP_PCB);
+}
+
+struct tcp_pcb *tcp_new_ip_type(u8_t type)
+{
+    (void)type;
+    return tcp_new();
+}
+
+err_t tcp_bind(struct tcp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
+{
+    struct sockaddr_in sa;
+    int one = 1;
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+
+    if (fd < 0)
+        return ERR_MEM;
+
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    fill_sockaddr(&sa, ipaddr, host_map_port(port));
+
+    if (bind(fd, (struct sockaddr *)&sa, sizeof(sa)) != 0)
+    {
+        close(fd);
+        return ERR_USE;
+    }
+
+    set_nonblocking(fd);
+    pcb->fd = fd;
+    pcb->local_port = port;
+    pcb->local_ip = ipaddr ? *ipaddr : ip_addr_any;
+    return ERR_OK;
+}
+
+struct tcp_pcb *tcp_listen_with_backlog(struct tcp_pcb *pcb, u8_t backlog)
+{
+    if (pcb->fd < 0 || listen(pcb->fd, backlog) != 0)
+        return NULL;
+
+    // Como no lwIP, o PCB de escuta vem de outro pool e o original é liberado
+    struct tcp_pcb *lpcb = tcp_alloc_from(tcp_listen_pool, MEMP_NUM_TCP_PCB_LISTEN, MEMP_TCP_PCB_LISTEN);
+
+    if (!lpcb)
+        return NULL;
+
+    lpcb->fd = pcb->fd;
+    lpcb->local_ip = pcb->local_ip;
+    lpcb->local_port = pcb->local_port;
+    lpcb->callback_arg = pcb->callback_arg;
+    lpcb->state = LISTEN;
+    lpcb->listening = true;
+
+    pcb->fd = -1;
+    tcp_free(pcb);
+    return lpcb;
+}
+
+err_t tcp_connect(struct tcp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port, tcp_connected_fn connected)
+{
+    struct sockaddr_in sa;
+
+    if (pcb->fd < 0)
+    {
+        pcb->fd = socket(AF_INET, SOCK_STREAM, 0);
+
+        if (pcb->fd < 0)
+            return ERR_MEM;
+
+        set_nonblocking(pcb->fd);
+    }
+
+    fill_sockaddr(&sa, ipaddr, port);
+    pcb->remote_ip = *ipaddr;
+    pcb->remote_port = port;
+    pcb->connected = connected;
+
+    if (connect(pcb->fd, (struct sockaddr *)&sa, sizeof(sa)) != 0 && errno != EINPROGRESS)
+        return ERR_RTE;
+
+    pcb->state = SYN_SENT;
+    return ERR_OK;
+}
+
+void tcp_arg(struct tcp_pcb *pcb, void *arg)
+{
+    pcb->callback_arg = arg;
+}
+
+void tcp_accept(struct tcp_pcb *pcb, tcp_accept_fn accept)
+{
+    pcb->accept = accept;
+}
+
+void tcp_recv(struct tcp_pcb *pcb, tcp_recv_fn recv)
+{
+    pcb->recv = recv;
+}
+
+void tcp_sent(struct tcp_pcb *pcb, tcp_sent_fn sent)
+{
+    pcb->sent = sent;
+}
+
+void tcp_poll(struct tcp_pcb *pcb, tcp_poll_fn poll, u8_t interval)
+{
+    pcb->poll = poll;
+    pcb->pollinterval = interval;
+}
+
+void tcp_err(struct tcp_pcb *pcb, tcp_err_fn err)
+{
+    pcb->errf = err;
+}
+
+void tcp_setprio(struct tcp_pcb *pcb, u8_t prio)
+{
+    pcb->prio = prio;
+}
+
+void tcp_recved(struct tcp_pcb *pcb, u16_t len)
+{
+    (void)pcb;
+    (void)len;
+}
+
+// Os dados são sempre copiados; TCP_WRITE_FLAG_COPY não muda nada no host
+err_t tcp_write(struct tcp_pcb *pcb, const void *dataptr, u16_t len, u8_t apiflags)
+{
+    (void)apiflags;
+
+    if (pcb->state != ESTABLISHED)
+        return ERR_CONN;
+
+    u16_t segments = (u16_t)((len + TCP_MSS - 1) / TCP_MSS);
+
+    if (len > pcb->snd_buf || pcb->snd_queuelen + segments > TCP_SND_QUEUELEN)
+        return ERR_MEM;
+
+    memcpy(pcb->out + pcb->out_len, dataptr, len);
+    pcb->out_len += len;
+    pcb->snd_buf -= len;
+    pcb->snd_queuelen += segments;
+    return ERR_OK;
+}
+
+// Falha de socket: avisa a aplicação com err e libera o PCB, como o lwIP faz após um RST
+static void tcp_fail(struct tcp_pcb *pcb, err_t err)
+{
+    tcp_err_fn errf = pcb->errf;
+    void *arg = pcb->callback_arg;
+    bool notify = pcb->state != CLOSING;
+
+    tcp_free(pcb);
+
+    if (notify && errf)
+        errf(arg, err);
+}
+
+static void tcp_flush(struct tcp_pcb *pcb)
+{
+    if (pcb->out_len == 0 || pcb->fd < 0)
+        return;
+
+    ssize_t n = send(pcb->fd, pcb->out, pcb->out_len, MSG_NOSIGNAL | MSG_DONTWAIT);
+
+    if (n > 0)
+    {
+        memmove(pcb->out, pcb->out + n, pcb->out_len - (size_t)n);
+        pcb->out_len -= (u16_t)n;
+        pcb->snd_buf += (u16_t)n;
+        pcb->snd_queuelen = (u16_t)((pcb->out_len + TCP_MSS - 1) / TCP_MSS);
+        tcp_acked[tcp_slot(pcb)] += (u16_t)n;
+    }
+    else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+    {
+        tcp_fail(pcb, ERR_RST);
+    }
+}
+
+err_t tcp_output(struct tcp_pcb *pcb)
+{
+    if (tcp_is_active(pcb) && pcb->state == ESTABLISHED)
+        tcp_flush(pcb);
+
+    return ERR_OK;
+}
+
+err_t tcp_close(struct tcp_pcb *pcb)
+{
+    if (pcb->listening)
+    {
+        tcp_free(pcb);
+        return ERR_OK;
+    }
+
+    if (pcb->state != ESTABLISHED)
+    {
+        tcp_free(pcb);
+        return ERR_OK;
+    }
+
+    // Mantém o PCB ocupado até esvaziar o buffer de envio (FIN_WAIT)
+    pcb->state = CLOSING;
+    tcp_close_deadline[tcp_slot(pcb)] = time_us_64() + TCP_LINGER_US;
+    return ERR_OK;
+}
+
+void tcp_abort(struct tcp_pcb *pcb)
+{
+    struct linger lin = {.l_onoff = 1, .l_linger = 0};
+
+    if (pcb->fd >= 0)
+        setsockopt(pcb->fd, SOL_SOCKET, SO_LINGER, &lin, sizeof(lin));
+
+    tcp_fail(pcb, ERR_ABRT);
+}
+
+// Sem PCB livre o lwIP derruba a conexão estabelecida de menor prioridade,
+// abaixo da prioridade prio do listener, para admitir a nova (tcp_kill_prio)
+static void tcp_kill_prio(u8_t prio)
+{
+    struct tcp_pcb *victim = NULL;
+
+    for (int i = 0; i < MEMP_NUM_TCP_PCB; i++)
+    {
+        struct tcp_pcb *pcb = &tcp_pcb_pool[i];
+
+        if (pcb->in_use && pcb->state == ESTABLISHED && pcb->prio < prio && (!victim || pcb->prio < victim->prio))
+            victim = pcb;
+    }
+
+    if (victim)
+        tcp_abort(victim);
+}
+
+static void tcp_accept_pending(struct tcp_pcb *lpcb)
+{
+    struct sockaddr_in sa;
+    socklen_t sa_len = sizeof(sa);
+    struct tcp_pcb *npcb = tcp_new();
+
+    if (!npcb)
+    {
+        tcp_kill_prio(lpcb->prio);
+        npcb = tcp_new();
+    }
+
+    // Sem PCB livre a conexão fica na fila do kernel, como um SYN descartado
+    if (!npcb)
+        return;
+
+    int fd = accept(lpcb->fd, (struct sockaddr *)&sa, &sa_len);
+
+    if (fd < 0)
+    {
+        tcp_free(npcb);
+        return;
+    }
+
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, SOCKET_TCP_NODELAY, &one, sizeof(one));
+    set_nonblocking(fd);
+
+    npcb->fd = fd;
+    npcb->state = ESTABLISHED;
+    npcb->local_port = lpcb->local_port;
+    npcb->remote_ip.addr = sa.sin_addr.s_addr;
+    npcb->remote_port = ntohs(sa.sin_port);
+    npcb->callback_arg = lpcb->callback_arg;
+    npcb->prio = lpcb->prio;
+    tcp_acked[tcp_slot(npcb)] = 0;
+    tcp_peer_closed[tcp_slot(npcb)] = false;
+
+    err_t err = lpcb->accept ? lpcb->accept(lpcb->callback_arg, npcb, ERR_OK) : ERR_ARG;
+
+    if (err != ERR_OK && err != ERR_ABRT && npcb->in_use)
+        tcp_abort(npcb);
+}
+
+// Entrega dados à aplicação; recusados (retorno != ERR_OK) são reentregues depois
+static void tcp_deliver(struct tcp_pcb *pcb, struct pbuf *p)
+{
+    err_t err;
+
+    if (pcb->recv)
+    {
+        err = pcb->recv(pcb->callback_arg, pcb, p, ERR_OK);
+    }
+    else
+    {
+        // Equivalente ao tcp_recv_null do lwIP
+        if (p)
+            pbuf_free(p);
+        else
+            tcp_close(pcb);
+        err = ERR_OK;
+    }
+
+    if (err != ERR_OK && err != ERR_ABRT && pcb->in_use && p)
+        pcb->refused_data = p;
+}
+
+static void tcp_receive(struct tcp_pcb *pcb)
+{
+    struct pbuf *p = pbuf_alloc(PBUF_RAW, TCP_MSS, PBUF_POOL);
+
+    // Pool de pbufs esgotado: os dados ficam no socket até haver espaço
+    if (!p)
+        return;
+
+    ssize_t n = recv(pcb->fd, p->payload, TCP_MSS, 0);
+
+    if (n > 0)
+    {
+        p->len = p->tot_len = (u16_t)n;
+        tcp_deliver(pcb, p);
+        return;
+    }
+
+    pbuf_free(p);
+
+    if (n == 0)
+    {
+        tcp_peer_closed[tcp_slot(pcb)] = true;
+        tcp_deliver(pcb, NULL);
+    }
+    else if (errno != EAGAIN && errno != EWOULDBLOCK)
+    {
+        tcp_fail(pcb, ERR_RST);
+    }
+}
+
+static void tcp_finish_connect(struct tcp_pcb *pcb)
+{
+    int so_error = 0;
+    socklen_t len = sizeof(so_error);
+
+    getsockopt(pcb->fd, SOL_SOCKET, SO_ERROR, &so_error, &len);
+
+    if (so_error != 0)
+    {
+        tcp_fail(pcb, ERR_RST);
+        return;
+    }
+
+    pcb->state = ESTABLISHED;
+    tcp_acked[tcp_slot(pcb)] = 0;
+    tcp_peer_closed[tcp_slot(pcb)] = false;
+
+    if (pcb->connected)
+    {
+        err_t err = pcb->connected(pcb->callback_arg, pcb, ERR_OK);
+
+        if (err != ERR_OK && err != ERR_ABRT && pcb->in_use)
+            tcp_abort(pcb);
+    }
+}
+
+// Conclui o fechamento: envia o restante, FIN e descarta o que o cliente ainda mandar
+static void tcp_progress_close(struct tcp_pcb *pcb)
+{
+    int slot = tcp_slot(pcb);
+    char discard[256];
+
+    if (pcb->out_len > 0)
+    {
+        ssize_t n = send(pcb->fd, pcb->out, pcb->out_len, MSG_NOSIGNAL | MSG_DONTWAIT);
+
+        if (n > 0)
+        {
+            memmove(pcb->out, pcb->out + n, pcb->out_len - (size_t)n);
+            pcb->out_len -= (u16_t)n;
+        }
+        else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            tcp_free(pcb);
+            return;
+        }
+    }
+
+    if (pcb->out_len == 0 && !pcb->fin_sent)
+    {
+        shutdown(pcb->fd, SHUT_WR);
+        pcb->fin_sent = true;
+    }
+
+    while (recv(pcb->fd, discard, sizeof(discard), MSG_DONTWAIT) > 0)
+    {
+    }
+
+    bool peer_done = pcb->fin_sent && recv(pcb->fd, discard, sizeof(discard), MSG_DONTWAIT | MSG_PEEK) == 0;
+
+    if (peer_done || time_us_64() >= tcp_close_deadline[slot])
+        tcp_free(pcb);
+}
+
+static void tcp_slow_tick(void)
+{
+    for (int i = 0; i < MEMP_NUM_TCP_PCB; i++)
+    {
+        struct tcp_pcb *pcb = &tcp_pcb_pool[i];
+
+        if (!pcb->in_use || pcb->state != ESTABLISHED || !pcb->poll || pcb->pollinterval == 0)
+            continue;
+
+        if (++pcb->poll_tick >= pcb->pollinterval)
+        {
+            pcb->poll_tick = 0;
+            pcb->poll(pcb->callback_arg, pcb);
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// UDP
+
+struct udp_pcb *udp_new(void)
+{
+    for (int i = 0; i < MEMP_NUM_UDP_PCB; i++)
+    {
+        struct udp_pcb *pcb = &udp_pcb_pool[i];
+
+        if (pcb->in_use)
+            continue;
+
+        int one = 1;
+        int fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+        if (fd < 0)
+            return NULL;
+
+        setsockopt(fd, SOL_SOCKET, SO_BROADCAST, &one, sizeof(one));
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        set_nonblocking(fd);
+
+        memset(pcb, 0, sizeof(*pcb));
+        pcb->fd = fd;
+        pcb->in_use = true;
+        stats_alloc(&memp_stats[MEMP_UDP_PCB], 1);
+        return pcb;
+    }
+
+    memp_stats[MEMP_UDP_PCB].err++;
+    return NULL;
+}
+
+struct udp_pcb *udp_new_ip_type(u8_t type)
+{
+    (void)type;
+    return udp_new();
+}
+
+err_t udp_bind(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
+{
+    struct sockaddr_in sa;
+
+    fill_sockaddr(&sa, ipaddr, host_map_port(port));
+
+    if (bind(pcb->fd, (struct sockaddr *)&sa, sizeof(sa)) != 0)
+        return ERR_USE;
+
+    pcb->local_ip = ipaddr ? *ipaddr : ip_addr_any;
+    pcb->local_port = port;
+    return ERR_OK;
+}
+
+void udp_recv(struct udp_pcb *pcb, udp_recv_fn recv, void *recv_arg)
+{
+    pcb->recv = recv;
+    pcb->recv_arg = recv_arg;
+}
+
+err_t udp_sendto(struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *dst_ip, u16_t dst_port)
+{
+    uint8_t buffer[PBUF_POOL_BUFSIZE * 2];
+    struct sockaddr_in sa;
+
+    if (p->tot_len > sizeof(buffer))
+        return ERR_MEM;
+
+    u16_t len = pbuf_copy_partial(p, buffer, p->tot_len, 0);
+    fill_sockaddr(&sa, dst_ip, dst_port);
+
+    if (sendto(pcb->fd, buffer, len, 0, (struct sockaddr *)&sa, sizeof(sa)) < 0)
+        return ERR_RTE;
+
+    return ERR_OK;
+}
+
+void udp_remove(struct udp_pcb *pcb)
+{
+    if (pcb->in_use)
+        stats_free(&memp_stats[MEMP_UDP_PCB], 1);
+
+    close(pcb->fd);
+    memset(pcb, 0, sizeof(*pcb));
+    pcb->fd = -1;
+}
+
+static void udp_receive(struct udp_pcb *pcb)
+{
+    struct sockaddr_in sa;
+    socklen_t sa_len = sizeof(sa);
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, PBUF_POOL_BUFSIZE, PBUF_POOL);
+
+    if (!p)
+        return;
+
+    ssize_t n = recvfrom(pcb->fd, p->payload, PBUF_POOL_BUFSIZE, 0, (struct sockaddr *)&sa, &sa_len);
+
+    if (n < 0 || !pcb->recv)
+    {
+        pbuf_free(p);
+        return;
+    }
+
+    ip_addr_t addr = {.addr = sa.sin_addr.s_addr};
+    p->len = p->tot_len = (u16_t)n;
+    pcb->recv(pcb->recv_arg, pcb, p, &addr, ntohs(sa.sin_port));
+}
+
+// ---------------------------------------------------------------------------
+// Laço de eventos
+
+void host_net_poll(int timeout_ms)
+{
+    struct pollfd fds[POLL_FDS_MAX];
+    void *owners[POLL_FDS_MAX];
+    int kinds[POLL_FDS_MAX]; // 0 = escuta, 1 = conexão, 2 = UDP
+    int nfds = 0;
+    bool tcp_pool_full = true;
+    u8_t lowest_prio = TCP_PRIO_MAX; // Menor prioridade estabelecida (candidata do tcp_kill_prio)
+
+    for (int i = 0; i < MEMP_NUM_TCP_PCB; i++)
+    {
+        struct tcp_pcb *pcb = &tcp_pcb_pool[i];
+
+        if (!pcb->in_use)
+        {
+            tcp_pool_full = false;
+            continue;
+        }
+
+        if (pcb->state == ESTABLISHED && pcb->prio < lowest_prio)
+            lowest_prio = pcb->prio;
+
+        if (pcb->fd < 0)
+            continue;
+
+        short events = 0;
+
+        if (pcb->state == SYN_SENT || pcb->out_len > 0)
+            events |= POLLOUT;
+
+        if ((pcb->state == ESTABLISHED && !pcb->refused_data && !tcp_peer_closed[i] && pbuf_pool_used < PBUF_POOL_SIZE) ||
+            pcb->state == CLOSING)
+            events |= POLLIN;
+
+        fds[nfds] = (struct pollfd){.fd = pcb->fd, .events = events};
+        owners[nfds] = pcb;
+        kinds[nfds++] = 1;
+    }
+
+    for (int i = 0; i < MEMP_NUM_TCP_PCB_LISTEN; i++)
+    {
+        // Com o pool cheio, o listener só é atendido se houver conexão para derrubar
+        if (tcp_listen_pool[i].in_use && (!tcp_pool_full || lowest_prio < tcp_listen_pool[i].prio))
+        {
+            fds[nfds] = (struct pollfd){.fd = tcp_listen_pool[i].fd, .events = POLLIN};
+            owners[nfds] = &tcp_listen_pool[i];
+            kinds[nfds++] = 0;
+        }
+    }
+
+    for (int i = 0; i < MEMP_NUM_UDP_PCB; i++)
+    {
+        if (udp_pcb_pool[i].in_use)
+        {
+            fds[nfds] = (struct pollfd){.fd = udp_pcb_pool[i].fd, .events = POLLIN};
+            owners[nfds] = &udp_pcb_pool[i];
+            kinds[nfds++] = 2;
+        }
+    }
+
+    // Dados recusados ou PCBs fechando precisam de atenção mesmo sem eventos
+    for (int i = 0; i < MEMP_NUM_TCP_PCB; i++)
+    {
+        if (tcp_pcb_pool[i].in_use && (tcp_pcb_pool[i].refused_data || tcp_pcb_pool[i].state == CLOSING))
+            timeout_ms = timeout_ms > 10 ? 10 : timeout_ms;
+    }
+
+    uint64_t now = time_us_64();
+    if (next_slow_tick == 0)
+        next_slow_tick = now + TCP_SLOW_INTERVAL_US;
+    if (next_slow_tick > now && (next_slow_tick - now) / 1000 < (uint64_t)timeout_ms)
+        timeout_ms = (int)((next_slow_tick - now) / 1000);
+
+    int ready = poll(fds, (nfds_t)nfds, timeout_ms);
+
+    for (int i = 0; i < nfds && ready > 0; i++)
+    {
+        if (fds[i].revents == 0)
+            continue;
+
+        if (kinds[i] == 0)
+        {
+            struct tcp_pcb *lpcb = owners[i];
+            if (lpcb->in_use && lpcb->fd == fds[i].fd)
+                tcp_accept_pending(lpcb);
+        }
+        else if (kinds[i] == 2)
+        {
+            struct udp_pcb *upcb = owners[i];
+            if (upcb->in_use && upcb->fd == fds[i].fd)
+                udp_receive(upcb);
+        }
+        else
+        {
+            struct tcp_pcb *pcb = owners[i];
+
+            // O PCB pode ter sido liberado (e reutilizado) por um callback anterior
+            if (!pcb->in_use || pcb->fd != fds[i].fd)
+                continue;
+
+            if (pcb->state == SYN_SENT)
+            {
+                tcp_finish_connect(pcb);
+                continue;
+            }
+
+            if (pcb->state == CLOSING)
+                continue;
+
+            if (fds[i].revents & POLLOUT)
+                tcp_flush(pcb);
+
+            if (pcb->in_use && pcb->state == ESTABLISHED && (fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+                tcp_receive(pcb);
+        }
+    }
+
+    for (int i = 0; i < MEMP_NUM_TCP_PCB; i++)
+    {
+        struct tcp_pcb *pcb = &tcp_pcb_pool[i];
+
+        if (!pcb->in_use)
+            continue;
+
+        if (pcb->state == CLOSING)
+        {
+            tcp_progress_close(pcb);
+            continue;
+        }
+
+        if (pcb->state != ESTABLISHED)
+            continue;
+
+        if (pcb->refused_data)
+        {
+            struct pbuf *p = pcb->refused_data;
+            pcb->refused_data = NULL;
+            tcp_deliver(pcb, p);
+        }
+
+        if (pcb->in_use && tcp_acked[i] > 0)
+        {
+            u16_t acked = tcp_acked[i];
+            tcp_acked[i] = 0;
+
+            if (pcb->sent)
+                pcb->sent(pcb->callback_arg, pcb, acked);
+        }
+    }
+
+    if (time_us_64() >= next_slow_tick)
+    {
+        next_slow_tick = time_us_64() + TCP_SLOW_INTERVAL_US;
+        tcp_slow_tick();
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef ACCEL_H
+#define ACCEL_H
+
+#include "General.h" // Biblioteca geral do sistema
+
+#if PICO_ON_DEVICE
+#include "hardware/divider.h" // Divisor do SIO
+#endif
+
+// Núcleos de cálculo das rotinas quentes do display, da matriz e do gráfico,
+// com os aceleradores do SIO do RP2040: o divisor por hardware e o
+// interpolador 0 como gerador de endereços. Na simulação em Linux
+// (PICO_ON_DEVICE 0) cada núcleo tem uma versão portátil com o mesmo
+// resultado. O estado do divisor e do interpolador não é salvo: os núcleos
+// com "laço principal" no comentário não podem ser chamados de IRQs nem de
+// callbacks do lwIP (que no firmware rodam em IRQ). Nesses contextos o '/'
+// do C já usa o divisor com o estado salvo pelo SDK.
+
+// Recíproca em Q24 de num / den para escalar várias amostras sem dividir
+typedef struct
+{
+    uint32_t factor;
+} accel_scale;
+
+// Quociente sem sinal pelo divisor do SIO, sem chamada nem salvamento de estado (laço principal)
+static inline uint32_t accel_div_u32(uint32_t dividend, uint32_t divisor)
+{
+#if PICO_ON_DEVICE
+    return hw_divider_u32_quotient_inlined(dividend, divisor);
+#else
+    return dividend / divisor;
+#endif
+}
+
+// Prepara a escala x * num / den (num < 256, den > 0); a única divisão fica aqui
+static inline accel_scale accel_scale_init(uint32_t num, uint32_t den)
+{
+    return (accel_scale){((num << 24) + den - 1) / den};
+}
+
+// x * num / den arredondado para baixo; exato enquanto x * den < 2^24 e o resultado < 256
+static inline uint32_t accel_scale_apply(accel_scale scale, uint32_t x)
+{
+    return (x * scale.factor) >> 24;
+}
+
+// Copia colunas de 8 pixels (bit 0 em cima) para um framebuffer em
+// endereçamento vertical (pages bytes por coluna), a partir de (x, y)
+// qualquer; o que passa da borda é cortado (laço principal)
+void accel_blit_columns(uint8_t *frame, uint width, uint pages, const uint8_t *columns, uint count, uint x, uint y);
+
+// Função para medir os núcleos contra as versões de referência (ciclos por chamada no console)
+void accel_bench();
+
+#endif
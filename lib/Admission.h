@@ -0,0 +1,62 @@
+#ifndef ADMISSION_H
+#define ADMISSION_H
+
+#include "General.h" // Biblioteca geral do sistema
+
+// Controle de admissão do servidor HTTP. São só MEMP_NUM_TCP_PCB conexões, e
+// uma rajada de recarregamentos (cada aba abre conexões em paralelo) as
+// esgotava: o nó parava de responder a todos, inclusive ao operador com o
+// formulário aberto. Agora:
+// - no accept, cada IP tem no máximo HTTP_MAX_PER_CLIENT conexões. A conexão
+//   nova fica com prioridade mínima até mandar o request, então o lwIP a
+//   derruba (tcp_kill_prio) para admitir outra quando faltam PCBs;
+// - no request, comandos (formulário e POST /api/actuators) e APIs
+//   (/metrics, /api/fleet, /api/postmortem) sempre passam e sobem para a
+//   prioridade máxima. A página só passa se sobrarem HTTP_RESERVED_SLOTS
+//   PCBs TCP livres para eles, contados no pool do lwIP, que também guarda os
+//   clientes MQTT e webhook e os PCBs em TIME_WAIT. Quando precisa ser renderizada (cache desatualizado), ela também
+//   gasta uma ficha de um balde com HTTP_PAGE_RATE fichas por segundo e
+//   rajada de HTTP_PAGE_BURST.
+// Quem não passa recebe na hora um 503 curto com Retry-After. Atendidos e
+// recusados são contados nas métricas.
+//
+// Uso restrito ao contexto do lwIP (callbacks ou laço com o lock do lwIP).
+
+#ifndef HTTP_MAX_PER_CLIENT
+#define HTTP_MAX_PER_CLIENT 2 // Conexões simultâneas por IP
+#endif
+
+#ifndef HTTP_RESERVED_SLOTS
+#define HTTP_RESERVED_SLOTS 1 // Conexões que a página deixa livres para comandos e APIs
+#endif
+
+#ifndef HTTP_PAGE_RATE
+#define HTTP_PAGE_RATE 2 // Renderizações da página por segundo (reposição do balde)
+#endif
+
+#ifndef HTTP_PAGE_BURST
+#define HTTP_PAGE_BURST 4 // Capacidade do balde de renderizações
+#endif
+
+// Classe de rota, da mais para a menos prioritária
+typedef enum
+{
+    HTTP_ROUTE_CONTROL = 0, // Comandos dos atuadores
+    HTTP_ROUTE_API,         // /metrics, /api/fleet e /api/postmortem
+    HTTP_ROUTE_PAGE,        // Página principal
+    HTTP_ROUTE_COUNT
+} http_route;
+
+// Classifica o request pela linha inicial
+http_route admission_route(const char *request);
+
+// Decide a admissão de uma conexão nova; from_client = conexões já abertas pelo mesmo IP
+bool admission_accept(bool slot_free, uint from_client);
+
+// Decide o request; render = a página precisa ser gerada. Retorna 0 se admitido, senão os segundos do Retry-After
+uint32_t admission_request(http_route route, bool render);
+
+// Conexão ociosa (sem request) derrubada pelo lwIP para admitir outra
+void admission_evicted();
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef BOOT_H
+#define BOOT_H
+
+#include "General.h" // Biblioteca geral do sistema
+
+// Linha do tempo do boot. Cada etapa registra início e fim em microssegundos
+// desde o reset (time_us_32); só a primeira execução de cada etapa conta, então
+// quedas e religamentos do Wi-Fi não alteram o registro. As etapas do núcleo 1
+// (display) escrevem palavras de 32 bits próprias e dispensam trava.
+
+typedef enum
+{
+    BOOT_STAGE_RUNTIME = 0, // Reset até o main (bootrom, crt0 e runtime do SDK)
+    BOOT_STAGE_CLOCKS,      // Relógio do sistema e stdio
+    BOOT_STAGE_CONFIG,      // Estado das regiões restaurado da flash
+    BOOT_STAGE_INPUTS,      // Botões e IRQs
+    BOOT_STAGE_OUTPUTS,     // LED, buzzer e matriz; ao fim os alarmes estão ativos
+    BOOT_STAGE_DISPLAY,     // OLED (núcleo 1, em paralelo com a rede)
+    BOOT_STAGE_WIFI_STACK,  // cyw43_arch_init e lwIP
+    BOOT_STAGE_WIFI_LINK,   // Associação e DHCP
+    BOOT_STAGE_HTTP,        // Servidor HTTP aceitando conexões
+    BOOT_STAGE_COUNT
+} boot_stage;
+
+// Marca o início de uma etapa (ignorado se ela já começou)
+void boot_stage_begin(boot_stage stage);
+
+// Marca o fim de uma etapa (ignorado se ela já terminou)
+void boot_stage_end(boot_stage stage);
+
+// true se a etapa já terminou
+bool boot_stage_done(boot_stage stage);
+
+// Início e duração da etapa em microssegundos; false se ela ainda não terminou
+bool boot_stage_time(boot_stage stage, uint32_t *start_us, uint32_t *duration_us);
+
+// Nome da etapa (rótulo "stage" do /metrics)
+const char *boot_stage_name(boot_stage stage);
+
+// Função para imprimir a linha do tempo do boot no console
+void boot_report();
+
+#endif
@@ -9,8 +9,27 @@
 #define BUTTON_B 6  // Botão B
 #define BUTTON_J 22  // Botão Joystick
 #define DEBOUNCE_DELAY 300000 // Tempo de debounce em microssegundos
+#define BUTTON_QUEUE_SIZE 16 // Eventos pendentes entre a IRQ e o laço principal (potência de 2)
+
+// A IRQ de GPIO apenas registra a borda em uma fila sem travas (um produtor,
+// a IRQ; um consumidor, o laço principal) e desliga a IRQ do pino; um alarme
+// do timer de hardware a religa após DEBOUNCE_DELAY, descartando os repiques.
+
+// Borda registrada pela IRQ
+typedef struct
+{
+    uint8_t gpio;
+    uint8_t edge;     // GPIO_IRQ_EDGE_FALL ou GPIO_IRQ_EDGE_RISE
+    uint64_t time_us; // Instante da borda (time_us_64)
+} button_event;
 
 // Função para configurar os botões
 void configure_button(uint8_t button);
 
-#endif
\ No newline at end of file
+// Função para habilitar a IRQ de borda de descida do botão, com debounce por alarme
+void button_enable_irq(uint8_t button);
+
+// Retira o evento mais antigo da fila (chamar no laço principal); false se vazia
+bool button_pop(button_event *event);
+
+#endif
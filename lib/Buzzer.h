@@ -7,6 +7,7 @@
 // Definição do pino e valor de PWM para o buzzer
 #define BUZZER_A 21          // Pino do buzzer
 #define WRAP_PWM_BUZZER 30000 // Valor de wrap para PWM do buzzer
+#define BUZZER_BEEP_MS 100    // Duração de cada bipe e de cada pausa do alerta
 
 // Função para configurar o buzzer
 void configure_buzzer();
@@ -14,7 +15,7 @@ void configure_buzzer();
 // Função para definir o nível do buzzer (intensidade do som)
 void set_buzzer_level(uint gpio, uint16_t level);
 
-// Função para emitir um alerta sonoro (beep)
-void beep_alert(); 
+// Função para avançar o alerta sonoro sem bloquear; retorna o prazo da próxima troca
+absolute_time_t buzzer_alert_poll(bool active);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "General.h" // Biblioteca geral do sistema
+
+// Cache de corpos de resposta renderizados. Cada entrada guarda o corpo gerado
+// por uma função de renderização para uma versão do estado; enquanto a versão
+// não muda, os clientes recebem os mesmos bytes, enviados por referência
+// (tcp_write sem cópia). A entrada só é regenerada na primeira leitura depois
+// de uma mudança de versão, e nunca enquanto algum envio ainda a referencia:
+// o leitor segura a entrada até o cliente confirmar todos os bytes.
+//
+// Uso restrito ao contexto do lwIP (callbacks ou laço com o lock do lwIP).
+
+#define CACHE_SLOTS 2          // Versões mantidas ao mesmo tempo
+#define CACHE_BODY_SIZE 8192   // Maior corpo que cabe em uma entrada
+
+// Gera o corpo em buffer; retorna o tamanho ou 0 se não couber
+typedef uint16_t (*cache_render_fn)(char *buffer, uint16_t size);
+
+typedef struct
+{
+    cache_render_fn render; // NULL: entrada vazia
+    uint64_t version;
+    uint8_t readers;        // Envios em andamento que referenciam body
+    uint16_t len;
+    char body[CACHE_BODY_SIZE];
+} cache_entry;
+
+// Entrada com o corpo de render para version (renderizado agora se preciso); NULL se não houver entrada livre ou o corpo não couber
+const cache_entry *cache_acquire(cache_render_fn render, uint64_t version);
+
+// Devolve uma entrada obtida com cache_acquire()
+void cache_release(const cache_entry *entry);
+
+// true se cache_acquire(render, version) sairia sem renderizar
+bool cache_fresh(cache_render_fn render, uint64_t version);
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef CHART_H
+#define CHART_H
+
+#include "General.h"  // Biblioteca geral do sistema
+#include "Region.h"   // Limiares das regiões
+#include "Template.h" // Writer do template
+
+// Gráfico do histórico de níveis em SVG inline, gerado no próprio nó (sem
+// bibliotecas externas no navegador). As coordenadas são inteiras, em uma
+// grade de CHART_WIDTH x CHART_HEIGHT unidades que o CSS estica para o tamanho
+// da caixa; históricos com mais amostras que colunas são reduzidos a uma
+// coluna por unidade (o máximo de cada coluna, para não esconder picos), então
+// o SVG tem tamanho limitado e cabe em um slot do template.
+
+#define CHART_WIDTH 60  // Colunas da grade (pontos no máximo)
+#define CHART_HEIGHT 40 // Linhas da grade
+
+// Escreve o SVG do histórico (até 255 amostras) com as faixas de atenção e alerta da região
+void chart_write_svg(template_writer *w, const uint8_t *samples, uint count, const region_state *region);
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include "General.h"        // Biblioteca geral do sistema
+#include "Region.h"         // Estado das regiões
+#include "hardware/flash.h" // Gravação da flash
+
+// Estado persistente das regiões (níveis, limiares, LED, buzzer e região
+// selecionada). Fica no último setor da flash como um diário de registros de
+// uma página cada: a gravação usa a próxima página livre e o setor só é
+// apagado quando todas foram usadas. No boot vale o registro válido (magic e
+// CRC) de maior sequência. Mudanças são gravadas CONFIG_SAVE_DELAY_MS depois
+// da primeira alteração, agrupando rajadas de botões.
+//
+// Apagar e gravar a flash desabilita as interrupções e o XIP: config_poll()
+// só pode ser chamado com o núcleo 1 parado (fora da flash).
+
+#define CONFIG_MAGIC 0x46534346u // "FSCF"
+#define CONFIG_VERSION 2 // 2: status do LED em código, não em texto
+#define CONFIG_SAVE_DELAY_MS 5000
+
+#define CONFIG_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+#define CONFIG_SLOTS (FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE)
+
+// Restaura as regiões a partir da flash (chamar depois de init_regions); false se não houver registro
+bool config_load();
+
+// Grava o estado quando o atraso após uma mudança expira (chamar no laço principal)
+void config_poll();
+
+// Próximo instante em que config_poll() tem trabalho agendado
+absolute_time_t config_next_deadline();
+
+#endif
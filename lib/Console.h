@@ -0,0 +1,12 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include "General.h" // Biblioteca geral do sistema
+
+// Comandos de um caractere recebidos pelo console (USB CDC). O laço principal
+// chama console_poll(), que nunca bloqueia esperando entrada.
+
+// Função para ler e executar os comandos pendentes no console
+void console_poll();
+
+#endif
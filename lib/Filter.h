@@ -0,0 +1,47 @@
+#ifndef FILTER_H
+#define FILTER_H
+
+#include "General.h" // Biblioteca geral do sistema
+
+// Filtro de picos por região, entre a aquisição e add_reading: mediana móvel
+// de FILTER_WINDOW amostras (janela mantida ordenada), rejeição de outliers
+// pelo MAD (desvio absoluto mediano) e suavização por média móvel exponencial.
+// Uma amostra que se afasta da mediana mais que FILTER_REJECT_K desvios
+// (MAD normalizado, com piso FILTER_MIN_DEVIATION) é trocada pela mediana;
+// uma mudança real de nível passa quando já ocupa metade da janela.
+//
+// Tudo em inteiros, em ponto fixo Q8 (FILTER_ONE = 1 m), com custo
+// constante O(FILTER_WINDOW) por amostra.
+
+#define FILTER_FRAC_BITS 8
+#define FILTER_ONE (1 << FILTER_FRAC_BITS)     // 1 m em ponto fixo
+#define FILTER_WINDOW 7                        // Amostras da mediana móvel (ímpar)
+#define FILTER_REJECT_K 3                      // Limite de rejeição em desvios
+#define FILTER_MIN_DEVIATION (FILTER_ONE / 2)  // Piso do limite (janela sem ruído tem MAD 0)
+#define FILTER_MAD_SCALE 380                   // 1,4826 em Q8: MAD -> desvio padrão (ruído gaussiano)
+#define FILTER_EWMA_SHIFT 2                    // Peso da amostra nova na média exponencial: 1/4
+
+typedef struct
+{
+    int32_t ring[FILTER_WINDOW];   // Amostras na ordem de chegada
+    int32_t sorted[FILTER_WINDOW]; // As mesmas amostras, ordenadas
+    uint8_t head;                  // Próxima posição de ring (a mais antiga com a janela cheia)
+    uint8_t count;                 // Amostras na janela
+    int32_t ewma;                  // Saída suavizada
+    uint32_t samples;
+    uint32_t rejected;             // Amostras trocadas pela mediana
+} level_filter;
+
+// Função para iniciar o filtro vazio
+void filter_init(level_filter *filter);
+
+// Processa uma amostra (Q8) e retorna a saída filtrada (Q8)
+int32_t filter_push(level_filter *filter, int32_t sample);
+
+// Mediana da janela atual (Q8)
+int32_t filter_median(const level_filter *filter);
+
+// Desvio absoluto mediano da janela atual (Q8)
+int32_t filter_mad(const level_filter *filter);
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef GATEWAY_H
+#define GATEWAY_H
+
+#include "General.h"   // Biblioteca geral do sistema
+#include "Telemetry.h" // Relatórios UDP dos nós
+#include "Template.h"  // Writer usado na geração do JSON
+
+// Modo gateway: com GATEWAY_PEERS definido, o nó consulta os pares pela
+// telemetria UDP (requisição/relatório de Telemetry.h) a cada
+// GATEWAY_PERIOD_MS e mantém uma visão da frota (N regiões em M nós), servida
+// em /api/fleet e no dashboard. As requisições de uma rodada saem todas de uma
+// vez e cada par tem o próprio prazo de resposta, então um nó fora do ar não
+// atrasa os demais. Sem GATEWAY_PEERS a frota é só o próprio nó.
+//
+// A tabela é escrita pelo callback UDP e pelo laço principal (com o lock do
+// lwIP) e lida pelos callbacks HTTP, todos no mesmo contexto do lwIP.
+
+#ifndef GATEWAY_PEERS
+#define GATEWAY_PEERS "" // "ip[:porta],ip[:porta],..." (porta padrão TELEMETRY_PORT)
+#endif
+
+#define GATEWAY_PEERS_MAX 8      // Pares consultados (além do próprio nó)
+#define GATEWAY_PERIOD_MS 1000   // Intervalo entre rodadas
+#define GATEWAY_TIMEOUT_MS 300   // Prazo de resposta de cada par
+#define GATEWAY_OFFLINE_MISSES 3 // Rodadas sem resposta até o par ser marcado offline
+
+typedef struct
+{
+    ip_addr_t addr;
+    u16_t port;
+    bool local;              // Entrada 0: o próprio nó
+    bool seen;               // Já respondeu alguma vez
+    bool online;
+    uint8_t misses;          // Rodadas seguidas sem resposta
+    bool pending;            // Requisição da rodada atual sem resposta
+    uint32_t request_seq;    // Sequência da requisição pendente
+    uint64_t sent_us;        // Instante do envio da requisição pendente
+    uint32_t last_seen_ms;   // Instante (desde o boot do gateway) do último relatório
+    uint32_t rtt_us;         // Tempo de resposta do último relatório
+    telemetry_report report; // Último relatório recebido
+} gateway_node;
+
+// Lê GATEWAY_PEERS e cria o PCB UDP das consultas (chamar com a pilha de rede pronta)
+void configure_gateway();
+
+// true se há pares configurados
+bool gateway_enabled();
+
+// Envia a rodada de requisições e expira as respostas atrasadas (chamar no laço principal)
+void gateway_poll();
+
+// Próximo instante em que gateway_poll() tem trabalho agendado
+absolute_time_t gateway_next_deadline();
+
+// Incrementada quando o conteúdo da frota muda (pares online/offline ou relatórios diferentes)
+uint32_t gateway_version();
+
+// Número de nós na frota, incluindo o próprio
+uint gateway_node_count();
+
+// Nó da frota; a entrada 0 é o próprio nó, lida no momento da chamada
+const gateway_node *gateway_node_at(uint index);
+
+// Número de blocos que compõem /api/fleet
+uint16_t gateway_units();
+
+// Gera blocos de /api/fleet a partir de *cursor enquanto couberem em buffer; retorna os bytes escritos
+uint16_t gateway_render(uint16_t *cursor, char *buffer, uint16_t size);
+
+#endif
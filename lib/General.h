@@ -6,6 +6,7 @@
 #include <stdlib.h> // Biblioteca padrão para alocação de memória e conversões
 #include <stdint.h> // Biblioteca padrão para tipos inteiros
 #include <string.h> // Biblioteca manipular strings
+#include <strings.h> // Comparação de strings sem diferenciar maiúsculas (strncasecmp)
 #include <math.h> // Biblioteca para funções matemáticas
 #include "hardware/gpio.h" // Controle de GPIO (General Purpose Input/Output)
 #include "pico/stdlib.h"     // Biblioteca principal para o Raspberry Pi Pico
@@ -16,6 +17,7 @@
 #include "hardware/i2c.h"    // Comunicação I2C
 #include "hardware/adc.h"    // Biblioteca da Raspberry Pi Pico para manipulação do conversor ADC
 #include "pico/cyw43_arch.h" // Biblioteca para arquitetura Wi-Fi da Pico com CYW43
+#include "pico/unique_id.h"  // ID único da placa (identificação do nó na rede)
 #include "lwip/pbuf.h"  // Lightweight IP stack - manipulação de buffers de pacotes de rede
 #include "lwip/tcp.h"   // Lightweight IP stack - fornece funções e estruturas para trabalhar com o protocolo TCP
 #include "lwip/netif.h" // Lightweight IP stack - fornece funções e estruturas para trabalhar com interfaces de rede (netif)
@@ -31,4 +33,10 @@ void init_system_config();
 // Função para inicializar o PWM em um pino específico com um valor de wrap
 void init_pwm(uint gpio, uint wrap);
 
+// Identificador do nó na rede, derivado do ID único da placa
+uint16_t get_node_id();
+
+// CRC-32 (IEEE 802.3) dos dados; usado nos registros persistentes
+uint32_t crc32(const uint8_t *data, size_t len);
+
 #endif
\ No newline at end of file
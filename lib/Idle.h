@@ -0,0 +1,25 @@
+#ifndef IDLE_H
+#define IDLE_H
+
+#include "General.h" // Biblioteca geral do sistema
+
+// Modo ocioso sem tick fixo. O laço principal calcula o próximo prazo das
+// tarefas agendadas e dorme com WFE até ele; IRQs de GPIO, callbacks de rede
+// e o console chamam idle_wake() para acordá-lo antes. Sem clientes HTTP
+// conectados, o CYW43 fica no power-save agressivo.
+
+#define IDLE_MAX_SLEEP_MS 1000 // Maior intervalo sem acordar (limite de segurança)
+
+// Função para configurar o modo ocioso (callback do console e power-save do CYW43)
+void configure_idle();
+
+// Sinaliza trabalho para o laço principal; pode ser chamada de IRQs e callbacks
+void idle_wake();
+
+// Informa quantos clientes HTTP estão conectados (o power-save é ajustado no laço)
+void idle_set_clients(uint count);
+
+// Dorme até o prazo ou até idle_wake(); retorna true se acordou por evento
+bool idle_until(absolute_time_t deadline);
+
+#endif
@@ -20,6 +20,9 @@ void configure_leds_matrix(); // Função para configurar a matriz de LEDs
 // Converte uma estrutura de cor RGB para um valor 32 bits
 uint32_t rgb_matrix(led_color color);
 
+// Linhas acesas para o nível: floor(5 * nível / limiar), no máximo 5
+int matrix_lines_on(uint8_t current_level, uint8_t alert_threshold);
+
 // Função para desenhar as cores do semáforo
 void update_matrix_from_level(uint8_t current_level, uint8_t alert_threshold);
 
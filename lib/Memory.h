@@ -0,0 +1,36 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include "General.h" // Biblioteca geral do sistema
+
+// Orçamento de memória. Todos os buffers do firmware são estáticos; este
+// módulo mede o que sobra: a marca d'água das pilhas (preenchidas com um
+// padrão no boot), os pools e o heap do lwIP e o heap do malloc, que deve
+// permanecer vazio.
+
+#define MEMORY_CORES 2                // Núcleos com pilha própria
+#define MEMORY_STACK_PATTERN 0x5AFEC0DEu // Padrão das palavras de pilha nunca usadas
+
+#ifndef MEMORY_HOST_STACK_SIZE
+#define MEMORY_HOST_STACK_SIZE (64 * 1024) // Janela medida na simulação em Linux
+#endif
+
+// Função para preencher as pilhas livres com o padrão (chamar no início do main)
+void configure_memory();
+
+// Tamanho da pilha do núcleo em bytes (0 se não houver)
+uint32_t memory_stack_size(uint core);
+
+// Maior uso já registrado da pilha do núcleo, em bytes
+uint32_t memory_stack_used(uint core);
+
+// Bytes alocados pelo malloc
+uint32_t memory_heap_used();
+
+// Memória obtida pelo malloc (só cresce: é a marca d'água do heap)
+uint32_t memory_heap_arena();
+
+// Função para imprimir o relatório de memória no console
+void memory_report();
+
+#endif
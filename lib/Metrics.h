@@ -0,0 +1,85 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "General.h" // Biblioteca geral do sistema
+
+// Contadores e histogramas no formato de exposição de texto do Prometheus.
+// Cada métrica tem um único contexto escritor (IRQ de GPIO, callbacks do
+// lwIP ou laço principal), então os incrementos dispensam travas; os buckets
+// dos histogramas são alocados estaticamente.
+
+#define METRICS_HIST_BUCKETS 10 // Buckets finitos (+Inf é implícito)
+#define METRICS_CHUNK_SIZE 1024 // Maior bloco gerado por metrics_render()
+
+typedef enum
+{
+    METRIC_HTTP_REQUESTS = 0,
+    METRIC_HTTP_BYTES_SENT,
+    METRIC_TCP_WRITE_FAILURES,
+    METRIC_GPIO_IRQ_BUTTON_A,
+    METRIC_GPIO_IRQ_BUTTON_B,
+    METRIC_GPIO_IRQ_BUTTON_J,
+    METRIC_BUTTON_EVENTS_DROPPED,
+    METRIC_IDLE_WAKEUPS_EVENT,
+    METRIC_IDLE_WAKEUPS_DEADLINE,
+    METRIC_CPU_SLEEP_MS,
+    METRIC_CPU_AWAKE_MS,
+    METRIC_WIFI_CONNECT_ATTEMPTS,
+    METRIC_WIFI_LINK_UP,
+    METRIC_WIFI_LINK_DOWN,
+    METRIC_CONFIG_WRITES,
+    METRIC_CONFIG_ERASES,
+    METRIC_GATEWAY_REQUESTS,
+    METRIC_GATEWAY_REPLIES,
+    METRIC_GATEWAY_TIMEOUTS,
+    METRIC_CACHE_HITS,
+    METRIC_CACHE_RENDERS,
+    METRIC_CACHE_BYPASS,
+    METRIC_SENSOR_ACCEPTED,
+    METRIC_SENSOR_REJECTED,
+    METRIC_WEBHOOK_DELIVERED,
+    METRIC_WEBHOOK_RETRIES,
+    METRIC_WEBHOOK_DROPPED,
+    METRIC_WEBHOOK_COALESCED,
+    METRIC_STREAM_SENT,
+    METRIC_STREAM_LOST,
+    METRIC_HTTP_SERVED_CONTROL,
+    METRIC_HTTP_SERVED_API,
+    METRIC_HTTP_SERVED_PAGE,
+    METRIC_HTTP_SHED_CLIENT,
+    METRIC_HTTP_SHED_FULL,
+    METRIC_HTTP_SHED_RESERVED,
+    METRIC_HTTP_SHED_RATE,
+    METRIC_HTTP_SHED_EVICTED,
+    METRIC_COUNTER_COUNT
+} metric_counter;
+
+typedef enum
+{
+    METRIC_HTTP_PARSE_TIME = 0,
+    METRIC_HTTP_RENDER_TIME,
+    METRIC_LOOP_ITERATION_TIME,
+    METRIC_LOOP_JITTER,
+    METRIC_DISPLAY_SEND_TIME,
+    METRIC_MATRIX_UPDATE_TIME,
+    METRIC_BUTTON_LATENCY,
+    METRIC_GATEWAY_RTT,
+    METRIC_HISTOGRAM_COUNT
+} metric_histogram;
+
+// Incrementa um contador
+void metrics_inc(metric_counter id);
+
+// Soma um valor a um contador
+void metrics_add(metric_counter id, uint32_t value);
+
+// Registra uma duração (em microssegundos) em um histograma
+void metrics_observe(metric_histogram id, uint32_t duration_us);
+
+// Número de blocos que compõem a página /metrics
+uint16_t metrics_units();
+
+// Gera blocos a partir de *cursor enquanto couberem em buffer; retorna os bytes escritos
+uint16_t metrics_render(uint16_t *cursor, char *buffer, uint16_t size);
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef MQTT_H
+#define MQTT_H
+
+#include "General.h" // Biblioteca geral do sistema
+#include "Region.h"  // Estado das regiões monitoradas
+
+// Publicador MQTT 3.1.1 (QoS 0) sobre a API raw de TCP do lwIP. Nada aqui
+// bloqueia: a conexão, o CONNACK e os envios avançam em mqtt_poll() e nos
+// callbacks do lwIP. Enquanto o broker está inacessível as amostras ficam em
+// uma fila circular limitada em RAM (as mais antigas são descartadas).
+
+#ifndef MQTT_BROKER_IP
+#define MQTT_BROKER_IP "" // Endereço do broker; vazio desativa o MQTT
+#endif
+
+#define MQTT_BROKER_PORT 1883
+#define MQTT_KEEPALIVE_S 30              // Keep alive informado no CONNECT
+#define MQTT_TOPIC_LEVELS "floodsense/%04x/levels"
+#define MQTT_TOPIC_ALERTS "floodsense/%04x/alerts"
+
+#define MQTT_SAMPLE_PERIOD_MS 1000      // Intervalo de amostragem dos níveis
+#define MQTT_BATCH_SIZE 5               // Amostras por PUBLISH
+#define MQTT_BATCH_MAX_AGE_MS 10000     // Publica lote incompleto após esse tempo
+#define MQTT_QUEUE_SIZE 64              // Amostras mantidas com o broker offline
+#define MQTT_ALERT_QUEUE_SIZE 8         // Transições de alerta pendentes
+#define MQTT_CONNECT_TIMEOUT_MS 5000    // Tempo máximo até o CONNACK
+#define MQTT_RETRY_MIN_MS 1000          // Primeiro intervalo de reconexão
+#define MQTT_RETRY_MAX_MS 60000         // Intervalo máximo de reconexão
+#define MQTT_PACKET_SIZE 512            // Buffer de montagem de pacotes
+
+typedef enum
+{
+    MQTT_DISABLED = 0,
+    MQTT_DISCONNECTED,
+    MQTT_TCP_CONNECTING,
+    MQTT_WAIT_CONNACK,
+    MQTT_CONNECTED
+} mqtt_state;
+
+// Amostra de nível (8 bytes)
+typedef struct
+{
+    uint32_t time_ms;
+    uint8_t region; // 0 = A, 1 = B
+    uint8_t level;
+    uint8_t class;  // level_class
+    uint8_t previous_class; // Usado nas transições de alerta
+} mqtt_sample;
+
+// Prepara o cliente; a conexão é iniciada em mqtt_poll()
+void configure_mqtt();
+
+// Amostra os níveis, detecta transições e avança a conexão (chamar no laço principal)
+void mqtt_poll();
+
+// Próximo instante em que mqtt_poll() tem trabalho agendado
+absolute_time_t mqtt_next_deadline();
+
+// Estado atual da conexão com o broker
+mqtt_state mqtt_get_state();
+
+// Amostras descartadas por falta de espaço na fila
+uint32_t mqtt_get_dropped();
+
+#endif
@@ -0,0 +1,128 @@
+#ifndef REGION_H
+#define REGION_H
+
+#include "General.h" // Biblioteca geral do sistema
+#include "Led.h"     // Cores do LED RGB
+
+#define ALERT_THRESHOLD_A 12
+#define ALERT_THRESHOLD_B 20
+
+#define ATTENTION_THRESHOLD_A 9
+#define ATTENTION_THRESHOLD_B 16
+
+#define INITIAL_LEVEL_A 5
+#define INITIAL_LEVEL_B 3
+
+#define MAX_EVENTS 10
+#define MAX_READINGS 10
+
+// Classificação do nível de água de uma região
+typedef enum
+{
+    LEVEL_NORMAL = 0,
+    LEVEL_ATTENTION = 1,
+    LEVEL_ALERT = 2
+} level_class;
+
+// Periféricos controláveis (parâmetro dos eventos e do estado exibido)
+typedef enum
+{
+    PERIPHERAL_LED_NORMAL = 0,
+    PERIPHERAL_LED_ATTENTION,
+    PERIPHERAL_LED_ALERT,
+    PERIPHERAL_BUZZER,
+    PERIPHERAL_COUNT
+} peripheral;
+
+// Tipos de evento do histórico
+typedef enum
+{
+    EVENT_LED = 0, // Comando de LED; o periférico indica a cor
+    EVENT_BUZZER,
+    EVENT_CODE_COUNT
+} event_code;
+
+// Evento do histórico em códigos; o texto vem de tabelas constantes na renderização
+typedef struct
+{
+    uint32_t time_ms;   // Instante desde o boot
+    uint8_t code;       // event_code
+    uint8_t region;     // 0 = A, 1 = B
+    uint8_t peripheral; // peripheral
+    uint8_t on;
+} event_record;
+
+typedef struct
+{
+    led_color led_color;
+    bool buzzer_on;
+    uint8_t current_level;
+    uint8_t attention_threshold;            // Nível de atenção (m)
+    uint8_t alert_threshold;                // Nível de alerta (m)
+    uint8_t led_status;                     // Periférico do último comando de LED
+    bool led_status_on;                     // Ação do último comando de LED
+} region_state;
+
+// Estado de trabalho dos escritores: tratamento dos botões e sensores (laço
+// principal, com o lock do lwIP) e comandos HTTP (callbacks do lwIP). O lock
+// garante um escritor por vez. Os leitores (páginas, saídas, telemetria, MQTT,
+// webhooks, configuração) não leem estas variáveis: usam read_state(), que
+// devolve o último lote publicado inteiro por publish_state().
+
+extern bool is_region_A;
+extern volatile uint32_t state_version; // Incrementada a cada lote publicado
+
+extern region_state region_A;
+extern region_state region_B;
+
+extern uint8_t readings_A[MAX_READINGS]; // Níveis de água da região A
+extern uint8_t readings_B[MAX_READINGS]; // Níveis de água da região B
+
+extern event_record event_log[MAX_EVENTS]; // Log de eventos, do mais antigo para o mais recente
+extern int total_events;
+
+// Estado publicado: cópia coerente de tudo que os leitores consomem
+typedef struct
+{
+    uint32_t version;                  // state_version da publicação
+    bool is_region_A;
+    region_state regions[2];           // 0 = A, 1 = B
+    uint8_t readings[2][MAX_READINGS]; // Históricos de A e B
+    event_record events[MAX_EVENTS];   // Do mais antigo para o mais recente
+    uint8_t event_count;
+} state_snapshot;
+
+// Inicializa o estado das regiões com os níveis e limiares padrão (e o publica)
+void init_regions();
+
+// Move todos os elementos para a esquerda e adiciona novo valor no final
+void add_reading(uint8_t new_value, uint8_t readings[]);
+
+// Publica um lote de mudanças no estado das regiões (uma vez por lote, não por campo)
+void publish_state();
+
+// Copia o último estado publicado; nunca espera por uma publicação em andamento
+void read_state(state_snapshot *snapshot);
+
+// Região do estado publicado que está selecionada
+static inline const region_state *snapshot_selected(const state_snapshot *snapshot)
+{
+    return &snapshot->regions[snapshot->is_region_A ? 0 : 1];
+}
+
+// Adiciona um novo evento ao log
+void add_event(event_code code, const region_state *region, peripheral target, bool on);
+
+// Rótulo exibido para um periférico ligado ou desligado
+const char *peripheral_label(peripheral target, bool on);
+
+// Nome da região ("A" ou "B") pelo índice usado nos eventos
+const char *region_name(uint8_t index);
+
+// Classifica o nível atual da região pelos seus limiares
+level_class classify_region(const region_state *region);
+
+// Nome da classe exibido no dashboard (também usado como classe CSS)
+const char *level_class_name(level_class class);
+
+#endif
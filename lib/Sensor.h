@@ -0,0 +1,62 @@
+#ifndef SENSOR_H
+#define SENSOR_H
+
+#include "General.h" // Biblioteca geral do sistema
+#include "Region.h"  // Estado das regiões monitoradas
+#include "Filter.h"  // Filtro de picos
+
+// Aquisição dos níveis por sensores analógicos (um canal do ADC por região).
+// Cada amostra passa pelo filtro de picos da região (Filter.h) e o nível
+// filtrado é publicado em current_level/add_reading a cada
+// SENSOR_COMMIT_MS, só quando muda. Desligado por padrão: sem sensores os
+// níveis vêm dos botões. Com SENSOR_ENABLED, os botões A/B ainda ajustam o
+// nível, mas a próxima publicação do sensor o sobrescreve. Com o stream de
+// amostras ativo (Stream.h), a aquisição passa para a IRQ do timer, no ritmo
+// do stream; a publicação continua no laço principal. As leituras brutas
+// podem vir de outra fonte no lugar do ADC (sensor_set_source): o replay de
+// traces gravados (host/bench/replay.c) entra por aqui e percorre o mesmo
+// caminho até add_reading.
+
+#ifndef SENSOR_ENABLED
+#define SENSOR_ENABLED 0
+#endif
+
+#define SENSOR_GPIO_A 26      // ADC0: sensor da região A
+#define SENSOR_GPIO_B 27      // ADC1: sensor da região B
+#define SENSOR_RANGE_M 32     // Nível no fundo de escala do ADC (3,3 V)
+#define SENSOR_SAMPLE_MS 100  // Intervalo entre amostras
+#define SENSOR_COMMIT_MS 1000 // Intervalo entre publicações do nível filtrado
+
+// Uma amostra das duas regiões, como sai do pipeline de aquisição
+typedef struct
+{
+    uint16_t raw[2];     // Leitura do ADC (0 a 4095)
+    int32_t filtered[2]; // Saída do filtro (Q8)
+    uint8_t rejected;    // Bit por região: amostra trocada pela mediana
+} sensor_sample;
+
+// Fonte de leituras brutas (0 a 4095) por canal (0 = A, 1 = B)
+typedef uint16_t (*sensor_source)(uint channel);
+
+// Função para configurar o ADC e os filtros (sem efeito com SENSOR_ENABLED 0)
+void configure_sensor();
+
+// Amostra os sensores e publica os níveis (chamar no laço principal, com o lock do lwIP)
+void sensor_poll();
+
+// Lê os dois canais e passa as leituras pelos filtros (laço principal ou IRQ do stream, nunca os dois)
+void sensor_acquire(sensor_sample *sample);
+
+// Publica os níveis filtrados das duas regiões (e o estado, se mudou); true se algum mudou
+bool sensor_commit();
+
+// Troca a fonte das leituras brutas (NULL volta ao ADC)
+void sensor_set_source(sensor_source read);
+
+// Próximo instante em que sensor_poll() tem trabalho agendado
+absolute_time_t sensor_next_deadline();
+
+// Filtro da região (0 = A, 1 = B), para diagnóstico
+const level_filter *sensor_filter(uint index);
+
+#endif
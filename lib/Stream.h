@@ -0,0 +1,57 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include "General.h" // Biblioteca geral do sistema
+#include "Sensor.h"  // Pipeline de aquisição
+
+// Stream binário das amostras brutas e filtradas pelo USB CDC, para
+// caracterizar os sensores na bancada. Ligado pelo console (comando 'S'), ele
+// move a aquisição para um alarme do timer a cada STREAM_SAMPLE_US e junta as
+// amostras em dois blocos alternados: a IRQ enche um enquanto o laço
+// principal codifica e envia o outro. O envio não bloqueia: o quadro espera
+// até caber inteiro na FIFO do CDC; com os dois blocos ocupados (host lento
+// ou desconectado) as amostras seguintes são contadas como perdidas, mas a
+// amostragem e o filtro nunca param.
+//
+// Cada bloco vira um quadro: cabeçalho, registros e CRC-32 (General.h),
+// codificados em COBS e cercados por bytes 0x00. O quadro entra na FIFO de
+// uma vez, com as IRQs desabilitadas, então o texto do console (printf, que
+// divide a mesma FIFO) só aparece entre quadros e é descartado pelo leitor
+// (tools/stream_capture.py). Por isso o quadro cabe na FIFO (assert em Stream.c).
+
+#define STREAM_SAMPLE_US 1000    // Período de amostragem com o stream ativo (1 kHz)
+#define STREAM_BLOCK_SAMPLES 24  // Amostras por quadro (o quadro cabe na FIFO do CDC)
+#define STREAM_VERSION 1         // Versão do formato do quadro
+#define STREAM_REJECTED 0x8000u  // Bit de raw[]: amostra trocada pela mediana
+
+// Cabeçalho do quadro (little-endian)
+typedef struct
+{
+    uint8_t version;    // STREAM_VERSION
+    uint8_t count;      // Registros no quadro
+    uint16_t period_us; // Período de amostragem
+    uint32_t seq;       // Número do quadro (lacunas = quadros perdidos no caminho)
+    uint32_t time_us;   // Instante agendado da primeira amostra (as demais a cada period_us)
+    uint32_t lost;      // Amostras perdidas desde o início do stream, até a primeira deste quadro
+} stream_header;
+
+// Registro de uma amostra (8 bytes)
+typedef struct
+{
+    uint16_t raw[2];     // Leitura do ADC (0 a 4095) por região, com STREAM_REJECTED
+    int16_t filtered[2]; // Saída do filtro (Q8, metros)
+} stream_record;
+
+// Liga ou desliga o stream (comando do console)
+void stream_toggle();
+
+// true enquanto o stream está ligado (a aquisição roda na IRQ do timer)
+bool stream_active();
+
+// Codifica os blocos cheios e escreve na FIFO do CDC o que couber (chamar no laço principal)
+void stream_poll();
+
+// Próximo instante em que stream_poll() tem trabalho agendado
+absolute_time_t stream_next_deadline();
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef SUPERVISOR_H
+#define SUPERVISOR_H
+
+#include "General.h" // Biblioteca geral do sistema
+
+// Supervisor do laço principal com o watchdog do RP2040. Uma transação I2C
+// presa (cabo do OLED com mau contato) ou uma espera longa em uma tarefa
+// congelava o nó inteiro, e só se descobria quando o local saía do ar.
+//
+// O laço marca a entrada em cada tarefa com supervisor_enter(); cada tarefa
+// tem um tempo máximo. Um alarme (IRQ do timer) a cada SUPERVISOR_CHECK_MS
+// confere a tarefa atual e só alimenta o watchdog se ela estiver dentro do
+// prazo: uma tarefa travada, sozinha, reinicia o nó em até
+// SUPERVISOR_TIMEOUT_MS depois de detectada.
+//
+// A cada verificação o alarme grava um registro post-mortem (tarefa, PC do
+// checkpoint, tempo na tarefa, uptime e tempos do laço) em RAM não
+// inicializada, validado por CRC, que sobrevive ao reset. Se o próprio alarme
+// parar (IRQs mascaradas, HardFault), o watchdog dispara com o último
+// registro. No boot seguinte o registro sai no console USB, no comando 'W' e
+// em GET /api/postmortem.
+//
+// O M0+ não amostra o PC de outra rotina: o PC registrado é o endereço de
+// retorno do último supervisor_enter(), a localizar com addr2line.
+
+#define SUPERVISOR_CHECK_MS 500    // Período da verificação (e da alimentação) do watchdog
+#define SUPERVISOR_TIMEOUT_MS 2000 // Watchdog sem alimentação até o reset
+#define SUPERVISOR_STALL_MS 1500   // Tempo máximo padrão de uma tarefa do laço
+
+// Tarefas do laço principal, na ordem em que rodam
+typedef enum
+{
+    SUPERVISOR_TASK_WIFI = 0, // Eventos do Wi-Fi (inclui o cyw43_arch_init)
+    SUPERVISOR_TASK_CONSOLE,  // Console e stream USB
+    SUPERVISOR_TASK_INPUTS,   // Botões e sensores
+    SUPERVISOR_TASK_NETWORK,  // Telemetria, MQTT, gateway e webhooks
+    SUPERVISOR_TASK_OUTPUTS,  // Buzzer, LEDs, matriz e OLED (I2C)
+    SUPERVISOR_TASK_CONFIG,   // Gravação do estado na flash
+    SUPERVISOR_TASK_IDLE,     // Espera até o próximo prazo
+    SUPERVISOR_TASK_COUNT
+} supervisor_task;
+
+// Função para ler o registro do último reset, reportá-lo e ligar o watchdog e o supervisor
+void configure_supervisor();
+
+// Marca a entrada do laço em uma tarefa (checkpoint do post-mortem)
+void supervisor_enter(supervisor_task task);
+
+// Registra a duração de uma iteração do laço (sem contar a espera)
+void supervisor_loop_time(uint32_t iteration_us);
+
+// Função para imprimir o post-mortem do último reset e o estado atual no console
+void supervisor_report();
+
+// Função para travar o laço de propósito e verificar o reset pelo watchdog
+void supervisor_stall_test();
+
+// Corpo JSON de GET /api/postmortem, em blocos (ver metrics_render)
+uint16_t supervisor_units();
+uint16_t supervisor_render(uint16_t *cursor, char *buffer, uint16_t size);
+
+#endif
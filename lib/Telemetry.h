@@ -0,0 +1,108 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "General.h" // Biblioteca geral do sistema
+#include "Region.h"  // Estado das regiões monitoradas
+#include "lwip/udp.h" // Lightweight IP stack - protocolo UDP
+
+/*
+  Protocolo de telemetria binária (UDP, little-endian, layout fixo)
+
+  Cabeçalho (20 bytes):
+    0  u8[2] magic        'F' 'S'
+    2  u8    versão       TELEMETRY_VERSION
+    3  u8    tipo         TELEMETRY_TYPE_*
+    4  u32   sequência    contador de relatórios do nó (na requisição: do coletor)
+    8  u32   ack          sequência da requisição respondida (0 nos envios periódicos)
+    12 u32   uptime_ms    tempo desde o boot do nó
+    16 u16   node_id      identificador do nó (ID único da placa)
+    18 u8    flags        bit0: região A selecionada no display
+    19 u8    regiões      número de registros que seguem
+
+  Registro por região (8 bytes):
+    0  u8    nível (m)
+    1  u8    classe       0 Normal, 1 Atenção, 2 Alerta
+    2  u8    LED          TELEMETRY_LED_*
+    3  u8    buzzer       0 desligado, 1 ligado
+    4  u8    limiar de atenção (m)
+    5  u8    limiar de alerta (m)
+    6  u16   reservado    0
+
+  Uma requisição é apenas o cabeçalho com tipo TELEMETRY_TYPE_REQUEST e zero
+  regiões; o nó responde ao remetente com um relatório. Relatórios também são
+  enviados a cada TELEMETRY_PERIOD_MS para TELEMETRY_DEST_ADDR.
+*/
+
+#define TELEMETRY_PORT 5005           // Porta em que o nó atende requisições
+#define TELEMETRY_COLLECTOR_PORT 5006 // Porta de destino dos envios periódicos
+#define TELEMETRY_PERIOD_MS 1000      // Intervalo dos envios periódicos (0 desativa)
+
+#ifndef TELEMETRY_DEST_ADDR
+#define TELEMETRY_DEST_ADDR "255.255.255.255" // Broadcast; pode ser um grupo multicast (ex.: 239.255.70.83)
+#endif
+
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_TYPE_REQUEST 0x01
+#define TELEMETRY_TYPE_REPORT 0x02
+
+#define TELEMETRY_HEADER_SIZE 20
+#define TELEMETRY_REGION_SIZE 8
+#define TELEMETRY_REGIONS 2
+#define TELEMETRY_REPORT_SIZE (TELEMETRY_HEADER_SIZE + TELEMETRY_REGIONS * TELEMETRY_REGION_SIZE)
+
+#define TELEMETRY_FLAG_REGION_A 0x01
+
+#define TELEMETRY_LED_DARK 0
+#define TELEMETRY_LED_GREEN 1
+#define TELEMETRY_LED_ORANGE 2
+#define TELEMETRY_LED_RED 3
+#define TELEMETRY_LED_OTHER 4
+
+// Registro de uma região, decodificado
+typedef struct
+{
+    uint8_t level;
+    uint8_t class;
+    uint8_t led;
+    uint8_t buzzer;
+    uint8_t attention_threshold;
+    uint8_t alert_threshold;
+} telemetry_region;
+
+// Relatório decodificado (regiões além de TELEMETRY_REGIONS são ignoradas)
+typedef struct
+{
+    uint32_t seq;
+    uint32_t ack;
+    uint32_t uptime_ms;
+    uint16_t node_id;
+    uint8_t flags;
+    uint8_t region_count;
+    telemetry_region regions[TELEMETRY_REGIONS];
+} telemetry_report;
+
+// Cria o PCB UDP e passa a atender requisições na TELEMETRY_PORT
+void configure_telemetry();
+
+// Envia o relatório periódico quando o intervalo expira (chamar no laço principal)
+void telemetry_poll();
+
+// Próximo instante em que telemetry_poll() tem trabalho agendado
+absolute_time_t telemetry_next_deadline();
+
+// Monta um relatório com o estado atual; retorna o tamanho em bytes
+uint16_t telemetry_build_report(uint8_t *buffer, uint32_t request_seq);
+
+// Monta uma requisição de relatório; retorna o tamanho em bytes
+uint16_t telemetry_build_request(uint8_t *buffer, uint32_t seq);
+
+// Estado atual do nó no formato do relatório, sem consumir a sequência
+void telemetry_snapshot(telemetry_report *report);
+
+// Decodifica um relatório recebido; false se o pacote não for válido
+bool telemetry_parse_report(const uint8_t *data, uint16_t len, telemetry_report *report);
+
+// Nome do código de LED (TELEMETRY_LED_*)
+const char *telemetry_led_name(uint8_t led);
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef TEMPLATE_H
+#define TEMPLATE_H
+
+#include "General.h" // Biblioteca geral do sistema
+
+// Templates compilados: tools/gen_templates.py transforma templates/*.html em
+// uma tabela de fragmentos constantes e slots tipados ({{nome:tipo}}), com uma
+// struct <nome>_values que a aplicação preenche. O renderizador percorre a
+// tabela e escreve direto no buffer de envio do TCP, retomando em tcp_sent.
+
+#define TEMPLATE_CHUNK_SIZE 1024   // Buffer para fragmentos curtos e slots
+#define TEMPLATE_ZERO_COPY_MIN 256 // Fragmentos a partir deste tamanho vão por referência (sem cópia)
+
+typedef enum
+{
+    TEMPLATE_TEXT = 0, // Fragmento constante
+    TEMPLATE_INT,      // int32_t
+    TEMPLATE_STR,      // const char * (NULL = vazio)
+    TEMPLATE_FN        // template_slot_fn que escreve o conteúdo
+} template_kind;
+
+typedef struct
+{
+    uint8_t kind;
+    uint16_t value; // Tamanho do fragmento ou offset do campo em <nome>_values
+    const char *text;
+} template_item;
+
+typedef struct
+{
+    const template_item *items;
+    uint16_t count;
+} template_def;
+
+typedef struct
+{
+    char *buffer;
+    uint16_t size;
+    uint16_t len;
+    bool overflow;
+    const void *context; // Contexto da renderização, lido pelos slots fn
+} template_writer;
+
+// Slot do tipo fn: escreve seu conteúdo com template_put* (o estado vem de w->context)
+typedef void (*template_slot_fn)(template_writer *w);
+
+// Posição de um envio em andamento (guardada por conexão)
+typedef struct
+{
+    const template_def *def;
+    const void *values;
+    const void *context;
+    uint16_t item;
+    uint16_t offset;
+} template_stream;
+
+// Função para escrever bytes no writer
+void template_put(template_writer *w, const char *data, uint16_t len);
+
+// Função para escrever uma string terminada em zero no writer
+void template_put_str(template_writer *w, const char *s);
+
+// Função para escrever um inteiro em decimal no writer
+void template_put_int(template_writer *w, int32_t value);
+
+// Renderiza o template inteiro em buffer; retorna o tamanho ou 0 se não couber
+uint16_t template_render(const template_def *def, const void *values, const void *context, char *buffer, uint16_t size);
+
+// Função para iniciar o envio de um template com os valores e o contexto dos slots fn
+void template_stream_init(template_stream *stream, const template_def *def, const void *values, const void *context);
+
+// Envia o quanto couber no buffer TCP; retorna true quando o template terminou
+bool template_stream_send(template_stream *stream, struct tcp_pcb *tpcb, uint32_t *bytes_sent);
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "General.h"       // Biblioteca geral do sistema
+#include "hardware/sync.h" // Spinlock do SIO ao reservar a posição no anel
+
+// Rastreamento de eventos em um anel na RAM. Cada registro guarda o instante
+// (timer de 1 MHz), o evento, a fase (início/fim) e um argumento; o anel é
+// despejado pelo console USB (comando 'T') e convertido para o formato de
+// trace do Chrome por tools/trace_decode.py.
+//
+// Os dois núcleos gravam (o núcleo 1 durante o boot do display), então o
+// registro inteiro (posição, instante e campos) é gravado sob um spinlock de
+// hardware, que também desabilita as IRQs do núcleo que o segura: os instantes
+// saem em ordem no anel e o despejo nunca vê um registro pela metade.
+
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 1
+#endif
+
+#define TRACE_RING_SIZE 1024 // Registros no anel (potência de 2)
+
+#define TRACE_PHASE_BEGIN 0
+#define TRACE_PHASE_END 1
+
+typedef enum
+{
+    TRACE_GPIO_IRQ = 1,
+    TRACE_TCP_ACCEPT,
+    TRACE_TCP_RECV,
+    TRACE_TCP_SENT,
+    TRACE_UDP_TELEMETRY,
+    TRACE_MQTT_CONNECTED,
+    TRACE_MQTT_RECV,
+    TRACE_LOOP,
+    TRACE_DISPLAY_REFRESH,
+    TRACE_MATRIX_REFRESH,
+    TRACE_BUZZER_BEEP,
+    TRACE_BUTTON_EVENT,
+    TRACE_EVENT_COUNT
+} trace_event;
+
+// Registro de 8 bytes, little-endian no despejo
+typedef struct
+{
+    uint32_t timestamp_us;
+    uint8_t event;
+    uint8_t phase;
+    uint16_t arg;
+} trace_record;
+
+extern trace_record trace_ring[TRACE_RING_SIZE];
+extern volatile uint32_t trace_head;
+extern volatile bool trace_paused;
+extern spin_lock_t *trace_lock; // NULL até configure_trace()
+
+// Grava um registro no anel (sobrescreve os mais antigos)
+static inline void trace_write(uint8_t event, uint8_t phase, uint16_t arg)
+{
+    if (!trace_lock)
+        return;
+
+    uint32_t status = spin_lock_blocking(trace_lock);
+
+    if (!trace_paused)
+    {
+        trace_record *record = &trace_ring[trace_head++ & (TRACE_RING_SIZE - 1)];
+
+        record->timestamp_us = time_us_32();
+        record->event = event;
+        record->phase = phase;
+        record->arg = arg;
+    }
+
+    spin_unlock(trace_lock, status);
+}
+
+#if TRACE_ENABLED
+#define TRACE_BEGIN(event) trace_write((event), TRACE_PHASE_BEGIN, 0)
+#define TRACE_END(event) trace_write((event), TRACE_PHASE_END, 0)
+#define TRACE_BEGIN_ARG(event, arg) trace_write((event), TRACE_PHASE_BEGIN, (arg))
+#else
+#define TRACE_BEGIN(event) ((void)0)
+#define TRACE_END(event) ((void)0)
+#define TRACE_BEGIN_ARG(event, arg) ((void)0)
+#endif
+
+// Função para reservar o spinlock do anel (início do main, antes de lançar o núcleo 1)
+void configure_trace();
+
+// Função para despejar o anel no console (texto com os registros em hexadecimal)
+void trace_dump();
+
+// Função para descartar os registros gravados
+void trace_clear();
+
+#endif
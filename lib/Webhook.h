@@ -0,0 +1,60 @@
+#ifndef WEBHOOK_H
+#define WEBHOOK_H
+
+#include "General.h" // Biblioteca geral do sistema
+#include "Region.h"  // Estado das regiões monitoradas
+
+// Webhooks de alerta: cada entrada ou saída de uma região do nível de Alerta
+// vira um POST JSON para cada endpoint de WEBHOOK_URLS, por um cliente HTTP
+// sobre a API raw de TCP do lwIP. Nada bloqueia: a conexão, o envio e a
+// resposta avançam em webhook_poll() e nos callbacks, uma entrega por vez.
+//
+// As transições ficam em uma fila limitada (a mais antiga é descartada quando
+// ela enche) até todos os endpoints responderem 2xx. Cada endpoint entrega em
+// ordem e tem o próprio backoff exponencial, então um endpoint fora do ar não
+// atrasa os outros. Uma transição nova de uma região cuja última entrada ainda
+// não começou a ser entregue é agrupada nela (o payload leva o estado final, a
+// pior classe e o número de transições): uma oscilação em torno do limiar não
+// inunda o enlace. A fila fica em RAM não inicializada, validada por CRC, e
+// sobrevive a resets a quente (watchdog, reset por software).
+
+#ifndef WEBHOOK_URLS
+#define WEBHOOK_URLS "" // "ip[:porta][/caminho],..." (porta padrão 80); vazio desativa
+#endif
+
+#define WEBHOOK_ENDPOINTS_MAX 4     // Endpoints aceitos em WEBHOOK_URLS
+#define WEBHOOK_PATH_MAX 48         // Maior caminho de um endpoint
+#define WEBHOOK_QUEUE_SIZE 8        // Transições pendentes
+#define WEBHOOK_TIMEOUT_MS 5000     // Prazo de uma entrega (conexão, envio e status)
+#define WEBHOOK_RETRY_MIN_MS 1000   // Primeiro intervalo após uma falha
+#define WEBHOOK_RETRY_MAX_MS 300000 // Maior intervalo entre tentativas
+#define WEBHOOK_MAGIC 0x46535748u   // "FSWH": fila preservada na RAM
+
+// Transição pendente (a fila inteira é preservada entre resets)
+typedef struct
+{
+    uint32_t seq;         // Identificador da transição (crescente)
+    uint32_t time_ms;     // Instante da última transição agrupada
+    uint8_t region;       // 0 = A, 1 = B
+    uint8_t level;
+    uint8_t from;         // level_class antes da primeira transição agrupada
+    uint8_t to;           // level_class atual
+    uint8_t peak;         // Pior classe durante as transições agrupadas
+    uint8_t pending;      // Bit por endpoint que ainda não recebeu
+    uint8_t attempted;    // Bit por endpoint que já tentou (a entrada não é mais agrupada)
+    uint8_t transitions;  // Transições agrupadas nesta entrada
+} webhook_alert;
+
+// Lê WEBHOOK_URLS e recupera a fila preservada (chamar depois de restaurar as regiões)
+void configure_webhook();
+
+// Detecta transições e avança as entregas (chamar no laço principal)
+void webhook_poll();
+
+// Próximo instante em que webhook_poll() tem trabalho agendado
+absolute_time_t webhook_next_deadline();
+
+// Transições pendentes na fila
+uint webhook_pending();
+
+#endif
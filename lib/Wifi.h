@@ -0,0 +1,67 @@
+#ifndef WIFI_H
+#define WIFI_H
+
+#include "General.h" // Biblioteca geral do sistema
+
+// Gerência assíncrona do Wi-Fi. Nada aqui bloqueia: a inicialização do
+// CYW43, a associação e a detecção de queda avançam em wifi_poll(), que
+// devolve as transições para o laço principal subir ou derrubar os serviços.
+// Falhas reagendam a tentativa com backoff exponencial; sensores, display,
+// matriz e buzzer funcionam desde o boot, com ou sem rede.
+
+// Credenciais WIFI - Tome cuidado se publicar no github!
+#ifndef WIFI_SSID
+#define WIFI_SSID ""     // Nome da rede Wi-Fi
+#endif
+#ifndef WIFI_PASSWORD
+#define WIFI_PASSWORD "" // Senha da rede Wi-Fi
+#endif
+
+#define WIFI_CONNECT_TIMEOUT_MS 20000 // Tempo máximo de uma tentativa de associação
+#define WIFI_RETRY_MIN_MS 1000        // Primeiro intervalo entre tentativas
+#define WIFI_RETRY_MAX_MS 60000       // Intervalo máximo entre tentativas
+#define WIFI_CONNECTING_POLL_MS 100   // Consulta do estado durante a associação
+#define WIFI_LINK_CHECK_MS 1000       // Consulta do enlace já conectado
+
+typedef enum
+{
+    WIFI_STACK_DOWN = 0, // cyw43_arch_init ainda não funcionou
+    WIFI_BACKOFF,        // Esperando a próxima tentativa
+    WIFI_CONNECTING,     // Associação/DHCP em andamento
+    WIFI_CONNECTED
+} wifi_state;
+
+typedef enum
+{
+    WIFI_EVENT_NONE = 0,
+    WIFI_EVENT_STACK_READY, // lwIP disponível: PCBs já podem ser criados
+    WIFI_EVENT_LINK_UP,     // Associado e com endereço IP
+    WIFI_EVENT_LINK_DOWN    // Enlace perdido
+} wifi_event;
+
+// Função para iniciar o Wi-Fi sem bloquear (a associação continua em wifi_poll)
+void configure_wifi();
+
+// Avança a máquina de estados; retorna a transição ocorrida, se houver (chamar no laço principal)
+wifi_event wifi_poll();
+
+// Próximo instante em que wifi_poll() tem trabalho agendado
+absolute_time_t wifi_next_deadline();
+
+// Estado atual da conexão
+wifi_state wifi_get_state();
+
+// Nome do estado para display e métricas
+const char *wifi_state_name(wifi_state state);
+
+// true depois que o cyw43_arch_init funcionou (lwIP e lock disponíveis)
+bool wifi_stack_ready();
+
+// Tempo da última queda (ou do boot) até a conexão, em milissegundos
+uint32_t wifi_last_connect_ms();
+
+// Soma dos tempos até a conexão e número de conexões, para a média em /metrics
+uint64_t wifi_connect_total_ms();
+uint32_t wifi_connect_count();
+
+#endif
@@ -3,6 +3,7 @@
 
 #define WIDTH 128
 #define HEIGHT 64
+#define SSD1306_BUFFER_SIZE (WIDTH * HEIGHT / 8 + 1)
 
 typedef enum {
   SET_CONTRAST = 0x81,
@@ -44,5 +45,6 @@ void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value);
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
+const uint8_t *ssd1306_glyph(char c);
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
 void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
\ No newline at end of file
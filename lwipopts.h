@@ -21,7 +21,7 @@
 #define MEM_SIZE 32768
 #define MEMP_NUM_PBUF 16
 #define PBUF_POOL_SIZE 32               // Ajuste conforme necessário
-#define MEMP_NUM_UDP_PCB 4
+#define MEMP_NUM_UDP_PCB 5               // DHCP, DNS, telemetria, gateway e uma folga
 #define MEMP_NUM_TCP_PCB 4
 #define MEMP_NUM_TCP_SEG 16
 #define LWIP_IPV4 1
@@ -38,4 +38,10 @@
 #define LWIP_HTTPD_CGI 0           // Desative CGI para economizar memória
 #define LWIP_NETIF_HOSTNAME 1
 
+// Estatísticas do lwIP (uso dos pools e do heap), expostas em /metrics
+#define LWIP_STATS 1
+#define MEM_STATS 1
+#define MEMP_STATS 1
+#define LWIP_STATS_DISPLAY 0
+
 #endif /* LWIPOPTS_H */
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include "Accel.h"      // Núcleos com os aceleradores do SIO
+#include "ssd1306.h"    // Framebuffer do display (bench)
+#include "Chart.h"      // Dimensões do gráfico (bench)
+#include "Led_Matrix.h" // Linhas acesas da matriz (bench)
+
+#if PICO_ON_DEVICE
+#include "hardware/interp.h" // Interpoladores do SIO
+#endif
+
+#define BENCH_TEXT "Conectando..."
+
+// Copia colunas de 8 pixels (bit 0 em cima) para um framebuffer em
+// endereçamento vertical (pages bytes por coluna), a partir de (x, y)
+// qualquer; o que passa da borda é cortado (laço principal)
+void accel_blit_columns(uint8_t *frame, uint width, uint pages, const uint8_t *columns, uint count, uint x, uint y)
+{
+    uint page = y >> 3;
+    uint shift = y & 7;
+
+    if (page >= pages || x >= width)
+        return;
+    if (count > width - x)
+        count = width - x;
+
+    // Fora do alinhamento a coluna se divide entre duas páginas; a de baixo pode não existir
+    uint8_t low_mask = (uint8_t)(0xFF << shift);
+    uint8_t high_mask = (uint8_t)~(0xFF << shift);
+    bool spill = shift != 0 && page + 1 < pages;
+
+#if PICO_ON_DEVICE
+    // Pista 0 do interpolador 0 como contador de endereços: cada pop devolve
+    // frame + deslocamento (resultado completo = BASE2 + ACCUM0 + ACCUM1) e
+    // soma uma coluna (BASE0 = pages) ao acumulador
+    interp_config cfg = interp_default_config();
+    interp_set_config(interp0, 0, &cfg);
+    interp_set_config(interp0, 1, &cfg);
+    interp0->accum[0] = x * pages + page;
+    interp0->base[0] = pages;
+    interp0->accum[1] = 0;
+    interp0->base[1] = 0;
+    interp0->base[2] = (uintptr_t)frame;
+#else
+    uint8_t *next = frame + x * pages + page;
+#endif
+
+    for (uint i = 0; i < count; i++)
+    {
+#if PICO_ON_DEVICE
+        uint8_t *dst = (uint8_t *)interp_pop_full_result(interp0);
+#else
+        uint8_t *dst = next;
+        next += pages;
+#endif
+        uint8_t column = columns[i];
+
+        dst[0] = (dst[0] & ~low_mask) | (uint8_t)(column << shift);
+        if (spill)
+            dst[1] = (dst[1] & ~high_mask) | (uint8_t)(column >> (8 - shift));
+    }
+}
+
+// Referência: o caractere pixel a pixel, como o driver desenhava antes
+static void reference_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
+{
+    while (*str)
+    {
+        const uint8_t *glyph = ssd1306_glyph(*str++);
+
+        for (uint8_t i = 0; i < 8; ++i)
+        {
+            for (uint8_t j = 0; j < 8; ++j)
+                ssd1306_pixel(ssd, x + i, y + j, glyph[i] & (1 << j));
+        }
+
+        x += 8;
+        if (x + 8 >= ssd->width)
+        {
+            x = 0;
+            y += 8;
+        }
+        if (y + 8 >= ssd->height)
+            break;
+    }
+}
+
+static void reference_fill(ssd1306_t *ssd, bool value)
+{
+    for (uint8_t y = 0; y < ssd->height; ++y)
+    {
+        for (uint8_t x = 0; x < ssd->width; ++x)
+            ssd1306_pixel(ssd, x, y, value);
+    }
+}
+
+// Referência: linhas acesas da matriz em ponto flutuante, como antes
+static int reference_matrix_lines(uint8_t level, uint8_t threshold)
+{
+    int lines_on = (int)floor((double)level * 5 / threshold);
+    return lines_on > 5 ? 5 : lines_on;
+}
+
+static volatile uint32_t sink;
+
+// Tempo de uma rodada em ciclos do clock do sistema, por chamada
+static double cycles_per_call(uint64_t start_us, uint32_t calls)
+{
+    uint64_t elapsed_us = time_us_64() - start_us;
+    return (double)elapsed_us * (clock_get_hz(clk_sys) / 1000000u) / calls;
+}
+
+static void print_row(const char *name, double reference, double kernel, bool same)
+{
+    printf("%-22s %10.1f %10.1f %6.1fx  %s\n", name, reference, kernel,
+           kernel > 0 ? reference / kernel : 0.0, same ? "ok" : "DIFERENTE");
+}
+
+// Função para medir os núcleos contra as versões de referência (ciclos por chamada no console)
+void accel_bench()
+{
+    static uint8_t reference_buffer[SSD1306_BUFFER_SIZE];
+    static uint8_t kernel_buffer[SSD1306_BUFFER_SIZE];
+    ssd1306_t reference = {.width = WIDTH, .height = HEIGHT, .pages = HEIGHT / 8, .ram_buffer = reference_buffer, .bufsize = SSD1306_BUFFER_SIZE};
+    ssd1306_t kernel = reference;
+    kernel.ram_buffer = kernel_buffer;
+    uint64_t start;
+    double before, after;
+    bool same;
+
+    printf("núcleo                  referência     núcleo  ganho  (ciclos a %lu MHz%s)\n",
+           (unsigned long)(clock_get_hz(clk_sys) / 1000000u), PICO_ON_DEVICE ? "" : ", simulação: versões portáteis");
+
+    // Texto fora do alinhamento de página (o caso do display, y = 5)
+    const uint32_t text_calls = 500;
+    memset(reference_buffer, 0x5A, sizeof(reference_buffer));
+    memset(kernel_buffer, 0x5A, sizeof(kernel_buffer));
+    start = time_us_64();
+    for (uint32_t i = 0; i < text_calls; i++)
+        reference_draw_string(&reference, BENCH_TEXT, 5, 5);
+    before = cycles_per_call(start, text_calls);
+    start = time_us_64();
+    for (uint32_t i = 0; i < text_calls; i++)
+        ssd1306_draw_string(&kernel, BENCH_TEXT, 5, 5);
+    after = cycles_per_call(start, text_calls);
+    same = memcmp(reference_buffer, kernel_buffer, sizeof(reference_buffer)) == 0;
+    print_row("texto (13 caracteres)", before, after, same);
+
+    // Texto alinhado e com quebra de linha
+    reference_draw_string(&reference, BENCH_TEXT BENCH_TEXT, 0, 48);
+    ssd1306_draw_string(&kernel, BENCH_TEXT BENCH_TEXT, 0, 48);
+    same = memcmp(reference_buffer, kernel_buffer, sizeof(reference_buffer)) == 0;
+    printf("%-22s %s\n", "texto alinhado/quebra", same ? "ok" : "DIFERENTE");
+
+    const uint32_t fill_calls = 50;
+    start = time_us_64();
+    for (uint32_t i = 0; i < fill_calls; i++)
+        reference_fill(&reference, i & 1);
+    before = cycles_per_call(start, fill_calls);
+    start = time_us_64();
+    for (uint32_t i = 0; i < fill_calls; i++)
+        ssd1306_fill(&kernel, i & 1);
+    after = cycles_per_call(start, fill_calls);
+    same = memcmp(reference_buffer, kernel_buffer, sizeof(reference_buffer)) == 0;
+    print_row("limpar o display", before, after, same);
+
+    // Linhas da matriz em todos os pares (nível, limiar > 0)
+    const uint32_t level_calls = 256 * 255;
+    same = true;
+    for (uint32_t t = 1; t < 256; t++)
+    {
+        for (uint32_t level = 0; level < 256; level++)
+            same &= reference_matrix_lines(level, t) == matrix_lines_on(level, t);
+    }
+    start = time_us_64();
+    for (uint32_t t = 1; t < 256; t++)
+    {
+        for (uint32_t level = 0; level < 256; level++)
+            sink = reference_matrix_lines(level, t);
+    }
+    before = cycles_per_call(start, level_calls);
+    start = time_us_64();
+    for (uint32_t t = 1; t < 256; t++)
+    {
+        for (uint32_t level = 0; level < 256; level++)
+            sink = matrix_lines_on(level, t);
+    }
+    after = cycles_per_call(start, level_calls);
+    print_row("linhas da matriz", before, after, same);
+
+    // Escala do gráfico: cada topo possível com todos os níveis abaixo dele
+    const uint32_t max_top = 255 + 255 / 5 + 1;
+    uint32_t scale_calls = 0;
+    same = true;
+    for (uint32_t top = 1; top <= max_top; top++)
+    {
+        accel_scale scale = accel_scale_init(CHART_HEIGHT, top);
+        for (uint32_t level = 0; level < top; level++)
+            same &= level * CHART_HEIGHT / top == accel_scale_apply(scale, level);
+        scale_calls += top;
+    }
+    start = time_us_64();
+    for (uint32_t top = 1; top <= max_top; top++)
+    {
+        for (uint32_t level = 0; level < top; level++)
+            sink = level * CHART_HEIGHT / top;
+    }
+    before = cycles_per_call(start, scale_calls);
+    start = time_us_64();
+    for (uint32_t top = 1; top <= max_top; top++)
+    {
+        accel_scale scale = accel_scale_init(CHART_HEIGHT, top);
+        for (uint32_t level = 0; level < top; level++)
+            sink = accel_scale_apply(scale, level);
+    }
+    after = cycles_per_call(start, scale_calls);
+    print_row("escala do gráfico", before, after, same);
+}
@@ -0,0 +1,130 @@
+#include "Admission.h" // Controle de admissão do servidor HTTP
+#include "Metrics.h"   // Contadores de atendidos e recusados
+#include "lwip/stats.h" // Ocupação do pool de PCBs TCP
+
+#define TOKEN_ONE 1000u // Uma ficha do balde, em milifichas
+
+// Balde de renderizações da página, em milifichas
+static uint32_t tokens = HTTP_PAGE_BURST * TOKEN_ONE;
+static uint64_t refilled_us = 0; // Instante até o qual a reposição já foi creditada
+
+// Credita as fichas do tempo decorrido, sem perder as frações
+static void refill()
+{
+    uint64_t now = time_us_64();
+    uint64_t gained = (now - refilled_us) * HTTP_PAGE_RATE / 1000;
+
+    if (tokens + gained >= HTTP_PAGE_BURST * TOKEN_ONE)
+    {
+        tokens = HTTP_PAGE_BURST * TOKEN_ONE;
+        refilled_us = now;
+        return;
+    }
+
+    tokens += (uint32_t)gained;
+    refilled_us += gained * 1000 / HTTP_PAGE_RATE;
+}
+
+// Segundos até o balde ter uma ficha inteira (Retry-After, no mínimo 1)
+static uint32_t retry_after()
+{
+    uint64_t wait_us = (uint64_t)(TOKEN_ONE - tokens) * 1000 / HTTP_PAGE_RATE;
+
+    return (uint32_t)((wait_us + 999999) / 1000000) + (wait_us == 0);
+}
+
+// PCBs TCP livres no pool do lwIP: as conexões HTTP dividem o pool com os
+// clientes MQTT e webhook e com os PCBs em TIME_WAIT dos fechamentos ativos
+static uint free_tcp_pcbs()
+{
+    const struct stats_mem *stats = lwip_stats.memp[MEMP_TCP_PCB];
+
+    return stats->used < stats->avail ? stats->avail - stats->used : 0;
+}
+
+// true se a linha inicial do request contém text
+static bool request_line_has(const char *request, const char *text)
+{
+    size_t len = strlen(text);
+
+    for (const char *c = request; *c && *c != '\r' && *c != '\n'; c++)
+    {
+        if (strncmp(c, text, len) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+// Classifica o request pela linha inicial
+http_route admission_route(const char *request)
+{
+    if (strncmp(request, "POST /api/actuators", 19) == 0)
+        return HTTP_ROUTE_CONTROL;
+
+    if (strncmp(request, "GET /metrics", 12) == 0 || strncmp(request, "GET /api/fleet", 14) == 0 ||
+        strncmp(request, "GET /api/postmortem", 19) == 0)
+        return HTTP_ROUTE_API;
+
+    // Formulário: o comando vem na query da linha GET (os cabeçalhos, como o Referer, não contam)
+    if (request_line_has(request, "periferico="))
+        return HTTP_ROUTE_CONTROL;
+
+    return HTTP_ROUTE_PAGE;
+}
+
+// Decide a admissão de uma conexão nova; from_client = conexões já abertas pelo mesmo IP
+bool admission_accept(bool slot_free, uint from_client)
+{
+    if (!slot_free)
+    {
+        metrics_inc(METRIC_HTTP_SHED_FULL);
+        return false;
+    }
+
+    if (from_client >= HTTP_MAX_PER_CLIENT)
+    {
+        metrics_inc(METRIC_HTTP_SHED_CLIENT);
+        return false;
+    }
+
+    return true;
+}
+
+// Decide o request; render = a página precisa ser gerada. Retorna 0 se admitido, senão os segundos do Retry-After
+uint32_t admission_request(http_route route, bool render)
+{
+    if (route != HTTP_ROUTE_PAGE)
+    {
+        metrics_inc(route == HTTP_ROUTE_CONTROL ? METRIC_HTTP_SERVED_CONTROL : METRIC_HTTP_SERVED_API);
+        return 0;
+    }
+
+    // A página não ocupa a reserva dos comandos e APIs
+    if (free_tcp_pcbs() < HTTP_RESERVED_SLOTS)
+    {
+        metrics_inc(METRIC_HTTP_SHED_RESERVED);
+        return 1;
+    }
+
+    // Servir do cache é barato; só a renderização gasta ficha
+    if (render)
+    {
+        refill();
+        if (tokens < TOKEN_ONE)
+        {
+            metrics_inc(METRIC_HTTP_SHED_RATE);
+            return retry_after();
+        }
+        tokens -= TOKEN_ONE;
+    }
+
+    metrics_inc(METRIC_HTTP_SERVED_PAGE);
+    return 0;
+}
+
+// Conexão ociosa (sem request) derrubada pelo lwIP para admitir outra
+void admission_evicted()
+{
+    metrics_inc(METRIC_HTTP_SHED_EVICTED);
+}
@@ -0,0 +1,86 @@
+#include "Boot.h" // Linha do tempo do boot
+
+#define BOOT_NOT_SET UINT32_MAX
+
+static volatile uint32_t stage_start[BOOT_STAGE_COUNT] = {
+    [0 ... BOOT_STAGE_COUNT - 1] = BOOT_NOT_SET,
+    [BOOT_STAGE_RUNTIME] = 0, // O temporizador conta desde o reset
+};
+static volatile uint32_t stage_end[BOOT_STAGE_COUNT] = {[0 ... BOOT_STAGE_COUNT - 1] = BOOT_NOT_SET};
+
+static const char *const stage_names[BOOT_STAGE_COUNT] = {
+    [BOOT_STAGE_RUNTIME] = "runtime",
+    [BOOT_STAGE_CLOCKS] = "clocks",
+    [BOOT_STAGE_CONFIG] = "config",
+    [BOOT_STAGE_INPUTS] = "inputs",
+    [BOOT_STAGE_OUTPUTS] = "outputs",
+    [BOOT_STAGE_DISPLAY] = "display",
+    [BOOT_STAGE_WIFI_STACK] = "wifi_stack",
+    [BOOT_STAGE_WIFI_LINK] = "wifi_link",
+    [BOOT_STAGE_HTTP] = "http",
+};
+
+// Marca o início de uma etapa (ignorado se ela já começou)
+void boot_stage_begin(boot_stage stage)
+{
+    if (stage_start[stage] == BOOT_NOT_SET)
+        stage_start[stage] = time_us_32();
+}
+
+// Marca o fim de uma etapa (ignorado se ela já terminou)
+void boot_stage_end(boot_stage stage)
+{
+    uint32_t now = time_us_32();
+
+    if (stage_end[stage] != BOOT_NOT_SET)
+        return;
+
+    if (stage_start[stage] == BOOT_NOT_SET)
+        stage_start[stage] = now;
+    stage_end[stage] = now;
+}
+
+// true se a etapa já terminou
+bool boot_stage_done(boot_stage stage)
+{
+    return stage_end[stage] != BOOT_NOT_SET;
+}
+
+// Início e duração da etapa em microssegundos; false se ela ainda não terminou
+bool boot_stage_time(boot_stage stage, uint32_t *start_us, uint32_t *duration_us)
+{
+    uint32_t end = stage_end[stage];
+
+    if (end == BOOT_NOT_SET)
+        return false;
+
+    *start_us = stage_start[stage];
+    *duration_us = end - *start_us;
+    return true;
+}
+
+// Nome da etapa (rótulo "stage" do /metrics)
+const char *boot_stage_name(boot_stage stage)
+{
+    return stage < BOOT_STAGE_COUNT ? stage_names[stage] : "?";
+}
+
+// Função para imprimir a linha do tempo do boot no console
+void boot_report()
+{
+    printf("# boot (us desde o reset)\n");
+    printf("%-11s %10s %10s %10s\n", "etapa", "inicio", "fim", "duracao");
+
+    for (boot_stage s = 0; s < BOOT_STAGE_COUNT; s++)
+    {
+        uint32_t start, duration;
+
+        if (boot_stage_time(s, &start, &duration))
+            printf("%-11s %10lu %10lu %10lu\n", stage_names[s],
+                   (unsigned long)start, (unsigned long)(start + duration), (unsigned long)duration);
+        else if (stage_start[s] != BOOT_NOT_SET)
+            printf("%-11s %10lu %10s %10s\n", stage_names[s], (unsigned long)stage_start[s], "-", "-");
+        else
+            printf("%-11s %10s %10s %10s\n", stage_names[s], "-", "-", "-");
+    }
+}
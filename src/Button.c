@@ -1,4 +1,12 @@
 #include "Button.h"    // Header com definições relacionadas aos botões
+#include "Metrics.h"   // Contagem de interrupções por botão
+#include "Trace.h"     // Rastreamento de eventos
+#include "Idle.h"      // Acorda o laço principal
+#include "hardware/sync.h" // Barreiras de memória da fila
+
+static button_event queue[BUTTON_QUEUE_SIZE];
+static volatile uint32_t queue_head = 0; // Escrito só pela IRQ
+static volatile uint32_t queue_tail = 0; // Escrito só pelo laço principal
 
 // Função para configurar os botões com interrupções
 void configure_button(uint8_t button)
@@ -6,4 +14,82 @@ void configure_button(uint8_t button)
     gpio_init(button); // Inicializa o GPIO do botão
     gpio_set_dir(button, GPIO_IN); // Configura como entrada
     gpio_pull_up(button); // Habilita pull-up interno
-}
\ No newline at end of file
+}
+
+// Fim da janela de debounce: descarta as bordas latchadas e religa a IRQ do pino
+static int64_t debounce_done(alarm_id_t id, void *user_data)
+{
+    uint gpio = (uint)(uintptr_t)user_data;
+
+    gpio_acknowledge_irq(gpio, GPIO_IRQ_EDGE_FALL);
+    gpio_set_irq_enabled(gpio, GPIO_IRQ_EDGE_FALL, true);
+
+    return 0; // Não reagenda
+}
+
+static void count_irq(uint gpio)
+{
+    if (gpio == BUTTON_A)
+        metrics_inc(METRIC_GPIO_IRQ_BUTTON_A);
+    else if (gpio == BUTTON_B)
+        metrics_inc(METRIC_GPIO_IRQ_BUTTON_B);
+    else if (gpio == BUTTON_J)
+        metrics_inc(METRIC_GPIO_IRQ_BUTTON_J);
+}
+
+// IRQ de GPIO: registra a borda e inicia a janela de debounce; o tratamento fica para o laço principal
+static void button_irq(uint gpio, uint32_t events)
+{
+    TRACE_BEGIN_ARG(TRACE_GPIO_IRQ, gpio);
+
+    count_irq(gpio);
+
+    uint32_t head = queue_head;
+
+    if (head - queue_tail < BUTTON_QUEUE_SIZE)
+    {
+        button_event *event = &queue[head & (BUTTON_QUEUE_SIZE - 1)];
+        event->gpio = gpio;
+        event->edge = events & GPIO_IRQ_EDGE_FALL ? GPIO_IRQ_EDGE_FALL : GPIO_IRQ_EDGE_RISE;
+        event->time_us = time_us_64();
+
+        // O registro precisa estar completo antes de o consumidor ver o novo head
+        __dmb();
+        queue_head = head + 1;
+    }
+    else
+    {
+        metrics_inc(METRIC_BUTTON_EVENTS_DROPPED);
+    }
+
+    // Sem alarme livre a IRQ continua ligada (sem debounce) em vez de perder o botão
+    gpio_set_irq_enabled(gpio, GPIO_IRQ_EDGE_FALL, false);
+    if (add_alarm_in_us(DEBOUNCE_DELAY, debounce_done, (void *)(uintptr_t)gpio, true) < 0)
+        gpio_set_irq_enabled(gpio, GPIO_IRQ_EDGE_FALL, true);
+
+    idle_wake();
+
+    TRACE_END(TRACE_GPIO_IRQ);
+}
+
+// Função para habilitar a IRQ de borda de descida do botão, com debounce por alarme
+void button_enable_irq(uint8_t button)
+{
+    gpio_set_irq_enabled_with_callback(button, GPIO_IRQ_EDGE_FALL, true, &button_irq);
+}
+
+// Retira o evento mais antigo da fila (chamar no laço principal); false se vazia
+bool button_pop(button_event *event)
+{
+    uint32_t tail = queue_tail;
+
+    if (tail == queue_head)
+        return false;
+
+    __dmb();
+    *event = queue[tail & (BUTTON_QUEUE_SIZE - 1)];
+    __dmb();
+    queue_tail = tail + 1;
+
+    return true;
+}
@@ -1,4 +1,5 @@
 #include "Buzzer.h"  // Inclusão do cabeçalho com definições do buzzer
+#include "Trace.h"   // Rastreamento de eventos
 
 // Função para configurar o buzzer utilizando PWM
 void configure_buzzer()
@@ -17,14 +18,37 @@ void set_buzzer_level(uint gpio, uint16_t level)
     pwm_set_chan_level(slice_num, pwm_gpio_to_channel(gpio), level);
 }
 
-// Função para emitir um alerta sonoro (beep) utilizando o buzzer
-void beep_alert()
+// Função para avançar o alerta sonoro sem bloquear; retorna o prazo da próxima troca
+absolute_time_t buzzer_alert_poll(bool active)
 {
-    for (int i = 0; i < 5; i++)
+    static bool beeping = false;
+    static absolute_time_t next_toggle;
+
+    if (!active)
     {
-        set_buzzer_level(BUZZER_A, WRAP_PWM_BUZZER / 90);
-        sleep_ms(100);
-        set_buzzer_level(BUZZER_A, 0);
-        sleep_ms(100);;
+        if (beeping)
+        {
+            set_buzzer_level(BUZZER_A, 0);
+            beeping = false;
+            TRACE_END(TRACE_BUZZER_BEEP);
+        }
+
+        next_toggle = get_absolute_time();
+        return at_the_end_of_time;
     }
-}
\ No newline at end of file
+
+    if (absolute_time_diff_us(get_absolute_time(), next_toggle) > 0)
+        return next_toggle;
+
+    // Bipes e pausas alternados de BUZZER_BEEP_MS
+    beeping = !beeping;
+    set_buzzer_level(BUZZER_A, beeping ? WRAP_PWM_BUZZER / 90 : 0);
+
+    if (beeping)
+        TRACE_BEGIN(TRACE_BUZZER_BEEP);
+    else
+        TRACE_END(TRACE_BUZZER_BEEP);
+
+    next_toggle = make_timeout_time_ms(BUZZER_BEEP_MS);
+    return next_toggle;
+}
@@ -0,0 +1,73 @@
+#include "Cache.h"   // Cache de respostas renderizadas
+#include "Metrics.h" // Contadores de desempenho
+
+static cache_entry entries[CACHE_SLOTS];
+
+// Entrada com o corpo de render para version (renderizado agora se preciso); NULL se não houver entrada livre ou o corpo não couber
+const cache_entry *cache_acquire(cache_render_fn render, uint64_t version)
+{
+    cache_entry *victim = NULL;
+
+    for (int i = 0; i < CACHE_SLOTS; i++)
+    {
+        cache_entry *entry = &entries[i];
+
+        if (entry->render == render && entry->version == version)
+        {
+            entry->readers++;
+            metrics_inc(METRIC_CACHE_HITS);
+            return entry;
+        }
+
+        // Prefere uma entrada vazia; senão qualquer uma sem leitores
+        if (entry->readers == 0 && (!victim || victim->render))
+            victim = entry;
+    }
+
+    // Todas as entradas ainda estão sendo enviadas: o chamador gera a resposta sem cache
+    if (!victim)
+    {
+        metrics_inc(METRIC_CACHE_BYPASS);
+        return NULL;
+    }
+
+    uint32_t render_start = time_us_32();
+
+    victim->render = NULL;
+    victim->len = render(victim->body, sizeof(victim->body));
+
+    metrics_inc(METRIC_CACHE_RENDERS);
+    metrics_observe(METRIC_HTTP_RENDER_TIME, time_us_32() - render_start);
+
+    if (victim->len == 0)
+    {
+        metrics_inc(METRIC_CACHE_BYPASS);
+        return NULL;
+    }
+
+    victim->render = render;
+    victim->version = version;
+    victim->readers = 1;
+    return victim;
+}
+
+// Devolve uma entrada obtida com cache_acquire()
+void cache_release(const cache_entry *entry)
+{
+    cache_entry *owned = (cache_entry *)entry;
+
+    if (owned && owned->readers > 0)
+        owned->readers--;
+}
+
+// true se cache_acquire(render, version) sairia sem renderizar
+bool cache_fresh(cache_render_fn render, uint64_t version)
+{
+    for (int i = 0; i < CACHE_SLOTS; i++)
+    {
+        if (entries[i].render == render && entries[i].version == version)
+            return true;
+    }
+
+    return false;
+}
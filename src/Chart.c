@@ -0,0 +1,119 @@
+#include "Chart.h" // Gráfico SVG do histórico
+#include "Accel.h" // Escala sem divisão por ponto
+
+#define CHART_STR_(x) #x
+#define CHART_STR(x) CHART_STR_(x) // Dimensões da grade como texto
+
+// Escalas do gráfico, calculadas uma vez por SVG (uma divisão cada)
+typedef struct
+{
+    uint32_t top;       // Nível no topo da grade
+    accel_scale level;  // Nível -> linhas (CHART_HEIGHT / top)
+    accel_scale x;      // Coluna -> x (CHART_WIDTH / (colunas - 1))
+    accel_scale sample; // Coluna -> primeira amostra (amostras / colunas)
+} chart_scales;
+
+// Linha da grade para um nível (0 no topo)
+static int chart_y(uint32_t level, const chart_scales *scales)
+{
+    if (level >= scales->top)
+        return 0;
+
+    return CHART_HEIGHT - (int)accel_scale_apply(scales->level, level);
+}
+
+// Maior amostra da coluna (a redução mantém os picos)
+static uint8_t column_max(const uint8_t *samples, const chart_scales *scales, uint column)
+{
+    uint first = accel_scale_apply(scales->sample, column);
+    uint last = accel_scale_apply(scales->sample, column + 1);
+    uint8_t max = samples[first];
+
+    for (uint i = first + 1; i < last; i++)
+    {
+        if (samples[i] > max)
+            max = samples[i];
+    }
+
+    return max;
+}
+
+static void put_point(template_writer *w, int x, int y)
+{
+    template_put_int(w, x);
+    template_put_str(w, ",");
+    template_put_int(w, y);
+}
+
+static void put_rect(template_writer *w, const char *class, int y, int height)
+{
+    if (height <= 0)
+        return;
+
+    template_put_str(w, "<rect class='");
+    template_put_str(w, class);
+    template_put_str(w, "' y='");
+    template_put_int(w, y);
+    template_put_str(w, "' width='" CHART_STR(CHART_WIDTH) "' height='");
+    template_put_int(w, height);
+    template_put_str(w, "'/>");
+}
+
+// Pontos da linha, da coluna mais antiga para a mais recente
+static void put_points(template_writer *w, const uint8_t *samples, uint columns, const chart_scales *scales)
+{
+    for (uint c = 0; c < columns; c++)
+    {
+        int x = columns > 1 ? (int)accel_scale_apply(scales->x, c) : 0;
+
+        if (c > 0)
+            template_put_str(w, " ");
+        put_point(w, x, chart_y(column_max(samples, scales, c), scales));
+    }
+
+    // Uma amostra só vira uma reta na largura toda
+    if (columns == 1)
+    {
+        template_put_str(w, " ");
+        put_point(w, CHART_WIDTH, chart_y(samples[0], scales));
+    }
+}
+
+// Escreve o SVG do histórico (até 255 amostras) com as faixas de atenção e alerta da região
+void chart_write_svg(template_writer *w, const uint8_t *samples, uint count, const region_state *region)
+{
+    uint columns = count < CHART_WIDTH ? count : CHART_WIDTH;
+    uint32_t top = region->alert_threshold;
+
+    if (count == 0)
+        return;
+
+    for (uint i = 0; i < count; i++)
+    {
+        if (samples[i] > top)
+            top = samples[i];
+    }
+    top += top / 5 + 1; // Folga acima do alerta ou do pico
+
+    chart_scales scales = {
+        .top = top,
+        .level = accel_scale_init(CHART_HEIGHT, top),
+        .x = accel_scale_init(CHART_WIDTH, columns > 1 ? columns - 1 : 1),
+        .sample = accel_scale_init(count, columns),
+    };
+    int alert_y = chart_y(region->alert_threshold, &scales);
+    int attention_y = chart_y(region->attention_threshold, &scales);
+
+    template_put_str(w, "<svg class='ch' viewBox='0 0 " CHART_STR(CHART_WIDTH) " " CHART_STR(CHART_HEIGHT) "' preserveAspectRatio='none'>");
+    put_rect(w, "al", 0, alert_y);
+    put_rect(w, "at", alert_y, attention_y - alert_y);
+
+    // Área: a mesma linha fechada pela base do gráfico
+    template_put_str(w, "<path class='ar' d='M0," CHART_STR(CHART_HEIGHT) "L");
+    put_points(w, samples, columns, &scales);
+    template_put_str(w, "L" CHART_STR(CHART_WIDTH) "," CHART_STR(CHART_HEIGHT) "Z'/><polyline class='ln' points='");
+    put_points(w, samples, columns, &scales);
+    template_put_str(w, "'/></svg><br><small>0 a ");
+    template_put_int(w, (int32_t)top);
+    template_put_str(w, " m</small>");
+}
@@ -0,0 +1,206 @@
+#include "Config.h"         // Estado persistente das regiões
+#include "Metrics.h"        // Contadores de desempenho
+#include "hardware/sync.h" // Interrupções desabilitadas durante a gravação
+
+typedef struct
+{
+    uint8_t current_level;
+    uint8_t attention_threshold;
+    uint8_t alert_threshold;
+    uint8_t buzzer_on;
+    led_color led_color;
+    uint8_t led_status; // peripheral do último comando de LED
+    uint8_t led_status_on;
+    uint8_t reserved[3];
+} config_region;
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t seq;
+    uint16_t version;
+    uint8_t is_region_A;
+    uint8_t reserved;
+    config_region regions[2];
+    uint32_t crc; // CRC-32 de todos os campos anteriores
+} config_record;
+
+_Static_assert(sizeof(config_record) <= FLASH_PAGE_SIZE, "registro maior que uma página da flash");
+
+static config_record saved;           // Último estado gravado (ou restaurado)
+static uint next_slot = CONFIG_SLOTS; // Próxima página livre; CONFIG_SLOTS força apagar o setor
+static bool save_pending = false;
+static absolute_time_t save_time;
+
+// Página do diário, lida diretamente da flash
+static const uint8_t *slot_data(uint slot)
+{
+    uint32_t offset = CONFIG_FLASH_OFFSET + slot * FLASH_PAGE_SIZE;
+
+#if PICO_ON_DEVICE
+    return (const uint8_t *)(XIP_BASE + offset);
+#else
+    return host_flash_contents(offset);
+#endif
+}
+
+static bool slot_valid(const config_record *record)
+{
+    return record->magic == CONFIG_MAGIC && record->version == CONFIG_VERSION &&
+           record->crc == crc32((const uint8_t *)record, offsetof(config_record, crc));
+}
+
+static bool slot_blank(uint slot)
+{
+    const uint8_t *data = slot_data(slot);
+
+    for (uint i = 0; i < FLASH_PAGE_SIZE; i++)
+    {
+        if (data[i] != 0xFF)
+            return false;
+    }
+
+    return true;
+}
+
+static void capture_region(config_region *out, const region_state *region)
+{
+    out->current_level = region->current_level;
+    out->attention_threshold = region->attention_threshold;
+    out->alert_threshold = region->alert_threshold;
+    out->buzzer_on = region->buzzer_on;
+    out->led_color = region->led_color;
+    out->led_status = region->led_status;
+    out->led_status_on = region->led_status_on;
+}
+
+static void restore_region(region_state *region, const config_region *in)
+{
+    region->current_level = in->current_level;
+    region->attention_threshold = in->attention_threshold;
+    region->alert_threshold = in->alert_threshold;
+    region->buzzer_on = in->buzzer_on != 0;
+    region->led_color = in->led_color;
+    region->led_status = in->led_status < PERIPHERAL_BUZZER ? in->led_status : PERIPHERAL_LED_NORMAL;
+    region->led_status_on = in->led_status_on != 0;
+}
+
+// Último estado publicado, com os campos de controle zerados (comparável com memcmp)
+static void capture_state(config_record *record)
+{
+    state_snapshot view;
+
+    read_state(&view);
+
+    memset(record, 0, sizeof(*record));
+    record->is_region_A = view.is_region_A;
+    capture_region(&record->regions[0], &view.regions[0]);
+    capture_region(&record->regions[1], &view.regions[1]);
+}
+
+static bool same_state(const config_record *a, const config_record *b)
+{
+    return a->is_region_A == b->is_region_A && memcmp(a->regions, b->regions, sizeof(a->regions)) == 0;
+}
+
+// Restaura as regiões a partir da flash (chamar depois de init_regions); false se não houver registro
+bool config_load()
+{
+    const config_record *newest = NULL;
+    uint newest_slot = 0;
+
+    for (uint slot = 0; slot < CONFIG_SLOTS; slot++)
+    {
+        const config_record *record = (const config_record *)slot_data(slot);
+
+        if (slot_valid(record) && (!newest || record->seq > newest->seq))
+        {
+            newest = record;
+            newest_slot = slot;
+        }
+    }
+
+    if (!newest)
+    {
+        capture_state(&saved); // Padrões de init_regions: nada a gravar até a primeira mudança
+        return false;
+    }
+
+    saved = *newest;
+    next_slot = newest_slot + 1;
+
+    restore_region(&region_A, &saved.regions[0]);
+    restore_region(&region_B, &saved.regions[1]);
+    is_region_A = saved.is_region_A != 0;
+    publish_state();
+
+    return true;
+}
+
+static void config_write(config_record *record)
+{
+    static uint8_t page[FLASH_PAGE_SIZE];
+
+    record->magic = CONFIG_MAGIC;
+    record->version = CONFIG_VERSION;
+    record->seq = saved.seq + 1;
+    record->crc = crc32((const uint8_t *)record, offsetof(config_record, crc));
+
+    memset(page, 0xFF, sizeof(page));
+    memcpy(page, record, sizeof(*record));
+
+    // Página já usada (ex.: gravação interrompida por queda de energia) conta como cheia
+    bool erase = next_slot >= CONFIG_SLOTS || !slot_blank(next_slot);
+
+    if (erase)
+        next_slot = 0;
+
+    uint32_t offset = CONFIG_FLASH_OFFSET + next_slot * FLASH_PAGE_SIZE;
+    uint32_t interrupts = save_and_disable_interrupts();
+
+    if (erase)
+        flash_range_erase(CONFIG_FLASH_OFFSET, FLASH_SECTOR_SIZE);
+    flash_range_program(offset, page, FLASH_PAGE_SIZE);
+
+    restore_interrupts(interrupts);
+
+    if (erase)
+        metrics_inc(METRIC_CONFIG_ERASES);
+    metrics_inc(METRIC_CONFIG_WRITES);
+
+    saved = *record;
+    next_slot++;
+}
+
+// Grava o estado quando o atraso após uma mudança expira (chamar no laço principal)
+void config_poll()
+{
+    config_record current;
+
+    capture_state(&current);
+
+    if (same_state(&current, &saved))
+    {
+        save_pending = false;
+        return;
+    }
+
+    if (!save_pending)
+    {
+        save_pending = true;
+        save_time = make_timeout_time_ms(CONFIG_SAVE_DELAY_MS);
+        return;
+    }
+
+    if (absolute_time_diff_us(get_absolute_time(), save_time) > 0)
+        return;
+
+    save_pending = false;
+    config_write(&current);
+}
+
+// Próximo instante em que config_poll() tem trabalho agendado
+absolute_time_t config_next_deadline()
+{
+    return save_pending ? save_time : at_the_end_of_time;
+}
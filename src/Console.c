@@ -0,0 +1,54 @@
+#include "Console.h"    // Comandos do console USB
+#include "Trace.h"      // Rastreamento de eventos
+#include "Memory.h"     // Orçamento de memória
+#include "Boot.h"       // Linha do tempo do boot
+#include "Stream.h"     // Stream binário de amostras
+#include "Accel.h"      // Benchmark dos núcleos acelerados
+#include "Supervisor.h" // Watchdog e post-mortem
+
+typedef struct
+{
+    char key;
+    const char *description;
+    void (*handler)();
+} console_command;
+
+static void print_help();
+
+static const console_command commands[] = {
+    {'T', "despeja o anel de trace", trace_dump},
+    {'C', "limpa o anel de trace", trace_clear},
+    {'M', "relatório de memória (pilhas, pools e heaps)", memory_report},
+    {'B', "linha do tempo do boot", boot_report},
+    {'S', "liga/desliga o stream binário de amostras (tools/stream_capture.py)", stream_toggle},
+    {'K', "mede os núcleos do divisor/interpolador contra as referências (bloqueia ~1 s)", accel_bench},
+    {'W', "post-mortem do último reset pelo watchdog e tempos do laço", supervisor_report},
+    {'X', "trava o laço de propósito para testar o watchdog (reinicia o nó)", supervisor_stall_test},
+    {'?', "lista os comandos", print_help},
+};
+
+#define COMMAND_COUNT (sizeof(commands) / sizeof(commands[0]))
+
+static void print_help()
+{
+    for (size_t i = 0; i < COMMAND_COUNT; i++)
+        printf("%c  %s\n", commands[i].key, commands[i].description);
+}
+
+// Função para ler e executar os comandos pendentes no console
+void console_poll()
+{
+    int c;
+
+    while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT)
+    {
+        for (size_t i = 0; i < COMMAND_COUNT; i++)
+        {
+            if (commands[i].key == c)
+            {
+                commands[i].handler();
+                break;
+            }
+        }
+    }
+}
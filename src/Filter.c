@@ -0,0 +1,131 @@
+#include "Filter.h" // Filtro de picos (mediana, MAD e média exponencial)
+
+// Função para iniciar o filtro vazio
+void filter_init(level_filter *filter)
+{
+    memset(filter, 0, sizeof(*filter));
+}
+
+// Troca a amostra mais antiga pela nova na janela ordenada, deslocando só o trecho entre as duas
+static void window_replace(level_filter *filter, int32_t old, int32_t sample)
+{
+    int32_t *sorted = filter->sorted;
+    int i = 0;
+
+    while (sorted[i] != old)
+        i++;
+
+    while (i > 0 && sorted[i - 1] > sample)
+    {
+        sorted[i] = sorted[i - 1];
+        i--;
+    }
+    while (i < filter->count - 1 && sorted[i + 1] < sample)
+    {
+        sorted[i] = sorted[i + 1];
+        i++;
+    }
+
+    sorted[i] = sample;
+}
+
+static void window_insert(level_filter *filter, int32_t sample)
+{
+    int i = filter->count++;
+
+    while (i > 0 && filter->sorted[i - 1] > sample)
+    {
+        filter->sorted[i] = filter->sorted[i - 1];
+        i--;
+    }
+
+    filter->sorted[i] = sample;
+}
+
+// Mediana da janela atual (Q8)
+int32_t filter_median(const level_filter *filter)
+{
+    uint8_t n = filter->count;
+
+    if (n == 0)
+        return 0;
+
+    return n & 1 ? filter->sorted[n / 2] : (filter->sorted[n / 2 - 1] + filter->sorted[n / 2]) / 2;
+}
+
+// Desvio absoluto mediano da janela atual (Q8)
+int32_t filter_mad(const level_filter *filter)
+{
+    const int32_t *sorted = filter->sorted;
+    uint8_t n = filter->count;
+    int32_t median = filter_median(filter);
+    int32_t deviation = 0;
+
+    if (n == 0)
+        return 0;
+
+    // Os desvios crescem a partir da mediana para os dois lados da janela
+    // ordenada: intercalar os dois lados dá os desvios em ordem, sem ordenar
+    int left = (n - 1) / 2;
+    int right = left + 1;
+
+    for (int k = 0; k <= (n - 1) / 2; k++)
+    {
+        int32_t dl = left >= 0 ? median - sorted[left] : INT32_MAX;
+        int32_t dr = right < n ? sorted[right] - median : INT32_MAX;
+
+        if (dl <= dr)
+        {
+            deviation = dl;
+            left--;
+        }
+        else
+        {
+            deviation = dr;
+            right++;
+        }
+    }
+
+    return deviation;
+}
+
+// Processa uma amostra (Q8) e retorna a saída filtrada (Q8)
+int32_t filter_push(level_filter *filter, int32_t sample)
+{
+    int32_t accepted = sample;
+
+    filter->samples++;
+
+    // O teste usa a janela anterior à amostra: um pico isolado não a influencia
+    if (filter->count == FILTER_WINDOW)
+    {
+        int32_t median = filter_median(filter);
+        int32_t limit = FILTER_REJECT_K * ((filter_mad(filter) * FILTER_MAD_SCALE) >> FILTER_FRAC_BITS);
+        int32_t distance = sample > median ? sample - median : median - sample;
+
+        if (limit < FILTER_MIN_DEVIATION)
+            limit = FILTER_MIN_DEVIATION;
+
+        if (distance > limit)
+        {
+            accepted = median;
+            filter->rejected++;
+        }
+    }
+
+    // A amostra bruta entra na janela: um degrau real desloca a mediana em meia janela
+    if (filter->count == FILTER_WINDOW)
+        window_replace(filter, filter->ring[filter->head], sample);
+    else
+        window_insert(filter, sample);
+
+    filter->ring[filter->head] = sample;
+    filter->head = (filter->head + 1) % FILTER_WINDOW;
+
+    if (filter->samples == 1)
+        filter->ewma = accepted;
+    else
+        filter->ewma += (accepted - filter->ewma) >> FILTER_EWMA_SHIFT;
+
+    return filter->ewma;
+}
@@ -0,0 +1,368 @@
+#include "Gateway.h" // Modo gateway: visão da frota
+#include "Metrics.h" // Contadores de desempenho
+#include "Wifi.h"    // Estado do enlace
+
+static gateway_node nodes[GATEWAY_PEERS_MAX + 1];
+static uint node_count = 1;
+static struct udp_pcb *gateway_pcb = NULL;
+static uint32_t request_seq = 0;
+static absolute_time_t next_round;
+static uint32_t fleet_version = 0;
+
+// Lê a lista "ip[:porta],..." de GATEWAY_PEERS; entradas inválidas são ignoradas
+static void parse_peers()
+{
+    static char list[] = GATEWAY_PEERS;
+    char *save = NULL;
+
+    for (char *item = strtok_r(list, ", ", &save); item; item = strtok_r(NULL, ", ", &save))
+    {
+        if (node_count > GATEWAY_PEERS_MAX)
+        {
+            printf("Gateway: mais de %d pares, %s ignorado\n", GATEWAY_PEERS_MAX, item);
+            continue;
+        }
+
+        gateway_node *node = &nodes[node_count];
+        char *colon = strchr(item, ':');
+
+        node->port = TELEMETRY_PORT;
+        if (colon)
+        {
+            *colon = '\0';
+            node->port = (u16_t)atoi(colon + 1);
+        }
+
+        if (!ipaddr_aton(item, &node->addr) || node->port == 0)
+        {
+            printf("Gateway: par invalido %s\n", item);
+            continue;
+        }
+
+        node_count++;
+    }
+}
+
+// Relatório de um par: só vale a resposta à requisição pendente do mesmo endereço
+static void gateway_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+    uint8_t data[TELEMETRY_REPORT_SIZE];
+    telemetry_report report;
+    u16_t len = pbuf_copy_partial(p, data, sizeof(data), 0);
+
+    pbuf_free(p);
+
+    if (!telemetry_parse_report(data, len, &report))
+        return;
+
+    for (uint i = 1; i < node_count; i++)
+    {
+        gateway_node *node = &nodes[i];
+
+        if (!node->pending || node->port != port || !ip_addr_cmp(&node->addr, addr) || report.ack != node->request_seq)
+            continue;
+
+        // Só o estado das regiões conta como mudança (sequência e uptime mudam sempre)
+        if (!node->online || node->report.node_id != report.node_id || node->report.flags != report.flags ||
+            node->report.region_count != report.region_count ||
+            memcmp(node->report.regions, report.regions, sizeof(report.regions)) != 0)
+            fleet_version++;
+
+        node->report = report;
+        node->pending = false;
+        node->seen = true;
+        node->online = true;
+        node->misses = 0;
+        node->rtt_us = (uint32_t)(time_us_64() - node->sent_us);
+        node->last_seen_ms = to_ms_since_boot(get_absolute_time());
+
+        metrics_inc(METRIC_GATEWAY_REPLIES);
+        metrics_observe(METRIC_GATEWAY_RTT, node->rtt_us);
+        return;
+    }
+}
+
+// Lê GATEWAY_PEERS e cria o PCB UDP das consultas (chamar com a pilha de rede pronta)
+void configure_gateway()
+{
+    nodes[0].local = true;
+    nodes[0].seen = true;
+    nodes[0].online = true;
+
+    parse_peers();
+
+    if (node_count == 1)
+        return;
+
+    // Porta efêmera: as respostas voltam para ela, separadas da TELEMETRY_PORT
+    gateway_pcb = udp_new();
+    if (!gateway_pcb)
+    {
+        printf("Gateway: sem PCB UDP\n");
+        return;
+    }
+
+    udp_recv(gateway_pcb, gateway_recv, NULL);
+    next_round = get_absolute_time();
+
+    printf("Gateway: %u pares\n", node_count - 1);
+}
+
+// true se há pares configurados
+bool gateway_enabled()
+{
+    return gateway_pcb != NULL;
+}
+
+static void send_request(gateway_node *node, uint64_t now_us)
+{
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, TELEMETRY_HEADER_SIZE, PBUF_RAM);
+
+    if (!p)
+        return;
+
+    node->request_seq = ++request_seq;
+    telemetry_build_request((uint8_t *)p->payload, node->request_seq);
+
+    if (udp_sendto(gateway_pcb, p, &node->addr, node->port) == ERR_OK)
+    {
+        node->pending = true;
+        node->sent_us = now_us;
+        metrics_inc(METRIC_GATEWAY_REQUESTS);
+    }
+
+    pbuf_free(p);
+}
+
+// Envia a rodada de requisições e expira as respostas atrasadas (chamar no laço principal)
+void gateway_poll()
+{
+    if (!gateway_pcb)
+        return;
+
+    uint64_t now_us = time_us_64();
+
+    cyw43_arch_lwip_begin();
+
+    // Cada par tem o próprio prazo; os que responderam não esperam pelos demais
+    for (uint i = 1; i < node_count; i++)
+    {
+        gateway_node *node = &nodes[i];
+
+        if (!node->pending || now_us - node->sent_us < GATEWAY_TIMEOUT_MS * 1000ull)
+            continue;
+
+        node->pending = false;
+        if (node->misses < UINT8_MAX)
+            node->misses++;
+        if (node->misses >= GATEWAY_OFFLINE_MISSES && node->online)
+        {
+            node->online = false;
+            fleet_version++;
+        }
+
+        metrics_inc(METRIC_GATEWAY_TIMEOUTS);
+    }
+
+    if (absolute_time_diff_us(get_absolute_time(), next_round) <= 0)
+    {
+        next_round = make_timeout_time_ms(GATEWAY_PERIOD_MS);
+
+        // Sem enlace a rodada é pulada: a falha é do gateway, não dos pares
+        if (wifi_get_state() == WIFI_CONNECTED)
+        {
+            for (uint i = 1; i < node_count; i++)
+            {
+                if (!nodes[i].pending)
+                    send_request(&nodes[i], now_us);
+            }
+        }
+    }
+
+    cyw43_arch_lwip_end();
+}
+
+// Próximo instante em que gateway_poll() tem trabalho agendado
+absolute_time_t gateway_next_deadline()
+{
+    if (!gateway_pcb)
+        return at_the_end_of_time;
+
+    absolute_time_t deadline = next_round;
+
+    for (uint i = 1; i < node_count; i++)
+    {
+        if (!nodes[i].pending)
+            continue;
+
+        absolute_time_t expiry = from_us_since_boot(nodes[i].sent_us + GATEWAY_TIMEOUT_MS * 1000ull);
+        if (absolute_time_diff_us(expiry, deadline) > 0)
+            deadline = expiry;
+    }
+
+    return deadline;
+}
+
+// Incrementada quando o conteúdo da frota muda (pares online/offline ou relatórios diferentes)
+uint32_t gateway_version()
+{
+    return fleet_version;
+}
+
+// Número de nós na frota, incluindo o próprio
+uint gateway_node_count()
+{
+    return node_count;
+}
+
+// Nó da frota; a entrada 0 é o próprio nó, lida no momento da chamada
+const gateway_node *gateway_node_at(uint index)
+{
+    if (index >= node_count)
+        return NULL;
+
+    if (index == 0)
+    {
+        telemetry_snapshot(&nodes[0].report);
+        nodes[0].last_seen_ms = nodes[0].report.uptime_ms;
+    }
+
+    return &nodes[index];
+}
+
+// Número de blocos que compõem /api/fleet: resumo, um por nó e o fechamento
+uint16_t gateway_units()
+{
+    return node_count + 2;
+}
+
+static void put_bool(template_writer *w, const char *key, bool value)
+{
+    template_put_str(w, key);
+    template_put_str(w, value ? "true" : "false");
+}
+
+static void put_uint(template_writer *w, const char *key, uint32_t value)
+{
+    char digits[12];
+
+    template_put_str(w, key);
+    snprintf(digits, sizeof(digits), "%lu", (unsigned long)value);
+    template_put_str(w, digits);
+}
+
+static void render_summary(template_writer *w)
+{
+    uint online = 0, regions = 0, attention = 0, alerts = 0;
+
+    for (uint i = 0; i < node_count; i++)
+    {
+        const gateway_node *node = gateway_node_at(i);
+
+        if (!node->online)
+            continue;
+
+        online++;
+        regions += node->report.region_count;
+
+        for (int r = 0; r < node->report.region_count; r++)
+        {
+            attention += node->report.regions[r].class == LEVEL_ATTENTION;
+            alerts += node->report.regions[r].class == LEVEL_ALERT;
+        }
+    }
+
+    put_uint(w, "{\"nodes\":", node_count);
+    put_uint(w, ",\"online\":", online);
+    put_uint(w, ",\"regions\":", regions);
+    put_uint(w, ",\"attention\":", attention);
+    put_uint(w, ",\"alerts\":", alerts);
+    template_put_str(w, ",\"fleet\":[");
+}
+
+static void render_node(template_writer *w, uint index)
+{
+    const gateway_node *node = gateway_node_at(index);
+    uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+    char text[24];
+
+    if (index > 0)
+        template_put_str(w, ",");
+
+    snprintf(text, sizeof(text), "%04x", node->report.node_id);
+    template_put_str(w, "{\"node\":\"");
+    template_put_str(w, node->seen ? text : "");
+
+    if (node->local)
+        snprintf(text, sizeof(text), "local");
+    else
+        snprintf(text, sizeof(text), "%s:%u", ipaddr_ntoa(&node->addr), node->port);
+    template_put_str(w, "\",\"addr\":\"");
+    template_put_str(w, text);
+    template_put_str(w, "\"");
+
+    put_bool(w, ",\"local\":", node->local);
+    put_bool(w, ",\"online\":", node->online);
+
+    if (!node->seen)
+    {
+        template_put_str(w, ",\"regions\":[]}");
+        return;
+    }
+
+    put_uint(w, ",\"age_ms\":", now_ms - node->last_seen_ms);
+    put_uint(w, ",\"rtt_us\":", node->local ? 0 : node->rtt_us);
+    put_uint(w, ",\"uptime_ms\":", node->report.uptime_ms);
+    template_put_str(w, node->report.flags & TELEMETRY_FLAG_REGION_A ? ",\"selected\":\"A\"" : ",\"selected\":\"B\"");
+    template_put_str(w, ",\"regions\":[");
+
+    for (int r = 0; r < node->report.region_count; r++)
+    {
+        const telemetry_region *region = &node->report.regions[r];
+        char name[2] = {(char)('A' + r), '\0'};
+
+        template_put_str(w, r == 0 ? "{\"region\":\"" : ",{\"region\":\"");
+        template_put_str(w, name);
+        put_uint(w, "\",\"level\":", region->level);
+        template_put_str(w, ",\"class\":\"");
+        template_put_str(w, level_class_name((level_class)region->class));
+        template_put_str(w, "\",\"led\":\"");
+        template_put_str(w, telemetry_led_name(region->led));
+        template_put_str(w, "\"");
+        put_bool(w, ",\"buzzer\":", region->buzzer);
+        put_uint(w, ",\"attention\":", region->attention_threshold);
+        put_uint(w, ",\"alert\":", region->alert_threshold);
+        template_put_str(w, "}");
+    }
+
+    template_put_str(w, "]}");
+}
+
+// Gera blocos de /api/fleet a partir de *cursor enquanto couberem em buffer; retorna os bytes escritos
+uint16_t gateway_render(uint16_t *cursor, char *buffer, uint16_t size)
+{
+    template_writer w = {.buffer = buffer, .size = size};
+
+    while (*cursor < gateway_units())
+    {
+        uint16_t start = w.len;
+
+        if (*cursor == 0)
+            render_summary(&w);
+        else if (*cursor <= node_count)
+            render_node(&w, *cursor - 1);
+        else
+            template_put_str(&w, "]}\n");
+
+        // O bloco que não coube é descartado e gerado de novo na próxima chamada
+        if (w.overflow)
+        {
+            w.len = start;
+            break;
+        }
+
+        (*cursor)++;
+    }
+
+    return w.len;
+}
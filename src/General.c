@@ -25,4 +25,28 @@ void init_pwm(uint gpio, uint wrap)
     pwm_set_wrap(slice, wrap); // Define o valor de "wrap", que determina o ciclo completo do PWM
 
     pwm_set_enabled(slice, true); // Habilita a geração do sinal PWM no slice
-}
\ No newline at end of file
+}
+
+// Identificador do nó na rede, derivado dos dois últimos bytes do ID único da placa
+uint16_t get_node_id()
+{
+    pico_unique_board_id_t board_id;
+    pico_get_unique_board_id(&board_id);
+
+    return board_id.id[PICO_UNIQUE_BOARD_ID_SIZE_BYTES - 2] << 8 | board_id.id[PICO_UNIQUE_BOARD_ID_SIZE_BYTES - 1];
+}
+
+// CRC-32 (IEEE 802.3) dos dados; usado nos registros persistentes
+uint32_t crc32(const uint8_t *data, size_t len)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+
+    while (len--)
+    {
+        crc ^= *data++;
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+    }
+
+    return ~crc;
+}
@@ -0,0 +1,107 @@
+#include "Idle.h"          // Modo ocioso sem tick fixo
+#include "Metrics.h"       // Contadores de despertares e de tempo dormindo
+#include "Wifi.h"          // O power-save só vale com o enlace ativo
+#include "hardware/sync.h" // __sev()
+
+static volatile bool wake_pending = false;
+static volatile uint clients = 0;
+static uint32_t power_mode = 0; // Modo aplicado ao CYW43 (0 = nenhum ainda)
+
+static uint64_t awake_since_us = 0;
+static uint32_t sleep_remainder_us = 0; // Frações de milissegundo ainda não contabilizadas
+static uint32_t awake_remainder_us = 0;
+
+static void chars_available(void *param)
+{
+    idle_wake();
+}
+
+// Soma microssegundos a um contador em milissegundos, guardando o resto
+static void add_time(metric_counter id, uint32_t *remainder_us, uint64_t elapsed_us)
+{
+    elapsed_us += *remainder_us;
+    metrics_add(id, (uint32_t)(elapsed_us / 1000));
+    *remainder_us = elapsed_us % 1000;
+}
+
+// Sem clientes o rádio pode dormir entre beacons; com clientes a latência importa mais
+static void update_power_save()
+{
+    // Fora do ar o modo é reaplicado quando o enlace voltar
+    if (wifi_get_state() != WIFI_CONNECTED)
+    {
+        power_mode = 0;
+        return;
+    }
+
+    uint32_t mode = clients > 0 ? CYW43_PERFORMANCE_PM : CYW43_AGGRESSIVE_PM;
+
+    if (mode == power_mode)
+        return;
+
+    if (cyw43_wifi_pm(&cyw43_state, mode) == 0)
+        power_mode = mode;
+}
+
+// Função para configurar o modo ocioso (callback do console e power-save do CYW43)
+void configure_idle()
+{
+    stdio_set_chars_available_callback(chars_available, NULL);
+    awake_since_us = time_us_64();
+    update_power_save();
+}
+
+// Sinaliza trabalho para o laço principal; pode ser chamada de IRQs e callbacks
+void idle_wake()
+{
+    wake_pending = true;
+    __sev();
+}
+
+// Informa quantos clientes HTTP estão conectados (o power-save é ajustado no laço)
+void idle_set_clients(uint count)
+{
+    clients = count;
+    idle_wake();
+}
+
+// Dorme até o prazo ou até idle_wake(); retorna true se acordou por evento
+bool idle_until(absolute_time_t deadline)
+{
+    absolute_time_t limit = make_timeout_time_ms(IDLE_MAX_SLEEP_MS);
+    bool event;
+
+    update_power_save();
+
+    if (absolute_time_diff_us(deadline, limit) < 0)
+        deadline = limit;
+
+    uint64_t sleep_start = time_us_64();
+    add_time(METRIC_CPU_AWAKE_MS, &awake_remainder_us, sleep_start - awake_since_us);
+
+    // O WFE também retorna em IRQs que não pedem trabalho (rede em segundo plano, alarmes)
+    while (!(event = wake_pending))
+    {
+        if (best_effort_wfe_or_timeout(deadline))
+            break;
+    }
+
+    wake_pending = false;
+
+    awake_since_us = time_us_64();
+    add_time(METRIC_CPU_SLEEP_MS, &sleep_remainder_us, awake_since_us - sleep_start);
+
+    if (event)
+    {
+        metrics_inc(METRIC_IDLE_WAKEUPS_EVENT);
+    }
+    else
+    {
+        // Atraso do despertar em relação ao prazo pedido
+        int64_t late = absolute_time_diff_us(deadline, get_absolute_time());
+        metrics_observe(METRIC_LOOP_JITTER, late > 0 ? (uint32_t)late : 0);
+        metrics_inc(METRIC_IDLE_WAKEUPS_DEADLINE);
+    }
+
+    return event;
+}
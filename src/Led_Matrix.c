@@ -1,4 +1,6 @@
 #include "Led_Matrix.h" // Inclusão da biblioteca para controlar a matriz de LEDs
+#include "Trace.h"      // Rastreamento de eventos
+#include "Accel.h"      // Divisor do SIO
 
 refs pio;
 
@@ -21,26 +23,31 @@ uint32_t rgb_matrix(led_color color)
     return (color.green << 24) | (color.red << 16) | (color.blue << 8);
 }
 
+// Linhas acesas para o nível: floor(5 * nível / limiar), no máximo 5
+int matrix_lines_on(uint8_t current_level, uint8_t alert_threshold)
+{
+    // Limiar zero: qualquer nível acende tudo
+    if (alert_threshold == 0)
+        return current_level > 0 ? 5 : 0;
+
+    // Divisor do SIO em vez de ceil/floor em double (ponto flutuante por software no M0+)
+    uint32_t lines_on = accel_div_u32(current_level * 5u, alert_threshold);
+
+    return lines_on > 5 ? 5 : (int)lines_on;
+}
+
 void update_matrix_from_level(uint8_t current_level, uint8_t alert_threshold)
 {
+    TRACE_BEGIN(TRACE_MATRIX_REFRESH);
+
     // Limpa a matriz (todos os LEDs apagados)
     for (int i = 0; i < NUM_PIXELS; i++)
     {
         matrix[i] = 0;
     }
 
-    // Determina quantos níveis são necessários para acender uma linha
-    int levels_per_line = (int)ceil((double)alert_threshold / 5);
-
-    // Evita divisão por zero
-    if (levels_per_line == 0)
-        levels_per_line = 1;
-
     // Calcula o número de linhas a acender
-    int lines_on = (int)floor((double)current_level * 5 / alert_threshold);
-    
-    if (lines_on > 5)
-        lines_on = 5;
+    int lines_on = matrix_lines_on(current_level, alert_threshold);
 
     // Acende as linhas correspondentes
     for (int line = 0; line < lines_on; line++)
@@ -61,4 +68,6 @@ void update_matrix_from_level(uint8_t current_level, uint8_t alert_threshold)
 
         pio_sm_put_blocking(pio.ref, pio.state_machine, color);
     }
+
+    TRACE_END(TRACE_MATRIX_REFRESH);
 }
@@ -0,0 +1,146 @@
+#include <malloc.h>
+#include "Memory.h"     // Orçamento de memória
+#include "lwip/stats.h" // Estatísticas dos pools e do heap do lwIP
+
+typedef struct
+{
+    uint32_t *bottom; // Endereço mais baixo (a pilha cresce para baixo)
+    uint32_t *top;
+} stack_region;
+
+static stack_region stacks[MEMORY_CORES];
+
+// Nomes dos pools do lwIP, na mesma ordem de memp_t
+static const char *const memp_names[] = {
+#define LWIP_MEMPOOL(name, num, size, desc) #name,
+#include "lwip/priv/memp_std.h"
+};
+
+#if PICO_ON_DEVICE
+// Símbolos do script de ligação do Pico SDK
+extern uint32_t __StackBottom[], __StackTop[];
+extern uint32_t __StackOneBottom[], __StackOneTop[];
+extern char __data_start__[], __bss_end__[], end[], __StackLimit[];
+#endif
+
+// Endereço atual da pilha; as palavras abaixo dele estão livres
+static uint32_t *__attribute__((noinline)) current_stack_pointer()
+{
+#if PICO_ON_DEVICE
+    uint32_t *sp;
+    __asm volatile("mov %0, sp" : "=r"(sp));
+    return sp;
+#else
+    return (uint32_t *)__builtin_frame_address(0);
+#endif
+}
+
+static void paint(uint32_t *from, uint32_t *to)
+{
+    for (volatile uint32_t *word = from; word < to; word++)
+        *word = MEMORY_STACK_PATTERN;
+}
+
+// Função para preencher as pilhas livres com o padrão (chamar no início do main)
+void configure_memory()
+{
+    // Margem abaixo do SP para o quadro desta função e a red zone do x86-64
+    uint32_t *limit = current_stack_pointer() - 64;
+
+#if PICO_ON_DEVICE
+    stacks[0] = (stack_region){__StackBottom, __StackTop};
+    stacks[1] = (stack_region){__StackOneBottom, __StackOneTop};
+
+    // O núcleo 1 ainda não foi iniciado: sua pilha inteira está livre
+    paint(stacks[1].bottom, stacks[1].top);
+#else
+    // No host a pilha é a da thread principal; mede-se uma janela abaixo do ponto atual
+    uint32_t *top = limit + 64;
+    stacks[0] = (stack_region){top - MEMORY_HOST_STACK_SIZE / sizeof(uint32_t), top};
+#endif
+
+    paint(stacks[0].bottom, limit);
+}
+
+// Tamanho da pilha do núcleo em bytes (0 se não houver)
+uint32_t memory_stack_size(uint core)
+{
+    if (core >= MEMORY_CORES)
+        return 0;
+
+    return (stacks[core].top - stacks[core].bottom) * sizeof(uint32_t);
+}
+
+// Maior uso já registrado da pilha do núcleo, em bytes
+uint32_t memory_stack_used(uint core)
+{
+    if (core >= MEMORY_CORES || !stacks[core].bottom)
+        return 0;
+
+    // Do fundo para cima: as palavras com o padrão intacto nunca foram usadas
+    const uint32_t *word = stacks[core].bottom;
+    while (word < stacks[core].top && *word == MEMORY_STACK_PATTERN)
+        word++;
+
+    return (stacks[core].top - word) * sizeof(uint32_t);
+}
+
+// Bytes alocados pelo malloc
+uint32_t memory_heap_used()
+{
+#if defined(__GLIBC__)
+    return mallinfo2().uordblks;
+#else
+    return mallinfo().uordblks;
+#endif
+}
+
+// Memória obtida pelo malloc (só cresce: é a marca d'água do heap)
+uint32_t memory_heap_arena()
+{
+#if defined(__GLIBC__)
+    return mallinfo2().arena;
+#else
+    return mallinfo().arena;
+#endif
+}
+
+// Função para imprimir o relatório de memória no console
+void memory_report()
+{
+    printf("# memória\n");
+
+    for (uint core = 0; core < MEMORY_CORES; core++)
+    {
+        uint32_t size = memory_stack_size(core);
+
+        if (size == 0)
+            continue;
+
+        uint32_t used = memory_stack_used(core);
+        printf("pilha núcleo %u: %lu/%lu bytes (%lu%%)\n", core,
+               (unsigned long)used, (unsigned long)size, (unsigned long)(used * 100 / size));
+    }
+
+#if PICO_ON_DEVICE
+    printf("RAM estática (data+bss): %lu bytes, livre para o heap: %lu bytes\n",
+           (unsigned long)(__bss_end__ - __data_start__), (unsigned long)(__StackLimit - end));
+#endif
+
+    printf("heap malloc: %lu bytes em uso, arena %lu bytes\n",
+           (unsigned long)memory_heap_used(), (unsigned long)memory_heap_arena());
+    printf("heap lwIP: %lu bytes em uso, pico %lu/%lu, falhas %lu\n",
+           (unsigned long)lwip_stats.mem.used, (unsigned long)lwip_stats.mem.max,
+           (unsigned long)lwip_stats.mem.avail, (unsigned long)lwip_stats.mem.err);
+
+    for (int i = 0; i < MEMP_MAX; i++)
+    {
+        const struct stats_mem *stats = lwip_stats.memp[i];
+
+        if (!stats)
+            continue;
+
+        printf("pool %-16s %u em uso, pico %u/%u, falhas %u\n", memp_names[i],
+               (unsigned)stats->used, (unsigned)stats->max, (unsigned)stats->avail, (unsigned)stats->err);
+    }
+}
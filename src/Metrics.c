@@ -0,0 +1,356 @@
+#include <stdarg.h>
+#include "Metrics.h"    // Contadores e histogramas de desempenho
+#include "Memory.h"     // Pilhas e heap do malloc
+#include "Wifi.h"       // Estado e tempo de conexão do Wi-Fi
+#include "Boot.h"       // Linha do tempo do boot
+#include "lwip/stats.h" // Estatísticas dos pools e do heap do lwIP
+
+typedef struct
+{
+    const char *name;
+    const char *labels;
+    const char *help;
+} metric_info;
+
+typedef struct
+{
+    volatile uint32_t buckets[METRICS_HIST_BUCKETS + 1]; // Não cumulativos; o último é +Inf
+    volatile uint32_t count;
+    volatile uint32_t sum_lo; // Soma em microssegundos, em duas palavras de 32 bits
+    volatile uint32_t sum_hi;
+} metric_hist_data;
+
+typedef struct
+{
+    char *buffer;
+    uint16_t size;
+    uint16_t len;
+    bool overflow;
+} metrics_writer;
+
+// Limites superiores dos buckets em microssegundos e os rótulos "le" correspondentes
+static const uint32_t hist_bounds_us[METRICS_HIST_BUCKETS] = {
+    100, 250, 500, 1000, 2500, 5000, 10000, 50000, 100000, 500000};
+static const char *const hist_bounds_label[METRICS_HIST_BUCKETS] = {
+    "0.0001", "0.00025", "0.0005", "0.001", "0.0025", "0.005", "0.01", "0.05", "0.1", "0.5"};
+
+// Contadores da mesma família ficam em sequência (HELP/TYPE saem uma vez só)
+static const metric_info counter_info[METRIC_COUNTER_COUNT] = {
+    [METRIC_HTTP_REQUESTS] = {"floodsense_http_requests_total", "", "Requisições HTTP recebidas"},
+    [METRIC_HTTP_BYTES_SENT] = {"floodsense_http_response_bytes_total", "", "Bytes de resposta aceitos pelo tcp_write"},
+    [METRIC_TCP_WRITE_FAILURES] = {"floodsense_tcp_write_failures_total", "", "Chamadas de tcp_write que falharam"},
+    [METRIC_GPIO_IRQ_BUTTON_A] = {"floodsense_gpio_irq_total", "button=\"A\"", "Interrupções de GPIO por botão"},
+    [METRIC_GPIO_IRQ_BUTTON_B] = {"floodsense_gpio_irq_total", "button=\"B\"", NULL},
+    [METRIC_GPIO_IRQ_BUTTON_J] = {"floodsense_gpio_irq_total", "button=\"J\"", NULL},
+    [METRIC_BUTTON_EVENTS_DROPPED] = {"floodsense_button_events_dropped_total", "", "Bordas descartadas com a fila de botões cheia"},
+    [METRIC_IDLE_WAKEUPS_EVENT] = {"floodsense_idle_wakeups_total", "reason=\"event\"", "Despertares do modo ocioso por motivo"},
+    [METRIC_IDLE_WAKEUPS_DEADLINE] = {"floodsense_idle_wakeups_total", "reason=\"deadline\"", NULL},
+    [METRIC_CPU_SLEEP_MS] = {"floodsense_cpu_time_milliseconds_total", "state=\"sleep\"", "Tempo do laço principal dormindo e acordado"},
+    [METRIC_CPU_AWAKE_MS] = {"floodsense_cpu_time_milliseconds_total", "state=\"awake\"", NULL},
+    [METRIC_WIFI_CONNECT_ATTEMPTS] = {"floodsense_wifi_connect_attempts_total", "", "Tentativas de associação ao ponto de acesso"},
+    [METRIC_WIFI_LINK_UP] = {"floodsense_wifi_link_transitions_total", "to=\"up\"", "Transições do enlace Wi-Fi"},
+    [METRIC_WIFI_LINK_DOWN] = {"floodsense_wifi_link_transitions_total", "to=\"down\"", NULL},
+    [METRIC_CONFIG_WRITES] = {"floodsense_config_flash_operations_total", "op=\"program\"", "Operações na flash do estado persistente"},
+    [METRIC_CONFIG_ERASES] = {"floodsense_config_flash_operations_total", "op=\"erase\"", NULL},
+    [METRIC_GATEWAY_REQUESTS] = {"floodsense_gateway_messages_total", "kind=\"request\"", "Consultas do gateway aos pares e seus resultados"},
+    [METRIC_GATEWAY_REPLIES] = {"floodsense_gateway_messages_total", "kind=\"reply\"", NULL},
+    [METRIC_GATEWAY_TIMEOUTS] = {"floodsense_gateway_messages_total", "kind=\"timeout\"", NULL},
+    [METRIC_CACHE_HITS] = {"floodsense_response_cache_total", "result=\"hit\"", "Leituras do cache de respostas (hit, render ou bypass sem entrada livre)"},
+    [METRIC_CACHE_RENDERS] = {"floodsense_response_cache_total", "result=\"render\"", NULL},
+    [METRIC_CACHE_BYPASS] = {"floodsense_response_cache_total", "result=\"bypass\"", NULL},
+    [METRIC_SENSOR_ACCEPTED] = {"floodsense_sensor_samples_total", "result=\"accepted\"", "Amostras dos sensores de nível (rejected: picos trocados pela mediana)"},
+    [METRIC_SENSOR_REJECTED] = {"floodsense_sensor_samples_total", "result=\"rejected\"", NULL},
+    [METRIC_WEBHOOK_DELIVERED] = {"floodsense_webhook_deliveries_total", "result=\"delivered\"", "Entregas de webhooks de alerta (dropped: 4xx ou fila cheia; coalesced: transições agrupadas)"},
+    [METRIC_WEBHOOK_RETRIES] = {"floodsense_webhook_deliveries_total", "result=\"retry\"", NULL},
+    [METRIC_WEBHOOK_DROPPED] = {"floodsense_webhook_deliveries_total", "result=\"dropped\"", NULL},
+    [METRIC_WEBHOOK_COALESCED] = {"floodsense_webhook_deliveries_total", "result=\"coalesced\"", NULL},
+    [METRIC_STREAM_SENT] = {"floodsense_stream_samples_total", "result=\"sent\"", "Amostras do stream USB (lost: descartadas com os dois blocos ocupados)"},
+    [METRIC_STREAM_LOST] = {"floodsense_stream_samples_total", "result=\"lost\"", NULL},
+    [METRIC_HTTP_SERVED_CONTROL] = {"floodsense_http_admitted_total", "route=\"control\"", "Requests admitidos pelo controle de admissão, por classe de rota"},
+    [METRIC_HTTP_SERVED_API] = {"floodsense_http_admitted_total", "route=\"api\"", NULL},
+    [METRIC_HTTP_SERVED_PAGE] = {"floodsense_http_admitted_total", "route=\"page\"", NULL},
+    [METRIC_HTTP_SHED_CLIENT] = {"floodsense_http_shed_total", "reason=\"client_cap\"", "Conexões recusadas com 503 (evicted: ociosas derrubadas pelo lwIP por falta de PCB)"},
+    [METRIC_HTTP_SHED_FULL] = {"floodsense_http_shed_total", "reason=\"full\"", NULL},
+    [METRIC_HTTP_SHED_RESERVED] = {"floodsense_http_shed_total", "reason=\"reserved\"", NULL},
+    [METRIC_HTTP_SHED_RATE] = {"floodsense_http_shed_total", "reason=\"rate\"", NULL},
+    [METRIC_HTTP_SHED_EVICTED] = {"floodsense_http_shed_total", "reason=\"evicted\"", NULL},
+};
+
+static const metric_info histogram_info[METRIC_HISTOGRAM_COUNT] = {
+    [METRIC_HTTP_PARSE_TIME] = {"floodsense_http_parse_seconds", "", "Tempo de tratamento do request HTTP"},
+    [METRIC_HTTP_RENDER_TIME] = {"floodsense_http_render_seconds", "", "Tempo de geração da página HTML"},
+    [METRIC_LOOP_ITERATION_TIME] = {"floodsense_loop_iteration_seconds", "", "Tempo de trabalho de cada iteração do laço principal"},
+    [METRIC_LOOP_JITTER] = {"floodsense_loop_jitter_seconds", "", "Atraso do despertar em relação ao prazo agendado"},
+    [METRIC_DISPLAY_SEND_TIME] = {"floodsense_display_send_seconds", "", "Tempo de ssd1306_send_data"},
+    [METRIC_MATRIX_UPDATE_TIME] = {"floodsense_matrix_update_seconds", "", "Tempo de update_matrix_from_level"},
+    [METRIC_BUTTON_LATENCY] = {"floodsense_button_latency_seconds", "", "Tempo entre a IRQ do botão e o tratamento no laço principal"},
+    [METRIC_GATEWAY_RTT] = {"floodsense_gateway_rtt_seconds", "", "Tempo de resposta dos pares às consultas do gateway"},
+};
+
+// Nomes dos pools do lwIP, na mesma ordem de memp_t
+static const char *const memp_names[] = {
+#define LWIP_MEMPOOL(name, num, size, desc) #name,
+#include "lwip/priv/memp_std.h"
+};
+
+// Blocos da página: um por contador, um por histograma, pools do lwIP, heap, pilhas, Wi-Fi e boot
+#define UNIT_COUNTERS 0
+#define UNIT_HISTOGRAMS (UNIT_COUNTERS + METRIC_COUNTER_COUNT)
+#define UNIT_MEMP (UNIT_HISTOGRAMS + METRIC_HISTOGRAM_COUNT)
+#define UNIT_MEMP_FAMILIES 4
+#define UNIT_HEAP (UNIT_MEMP + UNIT_MEMP_FAMILIES)
+#define UNIT_STACK (UNIT_HEAP + 1)
+#define UNIT_WIFI (UNIT_STACK + 1)
+#define UNIT_BOOT (UNIT_WIFI + 1)
+#define UNIT_COUNT (UNIT_BOOT + 2)
+
+static volatile uint32_t counters[METRIC_COUNTER_COUNT];
+static metric_hist_data histograms[METRIC_HISTOGRAM_COUNT];
+
+// Incrementa um contador
+void metrics_inc(metric_counter id)
+{
+    counters[id]++;
+}
+
+// Soma um valor a um contador
+void metrics_add(metric_counter id, uint32_t value)
+{
+    counters[id] += value;
+}
+
+// Registra uma duração (em microssegundos) em um histograma
+void metrics_observe(metric_histogram id, uint32_t duration_us)
+{
+    metric_hist_data *h = &histograms[id];
+    int bucket = 0;
+
+    while (bucket < METRICS_HIST_BUCKETS && duration_us > hist_bounds_us[bucket])
+        bucket++;
+
+    h->buckets[bucket]++;
+    h->count++;
+
+    // O carry vai para a palavra alta antes da baixa: uma leitura concorrente
+    // erra no máximo pela amostra em andamento
+    uint32_t lo = h->sum_lo + duration_us;
+    if (lo < h->sum_lo)
+        h->sum_hi++;
+    h->sum_lo = lo;
+}
+
+// Número de blocos que compõem a página /metrics
+uint16_t metrics_units()
+{
+    return UNIT_COUNT;
+}
+
+static void append(metrics_writer *w, const char *format, ...)
+{
+    va_list args;
+
+    if (w->overflow)
+        return;
+
+    va_start(args, format);
+    int n = vsnprintf(w->buffer + w->len, w->size - w->len, format, args);
+    va_end(args);
+
+    if (n < 0 || n >= w->size - w->len)
+        w->overflow = true;
+    else
+        w->len += n;
+}
+
+static void append_header(metrics_writer *w, const char *name, const char *type, const char *help)
+{
+    if (help)
+        append(w, "# HELP %s %s\n", name, help);
+    append(w, "# TYPE %s %s\n", name, type);
+}
+
+static void render_counter(metrics_writer *w, metric_counter id)
+{
+    const metric_info *info = &counter_info[id];
+
+    // O primeiro contador de cada família leva o HELP/TYPE
+    if (info->help)
+        append_header(w, info->name, "counter", info->help);
+
+    if (info->labels[0])
+        append(w, "%s{%s} %lu\n", info->name, info->labels, (unsigned long)counters[id]);
+    else
+        append(w, "%s %lu\n", info->name, (unsigned long)counters[id]);
+}
+
+static void render_histogram(metrics_writer *w, metric_histogram id)
+{
+    const metric_info *info = &histogram_info[id];
+    const metric_hist_data *h = &histograms[id];
+    uint32_t cumulative = 0;
+
+    append_header(w, info->name, "histogram", info->help);
+
+    for (int i = 0; i < METRICS_HIST_BUCKETS; i++)
+    {
+        cumulative += h->buckets[i];
+        append(w, "%s_bucket{le=\"%s\"} %lu\n", info->name, hist_bounds_label[i], (unsigned long)cumulative);
+    }
+    cumulative += h->buckets[METRICS_HIST_BUCKETS];
+    append(w, "%s_bucket{le=\"+Inf\"} %lu\n", info->name, (unsigned long)cumulative);
+
+    uint64_t sum_us = ((uint64_t)h->sum_hi << 32) | h->sum_lo;
+    append(w, "%s_sum %llu.%06llu\n", info->name,
+           (unsigned long long)(sum_us / 1000000), (unsigned long long)(sum_us % 1000000));
+    append(w, "%s_count %lu\n", info->name, (unsigned long)cumulative);
+}
+
+static void render_memp(metrics_writer *w, int family)
+{
+    static const struct
+    {
+        const char *name;
+        const char *type;
+        const char *help;
+    } memp_info[UNIT_MEMP_FAMILIES] = {
+        {"floodsense_lwip_pool_used", "gauge", "Elementos em uso em cada pool do lwIP"},
+        {"floodsense_lwip_pool_max_used", "gauge", "Maior uso já registrado em cada pool do lwIP"},
+        {"floodsense_lwip_pool_size", "gauge", "Capacidade de cada pool do lwIP"},
+        {"floodsense_lwip_pool_alloc_failures_total", "counter", "Alocações recusadas por pool esgotado"},
+    };
+    const char *name = memp_info[family].name;
+
+    append_header(w, name, memp_info[family].type, memp_info[family].help);
+
+    for (int i = 0; i < MEMP_MAX; i++)
+    {
+        const struct stats_mem *stats = lwip_stats.memp[i];
+        unsigned long value;
+
+        if (!stats)
+            continue;
+
+        switch (family)
+        {
+        case 0:
+            value = stats->used;
+            break;
+        case 1:
+            value = stats->max;
+            break;
+        case 2:
+            value = stats->avail;
+            break;
+        default:
+            value = stats->err;
+            break;
+        }
+
+        append(w, "%s{pool=\"%s\"} %lu\n", name, memp_names[i], value);
+    }
+}
+
+static void render_heap(metrics_writer *w)
+{
+    append_header(w, "floodsense_lwip_heap_used_bytes", "gauge", "Bytes em uso no heap do lwIP");
+    append(w, "floodsense_lwip_heap_used_bytes %lu\n", (unsigned long)lwip_stats.mem.used);
+    append_header(w, "floodsense_lwip_heap_max_used_bytes", "gauge", "Marca d'água do heap do lwIP");
+    append(w, "floodsense_lwip_heap_max_used_bytes %lu\n", (unsigned long)lwip_stats.mem.max);
+    append_header(w, "floodsense_heap_used_bytes", "gauge", "Bytes alocados pelo malloc");
+    append(w, "floodsense_heap_used_bytes %lu\n", (unsigned long)memory_heap_used());
+    append_header(w, "floodsense_heap_arena_bytes", "gauge", "Memória obtida pelo malloc (marca d'água)");
+    append(w, "floodsense_heap_arena_bytes %lu\n", (unsigned long)memory_heap_arena());
+}
+
+static void render_stack(metrics_writer *w)
+{
+    append_header(w, "floodsense_stack_used_bytes", "gauge", "Marca d'água da pilha de cada núcleo");
+    for (uint core = 0; core < MEMORY_CORES; core++)
+        append(w, "floodsense_stack_used_bytes{core=\"%u\"} %lu\n", core, (unsigned long)memory_stack_used(core));
+
+    append_header(w, "floodsense_stack_size_bytes", "gauge", "Tamanho da pilha de cada núcleo");
+    for (uint core = 0; core < MEMORY_CORES; core++)
+        append(w, "floodsense_stack_size_bytes{core=\"%u\"} %lu\n", core, (unsigned long)memory_stack_size(core));
+}
+
+static void render_wifi(metrics_writer *w)
+{
+    wifi_state current = wifi_get_state();
+
+    append_header(w, "floodsense_wifi_state", "gauge", "Estado da conexão Wi-Fi (1 no estado atual)");
+    for (wifi_state s = WIFI_STACK_DOWN; s <= WIFI_CONNECTED; s++)
+        append(w, "floodsense_wifi_state{state=\"%s\"} %d\n", wifi_state_name(s), s == current);
+
+    // Sem quantis: sum/count dão a média e last_connect o valor mais recente
+    uint64_t total_ms = wifi_connect_total_ms();
+    append_header(w, "floodsense_wifi_time_to_connected_seconds", "summary", "Tempo da queda (ou do boot) até a conexão");
+    append(w, "floodsense_wifi_time_to_connected_seconds_sum %llu.%03llu\n",
+           (unsigned long long)(total_ms / 1000), (unsigned long long)(total_ms % 1000));
+    append(w, "floodsense_wifi_time_to_connected_seconds_count %lu\n", (unsigned long)wifi_connect_count());
+
+    uint32_t last_ms = wifi_last_connect_ms();
+    append_header(w, "floodsense_wifi_last_time_to_connected_seconds", "gauge", "Tempo até a conexão mais recente");
+    append(w, "floodsense_wifi_last_time_to_connected_seconds %lu.%03lu\n",
+           (unsigned long)(last_ms / 1000), (unsigned long)(last_ms % 1000));
+}
+
+// Um bloco para os inícios e outro para as durações; etapas em andamento ficam de fora
+static void render_boot(metrics_writer *w, bool duration)
+{
+    const char *name = duration ? "floodsense_boot_stage_duration_seconds" : "floodsense_boot_stage_start_seconds";
+    uint32_t start_us, duration_us;
+
+    append_header(w, name, "gauge", duration ? "Duração de cada etapa do boot" : "Início de cada etapa do boot desde o reset");
+
+    for (boot_stage s = 0; s < BOOT_STAGE_COUNT; s++)
+    {
+        if (!boot_stage_time(s, &start_us, &duration_us))
+            continue;
+
+        uint32_t value = duration ? duration_us : start_us;
+        append(w, "%s{stage=\"%s\"} %lu.%06lu\n", name, boot_stage_name(s),
+               (unsigned long)(value / 1000000), (unsigned long)(value % 1000000));
+    }
+}
+
+static void render_unit(metrics_writer *w, uint16_t unit)
+{
+    if (unit < UNIT_HISTOGRAMS)
+        render_counter(w, (metric_counter)(unit - UNIT_COUNTERS));
+    else if (unit < UNIT_MEMP)
+        render_histogram(w, (metric_histogram)(unit - UNIT_HISTOGRAMS));
+    else if (unit < UNIT_HEAP)
+        render_memp(w, unit - UNIT_MEMP);
+    else if (unit == UNIT_HEAP)
+        render_heap(w);
+    else if (unit == UNIT_STACK)
+        render_stack(w);
+    else if (unit == UNIT_WIFI)
+        render_wifi(w);
+    else
+        render_boot(w, unit > UNIT_BOOT);
+}
+
+// Gera blocos a partir de *cursor enquanto couberem em buffer; retorna os bytes escritos
+uint16_t metrics_render(uint16_t *cursor, char *buffer, uint16_t size)
+{
+    metrics_writer w = {.buffer = buffer, .size = size};
+
+    while (*cursor < UNIT_COUNT)
+    {
+        uint16_t start = w.len;
+
+        render_unit(&w, *cursor);
+
+        // O bloco que não coube é descartado e gerado de novo na próxima chamada
+        if (w.overflow)
+        {
+            w.len = start;
+            break;
+        }
+
+        (*cursor)++;
+    }
+
+    return w.len;
+}
@@ -0,0 +1,574 @@
+#include "Mqtt.h"  // Publicador MQTT sobre TCP raw do lwIP
+#include "Trace.h" // Rastreamento de eventos
+#include "Idle.h"  // Acorda o laço principal quando a conexão muda
+
+#define MQTT_PACKET_CONNECT 0x10
+#define MQTT_PACKET_CONNACK 0x20
+#define MQTT_PACKET_PUBLISH 0x30
+#define MQTT_PACKET_PINGREQ 0xC0
+#define MQTT_PACKET_PINGRESP 0xD0
+
+#define MQTT_HEADER_RESERVE 3 // Tipo + até 2 bytes de "remaining length" (< 16 KB)
+
+static mqtt_state state = MQTT_DISABLED;
+static struct tcp_pcb *mqtt_pcb = NULL;
+static ip_addr_t broker_addr;
+
+static uint16_t node_id = 0;
+static char client_id[24];
+static char topic_levels[32];
+static char topic_alerts[32];
+
+// Filas circulares: head aponta para o elemento mais antigo
+static mqtt_sample sample_queue[MQTT_QUEUE_SIZE];
+static uint16_t sample_head = 0;
+static uint16_t sample_count = 0;
+
+static mqtt_sample alert_queue[MQTT_ALERT_QUEUE_SIZE];
+static uint16_t alert_head = 0;
+static uint16_t alert_count = 0;
+
+static uint32_t dropped_samples = 0;
+
+static uint8_t packet[MQTT_PACKET_SIZE]; // Buffer de montagem (copiado pelo tcp_write)
+static uint8_t last_class[2];
+
+static absolute_time_t next_sample_time;
+static absolute_time_t next_retry_time;
+static absolute_time_t connect_deadline;
+static absolute_time_t next_ping_time;
+static uint32_t retry_delay_ms = MQTT_RETRY_MIN_MS;
+static bool ping_outstanding = false;
+
+// Estado do parser de pacotes recebidos
+static uint8_t rx_type = 0;
+static uint32_t rx_remaining = 0;
+static uint32_t rx_multiplier = 1;
+static uint8_t rx_stage = 0; // 0 = tipo, 1 = tamanho, 2 = corpo
+static uint8_t rx_body[2];
+static uint8_t rx_body_len = 0;
+
+static bool time_reached(absolute_time_t deadline)
+{
+    return absolute_time_diff_us(get_absolute_time(), deadline) <= 0;
+}
+
+static void queue_push(mqtt_sample *queue, uint16_t size, uint16_t *head, uint16_t *count, mqtt_sample sample)
+{
+    if (*count == size)
+    {
+        // Fila cheia: descarta a amostra mais antiga
+        *head = (*head + 1) % size;
+        (*count)--;
+        dropped_samples++;
+    }
+
+    queue[(*head + *count) % size] = sample;
+    (*count)++;
+}
+
+static void queue_pop(uint16_t size, uint16_t *head, uint16_t *count, uint16_t n)
+{
+    *head = (*head + n) % size;
+    *count -= n;
+}
+
+// Agenda a próxima tentativa com backoff exponencial
+static void schedule_retry()
+{
+    state = MQTT_DISCONNECTED;
+    ping_outstanding = false;
+    next_retry_time = make_timeout_time_ms(retry_delay_ms);
+
+    retry_delay_ms *= 2;
+    if (retry_delay_ms > MQTT_RETRY_MAX_MS)
+        retry_delay_ms = MQTT_RETRY_MAX_MS;
+
+    // O prazo mudou: o laço principal precisa recalcular quando acordar
+    idle_wake();
+}
+
+// Desfaz a conexão atual sem disparar callbacks e agenda a reconexão; true se
+// foi preciso abortar o PCB (um callback do lwIP deve então retornar ERR_ABRT)
+static bool drop_connection()
+{
+    bool aborted = false;
+
+    if (mqtt_pcb)
+    {
+        tcp_arg(mqtt_pcb, NULL);
+        tcp_recv(mqtt_pcb, NULL);
+        tcp_sent(mqtt_pcb, NULL);
+        tcp_err(mqtt_pcb, NULL);
+
+        if (tcp_close(mqtt_pcb) != ERR_OK)
+        {
+            tcp_abort(mqtt_pcb);
+            aborted = true;
+        }
+
+        mqtt_pcb = NULL;
+    }
+
+    schedule_retry();
+    return aborted;
+}
+
+// Variante para callbacks do lwIP: aborta o PCB (o callback deve retornar ERR_ABRT)
+static void abort_connection()
+{
+    struct tcp_pcb *pcb = mqtt_pcb;
+
+    mqtt_pcb = NULL;
+    tcp_err(pcb, NULL);
+    tcp_abort(pcb);
+    schedule_retry();
+}
+
+// Envia os bytes montados em packet; falha se não houver espaço no buffer TCP
+static bool send_packet(const uint8_t *data, uint16_t len)
+{
+    if (!mqtt_pcb || tcp_sndbuf(mqtt_pcb) < len)
+        return false;
+
+    if (tcp_write(mqtt_pcb, data, len, TCP_WRITE_FLAG_COPY) != ERR_OK)
+        return false;
+
+    tcp_output(mqtt_pcb);
+    return true;
+}
+
+// Escreve o cabeçalho fixo imediatamente antes do corpo (que começa em MQTT_HEADER_RESERVE)
+static uint8_t *finish_packet(uint8_t type, uint16_t body_len, uint16_t *total_len)
+{
+    uint8_t *start;
+
+    if (body_len < 128)
+    {
+        start = packet + MQTT_HEADER_RESERVE - 2;
+        start[1] = body_len;
+    }
+    else
+    {
+        start = packet;
+        start[1] = (body_len & 0x7F) | 0x80;
+        start[2] = body_len >> 7;
+    }
+
+    start[0] = type;
+    *total_len = (packet + MQTT_HEADER_RESERVE - start) + body_len;
+    return start;
+}
+
+static uint16_t put_string(uint8_t *buffer, const char *str)
+{
+    uint16_t len = strlen(str);
+    buffer[0] = len >> 8;
+    buffer[1] = len & 0xFF;
+    memcpy(buffer + 2, str, len);
+    return len + 2;
+}
+
+static bool send_connect()
+{
+    uint8_t *body = packet + MQTT_HEADER_RESERVE;
+    uint16_t len = put_string(body, "MQTT");
+
+    body[len++] = 4;    // Protocolo 3.1.1
+    body[len++] = 0x02; // Clean session
+    body[len++] = MQTT_KEEPALIVE_S >> 8;
+    body[len++] = MQTT_KEEPALIVE_S & 0xFF;
+    len += put_string(body + len, client_id);
+
+    uint16_t total_len;
+    uint8_t *start = finish_packet(MQTT_PACKET_CONNECT, len, &total_len);
+    return send_packet(start, total_len);
+}
+
+// Publica (QoS 0) o payload já escrito após o tópico
+static bool send_publish(const char *topic, uint16_t payload_len)
+{
+    uint16_t total_len;
+    uint16_t topic_len = 2 + strlen(topic);
+    uint8_t *start = finish_packet(MQTT_PACKET_PUBLISH, topic_len + payload_len, &total_len);
+    return send_packet(start, total_len);
+}
+
+// Área do payload: depois do cabeçalho e do tópico
+static char *payload_area(const char *topic, uint16_t *capacity)
+{
+    uint8_t *body = packet + MQTT_HEADER_RESERVE;
+    uint16_t topic_len = put_string(body, topic);
+
+    *capacity = MQTT_PACKET_SIZE - MQTT_HEADER_RESERVE - topic_len;
+    return (char *)body + topic_len;
+}
+
+// Publica a transição de classe mais antiga
+static bool publish_alert()
+{
+    uint16_t capacity;
+    char *payload = payload_area(topic_alerts, &capacity);
+    const mqtt_sample *alert = &alert_queue[alert_head];
+
+    int len = snprintf(payload, capacity,
+                       "{\"node\":\"%04x\",\"t\":%lu,\"region\":\"%c\",\"level\":%u,\"from\":\"%s\",\"to\":\"%s\"}",
+                       node_id, (unsigned long)alert->time_ms, 'A' + alert->region, alert->level,
+                       level_class_name(alert->previous_class), level_class_name(alert->class));
+
+    if (len < 0 || len >= capacity || !send_publish(topic_alerts, len))
+        return false;
+
+    queue_pop(MQTT_ALERT_QUEUE_SIZE, &alert_head, &alert_count, 1);
+    return true;
+}
+
+// Publica até MQTT_BATCH_SIZE amostras em um único PUBLISH
+static bool publish_batch()
+{
+    uint16_t capacity;
+    char *payload = payload_area(topic_levels, &capacity);
+    uint16_t batch = sample_count < MQTT_BATCH_SIZE ? sample_count : MQTT_BATCH_SIZE;
+
+    int len = snprintf(payload, capacity, "{\"node\":\"%04x\",\"samples\":[", node_id);
+
+    for (uint16_t i = 0; i < batch && len < capacity; i++)
+    {
+        const mqtt_sample *sample = &sample_queue[(sample_head + i) % MQTT_QUEUE_SIZE];
+        len += snprintf(payload + len, capacity - len, "%s[%lu,\"%c\",%u]", i ? "," : "",
+                        (unsigned long)sample->time_ms, 'A' + sample->region, sample->level);
+    }
+
+    if (len < capacity)
+        len += snprintf(payload + len, capacity - len, "]}");
+
+    if (len >= capacity || !send_publish(topic_levels, len))
+        return false;
+
+    queue_pop(MQTT_QUEUE_SIZE, &sample_head, &sample_count, batch);
+    return true;
+}
+
+// Decide se há amostras suficientes (ou antigas o bastante) para publicar
+static bool batch_ready()
+{
+    if (sample_count >= MQTT_BATCH_SIZE)
+        return true;
+
+    if (sample_count == 0)
+        return false;
+
+    uint32_t age = to_ms_since_boot(get_absolute_time()) - sample_queue[sample_head].time_ms;
+    return age >= MQTT_BATCH_MAX_AGE_MS;
+}
+
+// Processa os pacotes do broker byte a byte (apenas CONNACK e PINGRESP importam); true se o PCB foi abortado
+static bool handle_packet()
+{
+    if (rx_type == MQTT_PACKET_CONNACK && state == MQTT_WAIT_CONNACK)
+    {
+        if (rx_body_len == 2 && rx_body[1] == 0)
+        {
+            state = MQTT_CONNECTED;
+            retry_delay_ms = MQTT_RETRY_MIN_MS;
+            next_ping_time = make_timeout_time_ms(MQTT_KEEPALIVE_S * 500);
+        }
+        else
+        {
+            return drop_connection();
+        }
+    }
+    else if (rx_type == MQTT_PACKET_PINGRESP)
+    {
+        ping_outstanding = false;
+    }
+
+    return false;
+}
+
+static bool parse_byte(uint8_t byte)
+{
+    switch (rx_stage)
+    {
+    case 0:
+        rx_type = byte & 0xF0;
+        rx_remaining = 0;
+        rx_multiplier = 1;
+        rx_body_len = 0;
+        rx_stage = 1;
+        break;
+
+    case 1:
+        rx_remaining += (byte & 0x7F) * rx_multiplier;
+        rx_multiplier *= 128;
+
+        if (!(byte & 0x80))
+        {
+            rx_stage = rx_remaining ? 2 : 0;
+            if (!rx_remaining)
+                return handle_packet();
+        }
+        break;
+
+    default:
+        if (rx_body_len < sizeof(rx_body))
+            rx_body[rx_body_len++] = byte;
+
+        if (--rx_remaining == 0)
+        {
+            rx_stage = 0;
+            return handle_packet();
+        }
+        break;
+    }
+
+    return false;
+}
+
+static err_t mqtt_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err)
+{
+    TRACE_BEGIN(TRACE_MQTT_RECV);
+
+    if (!p)
+    {
+        // Broker encerrou a conexão
+        bool aborted = drop_connection();
+        TRACE_END(TRACE_MQTT_RECV);
+        return aborted ? ERR_ABRT : ERR_OK;
+    }
+
+    bool aborted = false;
+
+    for (struct pbuf *q = p; q && mqtt_pcb == tpcb; q = q->next)
+    {
+        for (uint16_t i = 0; i < q->len && mqtt_pcb == tpcb; i++)
+            aborted |= parse_byte(((uint8_t *)q->payload)[i]);
+    }
+
+    if (mqtt_pcb == tpcb)
+        tcp_recved(tpcb, p->tot_len);
+
+    pbuf_free(p);
+    idle_wake();
+    TRACE_END(TRACE_MQTT_RECV);
+    return aborted ? ERR_ABRT : ERR_OK;
+}
+
+// Espaço liberado no buffer TCP: publicações adiadas podem seguir
+static err_t mqtt_sent(void *arg, struct tcp_pcb *tpcb, u16_t len)
+{
+    idle_wake();
+    return ERR_OK;
+}
+
+// Conexão perdida ou recusada: o PCB já foi liberado pelo lwIP
+static void mqtt_err(void *arg, err_t err)
+{
+    mqtt_pcb = NULL;
+    schedule_retry();
+}
+
+static err_t mqtt_connected(void *arg, struct tcp_pcb *tpcb, err_t err)
+{
+    TRACE_BEGIN(TRACE_MQTT_CONNECTED);
+
+    if (err != ERR_OK || !send_connect())
+    {
+        abort_connection();
+        TRACE_END(TRACE_MQTT_CONNECTED);
+        return ERR_ABRT;
+    }
+
+    state = MQTT_WAIT_CONNACK;
+    rx_stage = 0;
+    TRACE_END(TRACE_MQTT_CONNECTED);
+    return ERR_OK;
+}
+
+// Inicia a conexão TCP sem esperar: o resultado chega em mqtt_connected/mqtt_err
+static void start_connect()
+{
+    mqtt_pcb = tcp_new();
+
+    if (!mqtt_pcb)
+    {
+        schedule_retry();
+        return;
+    }
+
+    tcp_arg(mqtt_pcb, NULL);
+    tcp_recv(mqtt_pcb, mqtt_recv);
+    tcp_sent(mqtt_pcb, mqtt_sent);
+    tcp_err(mqtt_pcb, mqtt_err);
+
+    state = MQTT_TCP_CONNECTING;
+    connect_deadline = make_timeout_time_ms(MQTT_CONNECT_TIMEOUT_MS);
+
+    if (tcp_connect(mqtt_pcb, &broker_addr, MQTT_BROKER_PORT, mqtt_connected) != ERR_OK)
+        drop_connection();
+}
+
+// Amostra os níveis e registra transições de classe
+static void sample_regions()
+{
+    state_snapshot view;
+    uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+    bool sample_due = time_reached(next_sample_time);
+
+    read_state(&view);
+
+    if (sample_due)
+        next_sample_time = make_timeout_time_ms(MQTT_SAMPLE_PERIOD_MS);
+
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        mqtt_sample sample = {
+            .time_ms = now_ms,
+            .region = i,
+            .level = view.regions[i].current_level,
+            .class = classify_region(&view.regions[i]),
+            .previous_class = last_class[i],
+        };
+
+        if (sample.class != last_class[i])
+        {
+            queue_push(alert_queue, MQTT_ALERT_QUEUE_SIZE, &alert_head, &alert_count, sample);
+            last_class[i] = sample.class;
+        }
+
+        if (sample_due)
+            queue_push(sample_queue, MQTT_QUEUE_SIZE, &sample_head, &sample_count, sample);
+    }
+}
+
+// Prepara o cliente; a conexão é iniciada em mqtt_poll()
+void configure_mqtt()
+{
+    if (strlen(MQTT_BROKER_IP) == 0 || !ipaddr_aton(MQTT_BROKER_IP, &broker_addr))
+        return;
+
+    node_id = get_node_id();
+    snprintf(client_id, sizeof(client_id), "floodsense-%04x", node_id);
+    snprintf(topic_levels, sizeof(topic_levels), MQTT_TOPIC_LEVELS, node_id);
+    snprintf(topic_alerts, sizeof(topic_alerts), MQTT_TOPIC_ALERTS, node_id);
+
+    state_snapshot view;
+
+    read_state(&view);
+    last_class[0] = classify_region(&view.regions[0]);
+    last_class[1] = classify_region(&view.regions[1]);
+
+    next_sample_time = get_absolute_time();
+    next_retry_time = get_absolute_time();
+    state = MQTT_DISCONNECTED;
+}
+
+// Amostra os níveis, detecta transições e avança a conexão (chamar no laço principal)
+void mqtt_poll()
+{
+    if (state == MQTT_DISABLED)
+        return;
+
+    sample_regions();
+
+    cyw43_arch_lwip_begin();
+
+    switch (state)
+    {
+    case MQTT_DISCONNECTED:
+        if (time_reached(next_retry_time))
+            start_connect();
+        break;
+
+    case MQTT_TCP_CONNECTING:
+    case MQTT_WAIT_CONNACK:
+        if (time_reached(connect_deadline))
+            drop_connection();
+        break;
+
+    case MQTT_CONNECTED:
+        while (alert_count > 0 && publish_alert())
+        {
+        }
+
+        while (alert_count == 0 && batch_ready() && publish_batch())
+        {
+        }
+
+        if (state == MQTT_CONNECTED && time_reached(next_ping_time))
+        {
+            static const uint8_t pingreq[2] = {MQTT_PACKET_PINGREQ, 0};
+
+            if (ping_outstanding)
+            {
+                // Sem PINGRESP durante meio keep alive: conexão morta
+                drop_connection();
+            }
+            else if (send_packet(pingreq, sizeof(pingreq)))
+            {
+                ping_outstanding = true;
+                next_ping_time = make_timeout_time_ms(MQTT_KEEPALIVE_S * 500);
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    cyw43_arch_lwip_end();
+}
+
+static absolute_time_t earliest(absolute_time_t a, absolute_time_t b)
+{
+    return absolute_time_diff_us(a, b) < 0 ? b : a;
+}
+
+// Próximo instante em que mqtt_poll() tem trabalho agendado
+absolute_time_t mqtt_next_deadline()
+{
+    if (state == MQTT_DISABLED)
+        return at_the_end_of_time;
+
+    absolute_time_t deadline = next_sample_time;
+
+    switch (state)
+    {
+    case MQTT_DISCONNECTED:
+        deadline = earliest(deadline, next_retry_time);
+        break;
+
+    case MQTT_TCP_CONNECTING:
+    case MQTT_WAIT_CONNACK:
+        deadline = earliest(deadline, connect_deadline);
+        break;
+
+    case MQTT_CONNECTED:
+        deadline = earliest(deadline, next_ping_time);
+
+        // Um lote incompleto vence pela idade; lotes prontos que não couberam esperam o tcp_sent
+        if (sample_count > 0 && !batch_ready())
+        {
+            uint64_t due_ms = (uint64_t)sample_queue[sample_head].time_ms + MQTT_BATCH_MAX_AGE_MS;
+            deadline = earliest(deadline, from_us_since_boot(due_ms * 1000));
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    return deadline;
+}
+
+// Estado atual da conexão com o broker
+mqtt_state mqtt_get_state()
+{
+    return state;
+}
+
+// Amostras descartadas por falta de espaço na fila
+uint32_t mqtt_get_dropped()
+{
+    return dropped_samples;
+}
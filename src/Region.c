@@ -0,0 +1,161 @@
+#include "Region.h"        // Estado compartilhado das regiões monitoradas
+#include "hardware/sync.h" // Barreiras de memória da publicação
+
+bool is_region_A = true;
+volatile uint32_t state_version = 0;
+
+region_state region_A;
+region_state region_B;
+
+uint8_t readings_A[MAX_READINGS] = {INITIAL_LEVEL_A}; // Array para armazenar os níveis de água da região A
+uint8_t readings_B[MAX_READINGS] = {INITIAL_LEVEL_B}; // Array para armazenar os níveis de água da região B
+
+event_record event_log[MAX_EVENTS]; // Array para armazenar os eventos
+int total_events = 0;
+
+// Estado publicado em duas cópias (seqlock em latch). A sequência ímpar manda
+// os leitores para a cópia 1 enquanto a 0 é escrita, a par para a 0 enquanto a
+// 1 é escrita: um leitor que interrompe uma publicação (callback do lwIP, IRQ)
+// sempre acha uma cópia estável e não espera pelo escritor. Um leitor
+// interrompido por uma publicação só repete a cópia.
+static state_snapshot published[2];
+static volatile uint32_t publish_seq = 0;
+
+_Static_assert(sizeof(event_record) == 8, "evento deve ocupar 8 bytes");
+
+// Rótulos [periférico][ligado] montados só na renderização
+static const char *const peripheral_labels[PERIPHERAL_COUNT][2] = {
+    [PERIPHERAL_LED_NORMAL] = {"🟢 LED-Normal | Desligado", "🟢 LED-Normal | Ligado"},
+    [PERIPHERAL_LED_ATTENTION] = {"🟠 LED-Atenção | Desligado", "🟠 LED-Atenção | Ligado"},
+    [PERIPHERAL_LED_ALERT] = {"🔴 LED-Alerta | Desligado", "🔴 LED-Alerta | Ligado"},
+    [PERIPHERAL_BUZZER] = {"🔊 Buzzer | Desligado", "🔊 Buzzer | Ligado"},
+};
+
+// Inicializa o estado das regiões com os níveis e limiares padrão
+void init_regions()
+{
+    region_A.led_color = GREEN;
+    region_A.buzzer_on = false;
+    region_A.current_level = INITIAL_LEVEL_A;
+    region_A.attention_threshold = ATTENTION_THRESHOLD_A;
+    region_A.alert_threshold = ALERT_THRESHOLD_A;
+    region_A.led_status = PERIPHERAL_LED_NORMAL;
+    region_A.led_status_on = true;
+
+    region_B.led_color = GREEN;
+    region_B.buzzer_on = false;
+    region_B.current_level = INITIAL_LEVEL_B;
+    region_B.attention_threshold = ATTENTION_THRESHOLD_B;
+    region_B.alert_threshold = ALERT_THRESHOLD_B;
+    region_B.led_status = PERIPHERAL_LED_NORMAL;
+    region_B.led_status_on = true;
+
+    publish_state();
+}
+
+// Move todos os elementos para a esquerda e adiciona novo valor no final
+void add_reading(uint8_t new_value, uint8_t readings[])
+{
+    for (int i = 0; i < MAX_READINGS - 1; i++)
+    {
+        readings[i] = readings[i + 1];
+    }
+    readings[MAX_READINGS - 1] = new_value;
+}
+
+static void capture_state(state_snapshot *snapshot)
+{
+    snapshot->version = state_version;
+    snapshot->is_region_A = is_region_A;
+    snapshot->regions[0] = region_A;
+    snapshot->regions[1] = region_B;
+    memcpy(snapshot->readings[0], readings_A, sizeof(readings_A));
+    memcpy(snapshot->readings[1], readings_B, sizeof(readings_B));
+    memcpy(snapshot->events, event_log, sizeof(event_log));
+    snapshot->event_count = (uint8_t)total_events;
+}
+
+// Publica um lote de mudanças no estado das regiões (uma vez por lote, não por campo)
+void publish_state()
+{
+    state_version++;
+
+    publish_seq++; // Ímpar: leitores na cópia 1
+    __dmb();
+    capture_state(&published[0]);
+    __dmb();
+
+    publish_seq++; // Par: leitores na cópia 0
+    __dmb();
+    capture_state(&published[1]);
+    __dmb();
+}
+
+// Copia o último estado publicado; nunca espera por uma publicação em andamento
+void read_state(state_snapshot *snapshot)
+{
+    uint32_t seq;
+
+    do
+    {
+        seq = publish_seq;
+        __dmb();
+        *snapshot = published[seq & 1];
+        __dmb();
+    } while (seq != publish_seq);
+}
+
+// Adiciona um novo evento ao log
+void add_event(event_code code, const region_state *region, peripheral target, bool on)
+{
+    if (total_events < MAX_EVENTS)
+        total_events++;
+    else
+        memmove(&event_log[0], &event_log[1], (MAX_EVENTS - 1) * sizeof(event_record));
+
+    event_log[total_events - 1] = (event_record){
+        .time_ms = to_ms_since_boot(get_absolute_time()),
+        .code = code,
+        .region = region == &region_B ? 1 : 0,
+        .peripheral = target,
+        .on = on,
+    };
+}
+
+// Rótulo exibido para um periférico ligado ou desligado
+const char *peripheral_label(peripheral target, bool on)
+{
+    return target < PERIPHERAL_COUNT ? peripheral_labels[target][on ? 1 : 0] : "?";
+}
+
+// Nome da região ("A" ou "B") pelo índice usado nos eventos
+const char *region_name(uint8_t index)
+{
+    return index == 0 ? "A" : "B";
+}
+
+// Classifica o nível atual da região pelos seus limiares
+level_class classify_region(const region_state *region)
+{
+    if (region->current_level >= region->alert_threshold)
+        return LEVEL_ALERT;
+
+    if (region->current_level >= region->attention_threshold)
+        return LEVEL_ATTENTION;
+
+    return LEVEL_NORMAL;
+}
+
+// Nome da classe exibido no dashboard (também usado como classe CSS)
+const char *level_class_name(level_class class)
+{
+    switch (class)
+    {
+    case LEVEL_ALERT:
+        return "Alerta";
+    case LEVEL_ATTENTION:
+        return "Atenção";
+    default:
+        return "Normal";
+    }
+}
@@ -0,0 +1,133 @@
+#include "Sensor.h"  // Sensores de nível
+#include "Metrics.h" // Contadores de desempenho
+#include "Stream.h"  // Stream binário de amostras pelo USB
+
+static level_filter filters[2];
+static absolute_time_t next_sample;
+static absolute_time_t next_commit;
+static sensor_source source = NULL; // NULL: ADC
+
+// Função para configurar o ADC e os filtros (sem efeito com SENSOR_ENABLED 0)
+void configure_sensor()
+{
+    filter_init(&filters[0]);
+    filter_init(&filters[1]);
+
+    if (!SENSOR_ENABLED)
+        return;
+
+    adc_init();
+    adc_gpio_init(SENSOR_GPIO_A);
+    adc_gpio_init(SENSOR_GPIO_B);
+
+    next_sample = get_absolute_time();
+    next_commit = make_timeout_time_ms(SENSOR_COMMIT_MS);
+}
+
+// Leitura do ADC convertida em metros (Q8)
+static int32_t raw_to_level(uint16_t raw)
+{
+    return (int32_t)raw * SENSOR_RANGE_M * FILTER_ONE / 4095;
+}
+
+// Publica o nível filtrado da região; true se ele mudou
+static bool commit_level(region_state *region, uint8_t *readings, const level_filter *filter)
+{
+    int32_t level = (filter->ewma + FILTER_ONE / 2) >> FILTER_FRAC_BITS;
+
+    if (level < 0)
+        level = 0;
+    if (level > UINT8_MAX)
+        level = UINT8_MAX;
+
+    if (level == region->current_level)
+        return false;
+
+    region->current_level = (uint8_t)level;
+    add_reading(region->current_level, readings);
+    return true;
+}
+
+// Lê os dois canais e passa as leituras pelos filtros (laço principal ou IRQ do stream, nunca os dois)
+void sensor_acquire(sensor_sample *sample)
+{
+    sample->rejected = 0;
+
+    for (uint i = 0; i < 2; i++)
+    {
+        uint32_t rejected = filters[i].rejected;
+
+        if (source)
+            sample->raw[i] = source(i);
+        else
+        {
+            adc_select_input(i);
+            sample->raw[i] = adc_read();
+        }
+
+        sample->filtered[i] = filter_push(&filters[i], raw_to_level(sample->raw[i]));
+
+        if (filters[i].rejected != rejected)
+        {
+            sample->rejected |= 1u << i;
+            metrics_inc(METRIC_SENSOR_REJECTED);
+        }
+        else
+            metrics_inc(METRIC_SENSOR_ACCEPTED);
+    }
+}
+
+// Amostra os sensores e publica os níveis (chamar no laço principal, com o lock do lwIP)
+void sensor_poll()
+{
+    if (!SENSOR_ENABLED)
+        return;
+
+    // Com o stream ativo, quem amostra é a IRQ do timer
+    if (!stream_active() && absolute_time_diff_us(get_absolute_time(), next_sample) <= 0)
+    {
+        sensor_sample sample;
+
+        next_sample = make_timeout_time_ms(SENSOR_SAMPLE_MS);
+        sensor_acquire(&sample);
+    }
+
+    if (absolute_time_diff_us(get_absolute_time(), next_commit) > 0)
+        return;
+
+    next_commit = make_timeout_time_ms(SENSOR_COMMIT_MS);
+    sensor_commit();
+}
+
+// Publica os níveis filtrados das duas regiões (e o estado, se mudou); true se algum mudou
+bool sensor_commit()
+{
+    bool changed = commit_level(&region_A, readings_A, &filters[0]);
+    changed |= commit_level(&region_B, readings_B, &filters[1]);
+
+    if (changed)
+        publish_state();
+
+    return changed;
+}
+
+// Troca a fonte das leituras brutas (NULL volta ao ADC)
+void sensor_set_source(sensor_source read)
+{
+    source = read;
+}
+
+// Próximo instante em que sensor_poll() tem trabalho agendado
+absolute_time_t sensor_next_deadline()
+{
+    if (!SENSOR_ENABLED)
+        return at_the_end_of_time;
+
+    return stream_active() ? next_commit : next_sample;
+}
+
+// Filtro da região (0 = A, 1 = B), para diagnóstico
+const level_filter *sensor_filter(uint index)
+{
+    return &filters[index & 1];
+}
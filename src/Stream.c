@@ -0,0 +1,219 @@
+#include "Stream.h"        // Stream binário de amostras pelo USB
+#include "Metrics.h"       // Contadores de desempenho
+#include "Idle.h"          // Acorda o laço principal quando um bloco enche
+#include "hardware/sync.h" // Seção crítica ao escrever na FIFO do CDC
+#include "tusb.h"          // FIFO de transmissão do CDC (escrita sem bloquear)
+
+#define STREAM_PAYLOAD_SIZE (sizeof(stream_header) + STREAM_BLOCK_SAMPLES * sizeof(stream_record) + sizeof(uint32_t))
+#define STREAM_FRAME_SIZE (STREAM_PAYLOAD_SIZE + STREAM_PAYLOAD_SIZE / 254 + 3) // COBS + 0x00 antes e depois
+
+// O quadro é escrito inteiro de uma vez para o texto do console não cair no meio dele
+_Static_assert(STREAM_FRAME_SIZE <= CFG_TUD_CDC_TX_BUFSIZE, "quadro do stream maior que a FIFO do CDC");
+
+// Bloco de amostras: cheio (ready), pertence ao laço principal até ser codificado
+typedef struct
+{
+    stream_header header;
+    stream_record records[STREAM_BLOCK_SAMPLES];
+    volatile bool ready;
+} stream_block;
+
+static stream_block blocks[2];
+static volatile uint8_t filling = 0; // Bloco que a IRQ está enchendo
+static uint8_t sending = 0;          // Próximo bloco a codificar (os quadros saem em ordem)
+static volatile uint32_t lost = 0;
+static uint32_t sample_time_us = 0; // Instante agendado da próxima amostra
+static uint32_t seq = 0;
+static alarm_id_t alarm = 0;
+static bool active = false;
+
+static uint8_t frame[STREAM_FRAME_SIZE];
+static uint16_t frame_len = 0;
+static bool frame_pending = false; // Quadro montado esperando espaço na FIFO
+
+static int16_t clamp_q8(int32_t value)
+{
+    return value > INT16_MAX ? INT16_MAX : value < INT16_MIN ? INT16_MIN : (int16_t)value;
+}
+
+// Alarme de amostragem: adquire uma amostra e a guarda no bloco corrente
+static int64_t sample_alarm(alarm_id_t id, void *user_data)
+{
+    uint32_t time_us = sample_time_us;
+    stream_block *block = &blocks[filling];
+    sensor_sample sample;
+
+    // A aquisição roda sempre: o filtro e a publicação do nível não dependem do USB
+    sensor_acquire(&sample);
+    sample_time_us += STREAM_SAMPLE_US;
+
+    if (block->ready)
+    {
+        lost++;
+        metrics_inc(METRIC_STREAM_LOST);
+        return STREAM_SAMPLE_US;
+    }
+
+    if (block->header.count == 0)
+    {
+        block->header.time_us = time_us;
+        block->header.lost = lost;
+    }
+
+    stream_record *record = &block->records[block->header.count++];
+
+    for (int i = 0; i < 2; i++)
+    {
+        record->raw[i] = sample.raw[i] | (sample.rejected & (1u << i) ? STREAM_REJECTED : 0);
+        record->filtered[i] = clamp_q8(sample.filtered[i]);
+    }
+
+    if (block->header.count == STREAM_BLOCK_SAMPLES)
+    {
+        block->ready = true;
+        filling ^= 1;
+        idle_wake();
+    }
+
+    // Positivo: reagenda a partir do prazo anterior, sem acumular atraso
+    return STREAM_SAMPLE_US;
+}
+
+static void reset_block(stream_block *block)
+{
+    block->header.version = STREAM_VERSION;
+    block->header.count = 0;
+    block->header.period_us = STREAM_SAMPLE_US;
+    block->ready = false;
+}
+
+// COBS: cada 0x00 vira a distância até o próximo; o quadro não contém 0x00
+static uint16_t cobs_encode(const uint8_t *data, uint16_t len, uint8_t *out)
+{
+    uint16_t code_pos = 0;
+    uint16_t pos = 1;
+    uint8_t code = 1;
+
+    for (uint16_t i = 0; i < len; i++)
+    {
+        if (data[i] != 0)
+        {
+            out[pos++] = data[i];
+            code++;
+        }
+
+        if (data[i] == 0 || code == 0xFF)
+        {
+            out[code_pos] = code;
+            code_pos = pos++;
+            code = 1;
+        }
+    }
+
+    out[code_pos] = code;
+    return pos;
+}
+
+// Monta o quadro do bloco em frame[] e devolve o bloco à IRQ
+static void encode_block(stream_block *block)
+{
+    static uint8_t payload[STREAM_PAYLOAD_SIZE];
+    uint16_t len = sizeof(stream_header) + block->header.count * sizeof(stream_record);
+
+    block->header.seq = seq++;
+    memcpy(payload, &block->header, sizeof(stream_header));
+    memcpy(payload + sizeof(stream_header), block->records, block->header.count * sizeof(stream_record));
+
+    uint32_t crc = crc32(payload, len);
+    memcpy(payload + len, &crc, sizeof(crc));
+    len += sizeof(crc);
+
+    metrics_add(METRIC_STREAM_SENT, block->header.count);
+    reset_block(block);
+
+    frame[0] = 0;
+    frame_len = 1 + cobs_encode(payload, len, frame + 1);
+    frame[frame_len++] = 0;
+    frame_pending = true;
+}
+
+// Escreve o quadro inteiro na FIFO do CDC se houver espaço; senão tenta de novo depois
+static void write_frame()
+{
+    // Sem interrupções: o tud_task() do stdio USB roda em IRQ e divide a FIFO
+    // com esta escrita, e nenhum printf entra entre os bytes do quadro
+    uint32_t status = save_and_disable_interrupts();
+
+    if (tud_cdc_write_available() >= frame_len)
+    {
+        tud_cdc_write(frame, frame_len);
+        tud_cdc_write_flush();
+        frame_pending = false;
+    }
+
+    restore_interrupts(status);
+}
+
+// Liga ou desliga o stream (comando do console)
+void stream_toggle()
+{
+    if (active)
+    {
+        cancel_alarm(alarm);
+        active = false;
+        printf("stream: desligado (%lu quadros, %lu amostras perdidas)\n", (unsigned long)seq, (unsigned long)lost);
+        return;
+    }
+
+    if (!SENSOR_ENABLED)
+    {
+        printf("stream: sem sensores (compile com SENSOR_ENABLED=1)\n");
+        return;
+    }
+
+    reset_block(&blocks[0]);
+    reset_block(&blocks[1]);
+    filling = sending = 0;
+    lost = seq = 0;
+    frame_len = 0;
+    frame_pending = false;
+
+    printf("stream: ligado, %u Hz, %u amostras por quadro\n", 1000000u / STREAM_SAMPLE_US, STREAM_BLOCK_SAMPLES);
+    fflush(stdout);
+
+    sample_time_us = time_us_32() + STREAM_SAMPLE_US;
+    alarm = add_alarm_in_us(STREAM_SAMPLE_US, sample_alarm, NULL, true);
+    active = alarm > 0;
+}
+
+// true enquanto o stream está ligado (a aquisição roda na IRQ do timer)
+bool stream_active()
+{
+    return active;
+}
+
+// Codifica os blocos cheios e escreve na FIFO do CDC o que couber (chamar no laço principal)
+void stream_poll()
+{
+    if (frame_pending)
+        write_frame();
+
+    // O próximo quadro só é montado quando o anterior já saiu inteiro: um
+    // host lento segura os blocos e a IRQ passa a contar amostras perdidas
+    if (!frame_pending && blocks[sending].ready)
+    {
+        encode_block(&blocks[sending]);
+        sending ^= 1;
+        write_frame();
+    }
+}
+
+// Próximo instante em que stream_poll() tem trabalho agendado
+absolute_time_t stream_next_deadline()
+{
+    // FIFO sem espaço para o quadro: tenta de novo no próximo frame USB; blocos cheios acordam o laço por idle_wake()
+    if (frame_pending)
+        return make_timeout_time_ms(1);
+
+    return blocks[sending].ready ? get_absolute_time() : at_the_end_of_time;
+}
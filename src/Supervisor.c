@@ -0,0 +1,209 @@
+#include "Supervisor.h"        // Supervisor do laço principal
+#include "Idle.h"              // Maior espera do laço ocioso
+#include "hardware/watchdog.h" // Watchdog do RP2040
+
+#define SUPERVISOR_MAGIC 0x4653504Du // "FSPM": registro post-mortem na RAM
+
+// Motivo registrado para um reset do watchdog
+typedef enum
+{
+    POSTMORTEM_HANG = 0, // O supervisor parou de rodar (IRQs mascaradas, HardFault)
+    POSTMORTEM_STALL,    // O supervisor encontrou uma tarefa além do prazo
+    POSTMORTEM_UNKNOWN,  // Reset do watchdog sem registro válido
+    POSTMORTEM_REASON_COUNT
+} postmortem_reason;
+
+// Registro preservado entre resets a quente; só vale com magic e CRC corretos
+typedef struct
+{
+    uint32_t magic;
+    uint8_t reason;
+    uint8_t task;
+    uint16_t reserved;
+    uint32_t pc;           // Endereço de retorno do último supervisor_enter()
+    uint32_t task_ms;      // Tempo na tarefa na última verificação
+    uint32_t uptime_ms;
+    uint32_t loop_last_us; // Última iteração completa do laço
+    uint32_t loop_max_us;  // Maior iteração desde o boot
+    uint32_t crc;          // CRC-32 de todos os campos anteriores
+} postmortem_record;
+
+static const struct
+{
+    const char *name;
+    uint32_t limit_ms;
+} tasks[SUPERVISOR_TASK_COUNT] = {
+    [SUPERVISOR_TASK_WIFI] = {"wifi", 5000},       // cyw43_arch_init carrega o firmware do CYW43
+    [SUPERVISOR_TASK_CONSOLE] = {"console", 3000}, // O comando 'K' bloqueia ~1 s
+    [SUPERVISOR_TASK_INPUTS] = {"inputs", SUPERVISOR_STALL_MS},
+    [SUPERVISOR_TASK_NETWORK] = {"network", SUPERVISOR_STALL_MS},
+    [SUPERVISOR_TASK_OUTPUTS] = {"outputs", SUPERVISOR_STALL_MS},
+    [SUPERVISOR_TASK_CONFIG] = {"config", SUPERVISOR_STALL_MS},
+    [SUPERVISOR_TASK_IDLE] = {"idle", 2 * IDLE_MAX_SLEEP_MS},
+};
+
+static const char *const reason_names[POSTMORTEM_REASON_COUNT] = {"hang", "stall", "unknown"};
+
+static postmortem_record __uninitialized_ram(record);
+
+static postmortem_record last;     // Registro do reset anterior, copiado no boot
+static bool last_valid = false;    // true se o boot veio de um reset do watchdog
+static bool running = false;
+
+// Estado atual do laço; entered_us é escrito antes de task, então o alarme nunca vê uma tarefa nova com o instante antigo
+static volatile uint8_t current_task = SUPERVISOR_TASK_IDLE;
+static volatile uint32_t current_pc;
+static volatile uint32_t entered_us;
+static volatile uint32_t loop_last_us;
+static volatile uint32_t loop_max_us;
+
+static void record_commit()
+{
+    record.crc = crc32((const uint8_t *)&record, offsetof(postmortem_record, crc));
+}
+
+static bool record_valid()
+{
+    return record.magic == SUPERVISOR_MAGIC && record.reason < POSTMORTEM_REASON_COUNT &&
+           record.task < SUPERVISOR_TASK_COUNT &&
+           record.crc == crc32((const uint8_t *)&record, offsetof(postmortem_record, crc));
+}
+
+// Verificação periódica (IRQ do timer): registra o estado e alimenta o watchdog se a tarefa estiver no prazo
+static int64_t supervise(alarm_id_t id, void *user_data)
+{
+    uint8_t task = current_task;
+    uint32_t elapsed_us = time_us_32() - entered_us;
+    bool stalled = elapsed_us / 1000 > tasks[task].limit_ms;
+
+    record.magic = SUPERVISOR_MAGIC;
+    record.reason = stalled ? POSTMORTEM_STALL : POSTMORTEM_HANG;
+    record.task = task;
+    record.reserved = 0;
+    record.pc = current_pc;
+    record.task_ms = elapsed_us / 1000;
+    record.uptime_ms = (uint32_t)(time_us_64() / 1000);
+    record.loop_last_us = loop_last_us;
+    record.loop_max_us = loop_max_us;
+    record_commit();
+
+    // Sem alimentação o watchdog reinicia o nó com o registro da tarefa travada
+    if (stalled)
+        return 0;
+
+    watchdog_update();
+    return SUPERVISOR_CHECK_MS * 1000;
+}
+
+// Função para ler o registro do último reset, reportá-lo e ligar o watchdog e o supervisor
+void configure_supervisor()
+{
+    // Só o reset do watchdog conta: no power-on a RAM não inicializada tem lixo
+    if (watchdog_enable_caused_reboot())
+    {
+        last_valid = true;
+        if (record_valid())
+            last = record;
+        else
+            last = (postmortem_record){.reason = POSTMORTEM_UNKNOWN, .task = SUPERVISOR_TASK_IDLE};
+    }
+
+    record.magic = 0;
+
+    if (last_valid)
+        supervisor_report();
+
+    entered_us = time_us_32();
+    current_task = SUPERVISOR_TASK_IDLE;
+
+    watchdog_enable(SUPERVISOR_TIMEOUT_MS, true); // Pausado durante a depuração
+    running = add_alarm_in_ms(SUPERVISOR_CHECK_MS, supervise, NULL, true) > 0;
+    if (!running)
+        printf("supervisor: sem alarme livre, watchdog desligado\n");
+}
+
+// Marca a entrada do laço em uma tarefa (checkpoint do post-mortem)
+void __attribute__((noinline)) supervisor_enter(supervisor_task task)
+{
+    entered_us = time_us_32();
+    current_pc = (uint32_t)(uintptr_t)__builtin_return_address(0);
+    current_task = task;
+}
+
+// Registra a duração de uma iteração do laço (sem contar a espera)
+void supervisor_loop_time(uint32_t iteration_us)
+{
+    loop_last_us = iteration_us;
+    if (iteration_us > loop_max_us)
+        loop_max_us = iteration_us;
+}
+
+// Função para imprimir o post-mortem do último reset e o estado atual no console
+void supervisor_report()
+{
+    printf("# watchdog\n");
+
+    if (!last_valid)
+    {
+        printf("ultimo reset: nao foi o watchdog\n");
+    }
+    else if (last.reason == POSTMORTEM_UNKNOWN)
+    {
+        printf("ultimo reset: watchdog, sem registro valido\n");
+    }
+    else
+    {
+        printf("ultimo reset: watchdog (%s), tarefa %s ha %lu ms, pc 0x%08lx\n", reason_names[last.reason],
+               tasks[last.task].name, (unsigned long)last.task_ms, (unsigned long)last.pc);
+        printf("uptime %lu ms, laco: ultima %lu us, maxima %lu us\n", (unsigned long)last.uptime_ms,
+               (unsigned long)last.loop_last_us, (unsigned long)last.loop_max_us);
+    }
+
+    if (running)
+        printf("agora: tarefa %s, laco: ultima %lu us, maxima %lu us\n", tasks[current_task].name,
+               (unsigned long)loop_last_us, (unsigned long)loop_max_us);
+}
+
+// Função para travar o laço de propósito e verificar o reset pelo watchdog
+void supervisor_stall_test()
+{
+    printf("supervisor: travando a tarefa %s; reset em ate %u ms\n", tasks[current_task].name,
+           (unsigned)(tasks[current_task].limit_ms + SUPERVISOR_CHECK_MS + SUPERVISOR_TIMEOUT_MS));
+
+    while (true)
+        sleep_ms(100);
+}
+
+// Blocos do corpo de GET /api/postmortem
+uint16_t supervisor_units()
+{
+    return 1;
+}
+
+// Corpo JSON de GET /api/postmortem, em blocos (ver metrics_render)
+uint16_t supervisor_render(uint16_t *cursor, char *buffer, uint16_t size)
+{
+    int len;
+
+    if (*cursor >= supervisor_units())
+        return 0;
+
+    if (!last_valid)
+        len = snprintf(buffer, size, "{\"watchdog_reset\":false}\n");
+    else if (last.reason == POSTMORTEM_UNKNOWN)
+        len = snprintf(buffer, size, "{\"watchdog_reset\":true,\"reason\":\"unknown\"}\n");
+    else
+        len = snprintf(buffer, size,
+                       "{\"watchdog_reset\":true,\"reason\":\"%s\",\"task\":\"%s\",\"task_ms\":%lu,"
+                       "\"pc\":\"0x%08lx\",\"uptime_ms\":%lu,\"loop_last_us\":%lu,\"loop_max_us\":%lu}\n",
+                       reason_names[last.reason], tasks[last.task].name, (unsigned long)last.task_ms,
+                       (unsigned long)last.pc, (unsigned long)last.uptime_ms, (unsigned long)last.loop_last_us,
+                       (unsigned long)last.loop_max_us);
+
+    // O bloco que não coube é gerado de novo na próxima chamada
+    if (len < 0 || len >= size)
+        return 0;
+
+    (*cursor)++;
+    return (uint16_t)len;
+}
@@ -0,0 +1,241 @@
+#include "Telemetry.h" // Protocolo de telemetria binária via UDP
+#include "Trace.h"     // Rastreamento de eventos
+
+static struct udp_pcb *telemetry_pcb = NULL;
+static ip_addr_t telemetry_dest;
+static uint32_t telemetry_seq = 0;
+static uint16_t telemetry_node_id = 0;
+static absolute_time_t next_report_time;
+
+static void put_u16_le(uint8_t *buffer, uint16_t value)
+{
+    buffer[0] = value & 0xFF;
+    buffer[1] = value >> 8;
+}
+
+static void put_u32_le(uint8_t *buffer, uint32_t value)
+{
+    put_u16_le(buffer, value & 0xFFFF);
+    put_u16_le(buffer + 2, value >> 16);
+}
+
+static uint32_t get_u32_le(const uint8_t *buffer)
+{
+    return buffer[0] | (buffer[1] << 8) | (buffer[2] << 16) | ((uint32_t)buffer[3] << 24);
+}
+
+// Converte a cor do LED em um código compacto
+static uint8_t led_code(led_color color)
+{
+    if (color.red == 0 && color.green == 0 && color.blue == 0)
+        return TELEMETRY_LED_DARK;
+    if (color.red == GREEN.red && color.green == GREEN.green && color.blue == GREEN.blue)
+        return TELEMETRY_LED_GREEN;
+    if (color.red == ORANGE.red && color.green == ORANGE.green && color.blue == ORANGE.blue)
+        return TELEMETRY_LED_ORANGE;
+    if (color.red == RED.red && color.green == RED.green && color.blue == RED.blue)
+        return TELEMETRY_LED_RED;
+
+    return TELEMETRY_LED_OTHER;
+}
+
+static uint16_t get_u16_le(const uint8_t *buffer)
+{
+    return buffer[0] | (buffer[1] << 8);
+}
+
+// Estado atual do nó no formato do relatório, sem consumir a sequência
+void telemetry_snapshot(telemetry_report *report)
+{
+    state_snapshot view;
+
+    read_state(&view);
+
+    memset(report, 0, sizeof(*report));
+    report->uptime_ms = to_ms_since_boot(get_absolute_time());
+    report->node_id = telemetry_node_id;
+    report->flags = view.is_region_A ? TELEMETRY_FLAG_REGION_A : 0;
+    report->region_count = TELEMETRY_REGIONS;
+
+    for (int i = 0; i < TELEMETRY_REGIONS; i++)
+    {
+        const region_state *region = &view.regions[i];
+
+        report->regions[i].level = region->current_level;
+        report->regions[i].class = (uint8_t)classify_region(region);
+        report->regions[i].led = led_code(region->led_color);
+        report->regions[i].buzzer = region->buzzer_on ? 1 : 0;
+        report->regions[i].attention_threshold = region->attention_threshold;
+        report->regions[i].alert_threshold = region->alert_threshold;
+    }
+}
+
+// Monta um relatório com o estado atual; retorna o tamanho em bytes
+uint16_t telemetry_build_report(uint8_t *buffer, uint32_t request_seq)
+{
+    telemetry_report report;
+
+    telemetry_snapshot(&report);
+
+    buffer[0] = 'F';
+    buffer[1] = 'S';
+    buffer[2] = TELEMETRY_VERSION;
+    buffer[3] = TELEMETRY_TYPE_REPORT;
+    put_u32_le(buffer + 4, ++telemetry_seq);
+    put_u32_le(buffer + 8, request_seq);
+    put_u32_le(buffer + 12, report.uptime_ms);
+    put_u16_le(buffer + 16, report.node_id);
+    buffer[18] = report.flags;
+    buffer[19] = report.region_count;
+
+    for (int i = 0; i < TELEMETRY_REGIONS; i++)
+    {
+        uint8_t *record = buffer + TELEMETRY_HEADER_SIZE + i * TELEMETRY_REGION_SIZE;
+        const telemetry_region *region = &report.regions[i];
+
+        record[0] = region->level;
+        record[1] = region->class;
+        record[2] = region->led;
+        record[3] = region->buzzer;
+        record[4] = region->attention_threshold;
+        record[5] = region->alert_threshold;
+        put_u16_le(record + 6, 0);
+    }
+
+    return TELEMETRY_REPORT_SIZE;
+}
+
+// Monta uma requisição de relatório; retorna o tamanho em bytes
+uint16_t telemetry_build_request(uint8_t *buffer, uint32_t seq)
+{
+    memset(buffer, 0, TELEMETRY_HEADER_SIZE);
+    buffer[0] = 'F';
+    buffer[1] = 'S';
+    buffer[2] = TELEMETRY_VERSION;
+    buffer[3] = TELEMETRY_TYPE_REQUEST;
+    put_u32_le(buffer + 4, seq);
+
+    return TELEMETRY_HEADER_SIZE;
+}
+
+// Decodifica um relatório recebido; false se o pacote não for válido
+bool telemetry_parse_report(const uint8_t *data, uint16_t len, telemetry_report *report)
+{
+    if (len < TELEMETRY_HEADER_SIZE || data[0] != 'F' || data[1] != 'S' ||
+        data[2] != TELEMETRY_VERSION || data[3] != TELEMETRY_TYPE_REPORT)
+        return false;
+
+    if (len < TELEMETRY_HEADER_SIZE + data[19] * TELEMETRY_REGION_SIZE)
+        return false;
+
+    memset(report, 0, sizeof(*report));
+    report->seq = get_u32_le(data + 4);
+    report->ack = get_u32_le(data + 8);
+    report->uptime_ms = get_u32_le(data + 12);
+    report->node_id = get_u16_le(data + 16);
+    report->flags = data[18];
+    report->region_count = data[19] < TELEMETRY_REGIONS ? data[19] : TELEMETRY_REGIONS;
+
+    for (int i = 0; i < report->region_count; i++)
+    {
+        const uint8_t *record = data + TELEMETRY_HEADER_SIZE + i * TELEMETRY_REGION_SIZE;
+        telemetry_region *region = &report->regions[i];
+
+        region->level = record[0];
+        region->class = record[1];
+        region->led = record[2];
+        region->buzzer = record[3];
+        region->attention_threshold = record[4];
+        region->alert_threshold = record[5];
+    }
+
+    return true;
+}
+
+// Nome do código de LED (TELEMETRY_LED_*)
+const char *telemetry_led_name(uint8_t led)
+{
+    static const char *const names[] = {"apagado", "verde", "laranja", "vermelho", "outro"};
+
+    return led < sizeof(names) / sizeof(names[0]) ? names[led] : "outro";
+}
+
+// Envia um relatório para o destino informado
+static void telemetry_send(const ip_addr_t *addr, u16_t port, uint32_t request_seq)
+{
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, TELEMETRY_REPORT_SIZE, PBUF_RAM);
+
+    if (!p)
+        return;
+
+    telemetry_build_report((uint8_t *)p->payload, request_seq);
+    udp_sendto(telemetry_pcb, p, addr, port);
+    pbuf_free(p);
+}
+
+// Callback de recepção: responde requisições válidas ao remetente
+static void telemetry_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port)
+{
+    uint8_t header[TELEMETRY_HEADER_SIZE];
+
+    TRACE_BEGIN(TRACE_UDP_TELEMETRY);
+
+    if (pbuf_copy_partial(p, header, sizeof(header), 0) >= 8 &&
+        header[0] == 'F' && header[1] == 'S' &&
+        header[2] == TELEMETRY_VERSION &&
+        header[3] == TELEMETRY_TYPE_REQUEST)
+    {
+        telemetry_send(addr, port, get_u32_le(header + 4));
+    }
+
+    pbuf_free(p);
+
+    TRACE_END(TRACE_UDP_TELEMETRY);
+}
+
+// Cria o PCB UDP e passa a atender requisições na TELEMETRY_PORT
+void configure_telemetry()
+{
+    telemetry_node_id = get_node_id();
+
+    ipaddr_aton(TELEMETRY_DEST_ADDR, &telemetry_dest);
+    next_report_time = make_timeout_time_ms(TELEMETRY_PERIOD_MS);
+
+    telemetry_pcb = udp_new();
+    if (!telemetry_pcb)
+        return;
+
+    if (udp_bind(telemetry_pcb, IP_ADDR_ANY, TELEMETRY_PORT) != ERR_OK)
+    {
+        udp_remove(telemetry_pcb);
+        telemetry_pcb = NULL;
+        return;
+    }
+
+    udp_recv(telemetry_pcb, telemetry_recv, NULL);
+}
+
+// Envia o relatório periódico quando o intervalo expira (chamar no laço principal)
+void telemetry_poll()
+{
+    if (!telemetry_pcb || TELEMETRY_PERIOD_MS == 0)
+        return;
+
+    if (absolute_time_diff_us(get_absolute_time(), next_report_time) > 0)
+        return;
+
+    next_report_time = make_timeout_time_ms(TELEMETRY_PERIOD_MS);
+
+    cyw43_arch_lwip_begin();
+    telemetry_send(&telemetry_dest, TELEMETRY_COLLECTOR_PORT, 0);
+    cyw43_arch_lwip_end();
+}
+
+// Próximo instante em que telemetry_poll() tem trabalho agendado
+absolute_time_t telemetry_next_deadline()
+{
+    if (!telemetry_pcb || TELEMETRY_PERIOD_MS == 0)
+        return at_the_end_of_time;
+
+    return next_report_time;
+}
@@ -0,0 +1,223 @@
+#include "Template.h" // Renderizador de templates compilados
+
+static char chunk[TEMPLATE_CHUNK_SIZE];
+
+// Função para escrever bytes no writer
+void template_put(template_writer *w, const char *data, uint16_t len)
+{
+    if (w->overflow || len > w->size - w->len)
+    {
+        w->overflow = true;
+        return;
+    }
+
+    memcpy(w->buffer + w->len, data, len);
+    w->len += len;
+}
+
+// Função para escrever uma string terminada em zero no writer
+void template_put_str(template_writer *w, const char *s)
+{
+    if (s)
+        template_put(w, s, strlen(s));
+}
+
+// Função para escrever um inteiro em decimal no writer
+void template_put_int(template_writer *w, int32_t value)
+{
+    char digits[12];
+    int pos = sizeof(digits);
+    uint32_t magnitude = value < 0 ? -(uint32_t)value : (uint32_t)value;
+
+    do
+    {
+        digits[--pos] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    if (value < 0)
+        digits[--pos] = '-';
+
+    template_put(w, digits + pos, sizeof(digits) - pos);
+}
+
+// Função para iniciar o envio de um template com os valores e o contexto dos slots fn
+void template_stream_init(template_stream *stream, const template_def *def, const void *values, const void *context)
+{
+    stream->def = def;
+    stream->values = values;
+    stream->context = context;
+    stream->item = 0;
+    stream->offset = 0;
+}
+
+static void render_slot(const template_item *item, const void *values, template_writer *w)
+{
+    const uint8_t *field = (const uint8_t *)values + item->value;
+
+    switch (item->kind)
+    {
+    case TEMPLATE_INT:
+        template_put_int(w, *(const int32_t *)field);
+        break;
+    case TEMPLATE_STR:
+        template_put_str(w, *(const char *const *)field);
+        break;
+    case TEMPLATE_FN:
+    {
+        template_slot_fn fn = *(const template_slot_fn *)field;
+        if (fn)
+            fn(w);
+        break;
+    }
+    }
+}
+
+// Renderiza o template inteiro em buffer; retorna o tamanho ou 0 se não couber
+uint16_t template_render(const template_def *def, const void *values, const void *context, char *buffer, uint16_t size)
+{
+    template_writer w = {.buffer = buffer, .size = size, .context = context};
+
+    for (uint16_t i = 0; i < def->count && !w.overflow; i++)
+    {
+        const template_item *it = &def->items[i];
+
+        if (it->kind == TEMPLATE_TEXT)
+            template_put(&w, it->text, it->value);
+        else
+            render_slot(it, values, &w);
+    }
+
+    return w.overflow ? 0 : w.len;
+}
+
+// Entrega o conteúdo do chunk ao TCP (cópia); false se não houver espaço
+static bool flush(template_writer *w, struct tcp_pcb *tpcb, uint32_t *bytes_sent)
+{
+    if (w->len == 0)
+        return true;
+
+    if (w->len > tcp_sndbuf(tpcb) || tcp_write(tpcb, w->buffer, w->len, TCP_WRITE_FLAG_COPY) != ERR_OK)
+        return false;
+
+    *bytes_sent += w->len;
+    w->len = 0;
+    return true;
+}
+
+// Envia o quanto couber no buffer TCP; retorna true quando o template terminou
+bool template_stream_send(template_stream *stream, struct tcp_pcb *tpcb, uint32_t *bytes_sent)
+{
+    template_writer w = {.buffer = chunk, .context = stream->context};
+    const template_def *def = stream->def;
+
+    // O que está no chunk só conta como enviado depois do flush; se ele falhar,
+    // o envio recomeça da última posição entregue ao TCP (stream->item/offset)
+    uint16_t item = stream->item;
+    uint16_t offset = stream->offset;
+
+    while (item < def->count)
+    {
+        const template_item *it = &def->items[item];
+
+        // O chunk nunca guarda mais do que o TCP aceita agora
+        w.size = tcp_sndbuf(tpcb) < sizeof(chunk) ? tcp_sndbuf(tpcb) : sizeof(chunk);
+
+        if (it->kind == TEMPLATE_TEXT)
+        {
+            uint16_t remaining = it->value - offset;
+
+            if (remaining >= TEMPLATE_ZERO_COPY_MIN)
+            {
+                // Fragmento longo: esvazia o chunk e passa a referência ao TCP
+                if (!flush(&w, tpcb, bytes_sent))
+                    break;
+
+                stream->item = item;
+                stream->offset = offset;
+
+                uint16_t n = remaining < tcp_sndbuf(tpcb) ? remaining : tcp_sndbuf(tpcb);
+
+                if (n == 0 || tcp_write(tpcb, it->text + offset, n, 0) != ERR_OK)
+                    break;
+
+                *bytes_sent += n;
+                offset += n;
+            }
+            else
+            {
+                uint16_t space = w.size > w.len ? w.size - w.len : 0;
+
+                if (space == 0)
+                {
+                    // Chunk cheio: entrega ao TCP; com o chunk vazio, é o TCP que está cheio
+                    if (w.len == 0 || !flush(&w, tpcb, bytes_sent))
+                        break;
+
+                    stream->item = item;
+                    stream->offset = offset;
+                    continue;
+                }
+
+                uint16_t n = remaining < space ? remaining : space;
+
+                template_put(&w, it->text + offset, n);
+                offset += n;
+            }
+
+            if (offset == it->value)
+            {
+                item++;
+                offset = 0;
+            }
+
+            if (w.len == 0)
+            {
+                stream->item = item;
+                stream->offset = offset;
+            }
+            continue;
+        }
+
+        // Slots são escritos inteiros no chunk; se não couberem, o chunk é esvaziado antes
+        uint16_t start = w.len;
+
+        render_slot(it, stream->values, &w);
+
+        if (!w.overflow)
+        {
+            item++;
+            continue;
+        }
+
+        w.overflow = false;
+        w.len = start;
+
+        if (start > 0)
+        {
+            if (!flush(&w, tpcb, bytes_sent))
+                break;
+
+            stream->item = item;
+            stream->offset = offset;
+            continue;
+        }
+
+        // Nem no chunk vazio: espera o TCP liberar espaço, a menos que o slot não
+        // caiba nem com o buffer livre; nesse caso é omitido para o envio não travar
+        if (w.size < sizeof(chunk) && tcp_sndbuf(tpcb) < TCP_SND_BUF)
+            break;
+
+        item++;
+    }
+
+    if (flush(&w, tpcb, bytes_sent))
+    {
+        stream->item = item;
+        stream->offset = offset;
+    }
+
+    tcp_output(tpcb);
+
+    return stream->item >= def->count;
+}
@@ -0,0 +1,82 @@
+#include "Trace.h" // Rastreamento de eventos em anel na RAM
+
+trace_record trace_ring[TRACE_RING_SIZE];
+volatile uint32_t trace_head = 0;
+volatile bool trace_paused = false;
+spin_lock_t *trace_lock = NULL;
+
+#define TRACE_RECORDS_PER_LINE 8
+
+// Nome e contexto de execução (vira a "thread" no trace do Chrome) de cada evento
+static const struct
+{
+    const char *name;
+    const char *context;
+} trace_event_info[TRACE_EVENT_COUNT] = {
+    [TRACE_GPIO_IRQ] = {"gpio_irq", "irq"},
+    [TRACE_TCP_ACCEPT] = {"tcp_accept", "lwip"},
+    [TRACE_TCP_RECV] = {"tcp_recv", "lwip"},
+    [TRACE_TCP_SENT] = {"tcp_sent", "lwip"},
+    [TRACE_UDP_TELEMETRY] = {"udp_telemetry", "lwip"},
+    [TRACE_MQTT_CONNECTED] = {"mqtt_connected", "lwip"},
+    [TRACE_MQTT_RECV] = {"mqtt_recv", "lwip"},
+    [TRACE_LOOP] = {"loop", "main"},
+    [TRACE_DISPLAY_REFRESH] = {"display_refresh", "main"},
+    [TRACE_MATRIX_REFRESH] = {"matrix_refresh", "main"},
+    [TRACE_BUZZER_BEEP] = {"buzzer_beep", "main"},
+    [TRACE_BUTTON_EVENT] = {"button_event", "main"},
+};
+
+// Função para reservar o spinlock do anel (início do main, antes de lançar o núcleo 1)
+void configure_trace()
+{
+    trace_lock = spin_lock_instance(spin_lock_claim_unused(true));
+}
+
+// Função para despejar o anel no console (texto com os registros em hexadecimal)
+void trace_dump()
+{
+    // Pausa a gravação para o anel não mudar durante o envio; sob o spinlock,
+    // um registro em andamento no outro núcleo termina antes da leitura
+    uint32_t status = spin_lock_blocking(trace_lock);
+    trace_paused = true;
+    uint32_t head = trace_head;
+    spin_unlock(trace_lock, status);
+
+    uint32_t count = head < TRACE_RING_SIZE ? head : TRACE_RING_SIZE;
+    uint32_t first = head - count;
+
+    printf("# floodsense-trace 1\n");
+    printf("# clock_hz 1000000\n");
+    printf("# records %lu dropped %lu\n", (unsigned long)count, (unsigned long)(head - count));
+
+    for (int i = 1; i < TRACE_EVENT_COUNT; i++)
+        printf("E %d %s %s\n", i, trace_event_info[i].context, trace_event_info[i].name);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const uint8_t *bytes = (const uint8_t *)&trace_ring[(first + i) & (TRACE_RING_SIZE - 1)];
+
+        if (i % TRACE_RECORDS_PER_LINE == 0)
+            printf("D ");
+
+        for (size_t b = 0; b < sizeof(trace_record); b++)
+            printf("%02x", bytes[b]);
+
+        if (i % TRACE_RECORDS_PER_LINE == TRACE_RECORDS_PER_LINE - 1 || i == count - 1)
+            printf("\n");
+    }
+
+    printf("# end\n");
+    fflush(stdout);
+
+    trace_paused = false;
+}
+
+// Função para descartar os registros gravados
+void trace_clear()
+{
+    uint32_t status = spin_lock_blocking(trace_lock);
+    trace_head = 0;
+    spin_unlock(trace_lock, status);
+}
@@ -0,0 +1,506 @@
+#include "Webhook.h" // Webhooks de alerta
+#include "Metrics.h" // Contadores de desempenho
+#include "Idle.h"    // Acorda o laço principal quando uma entrega termina
+#include "Wifi.h"    // Estado do enlace
+
+#define WEBHOOK_REQUEST_SIZE 512 // Request montado (cabeçalhos e JSON), copiado pelo tcp_write
+#define WEBHOOK_STATUS_SIZE 12   // "HTTP/1.1 200"
+
+typedef struct
+{
+    ip_addr_t addr;
+    u16_t port;
+    char path[WEBHOOK_PATH_MAX];
+    uint32_t retry_delay_ms;
+    absolute_time_t next_attempt;
+} webhook_endpoint;
+
+// Fila preservada entre resets a quente; só vale com magic e CRC corretos
+typedef struct
+{
+    uint32_t magic;
+    uint32_t next_seq;
+    uint8_t endpoints; // Endpoints configurados quando a fila foi gravada
+    uint8_t head;      // Entrada mais antiga
+    uint8_t count;
+    uint8_t reserved;
+    webhook_alert queue[WEBHOOK_QUEUE_SIZE];
+    uint32_t crc; // CRC-32 de todos os campos anteriores
+} webhook_store;
+
+typedef enum
+{
+    DELIVERY_IDLE = 0,
+    DELIVERY_CONNECTING,
+    DELIVERY_WAITING // Request enviado, esperando a linha de status
+} delivery_state;
+
+static webhook_store __uninitialized_ram(store);
+
+static webhook_endpoint endpoints[WEBHOOK_ENDPOINTS_MAX];
+static uint endpoint_count = 0;
+static uint16_t node_id = 0;
+static uint8_t last_class[2];
+
+static delivery_state delivery = DELIVERY_IDLE;
+static struct tcp_pcb *client_pcb = NULL;
+static uint current_endpoint;
+static uint32_t current_seq;
+static uint next_endpoint = 0; // Revezamento entre endpoints
+static absolute_time_t delivery_deadline;
+static char status_line[WEBHOOK_STATUS_SIZE + 1];
+static uint8_t status_len;
+static char request[WEBHOOK_REQUEST_SIZE];
+
+static bool time_reached(absolute_time_t deadline)
+{
+    return absolute_time_diff_us(get_absolute_time(), deadline) <= 0;
+}
+
+static void store_commit()
+{
+    store.crc = crc32((const uint8_t *)&store, offsetof(webhook_store, crc));
+}
+
+static bool store_valid()
+{
+    return store.magic == WEBHOOK_MAGIC && store.endpoints == endpoint_count && store.count <= WEBHOOK_QUEUE_SIZE &&
+           store.head < WEBHOOK_QUEUE_SIZE && store.crc == crc32((const uint8_t *)&store, offsetof(webhook_store, crc));
+}
+
+static webhook_alert *alert_at(uint index)
+{
+    return &store.queue[(store.head + index) % WEBHOOK_QUEUE_SIZE];
+}
+
+static webhook_alert *find_alert(uint32_t seq)
+{
+    for (uint i = 0; i < store.count; i++)
+    {
+        if (alert_at(i)->seq == seq)
+            return alert_at(i);
+    }
+
+    return NULL;
+}
+
+// Cada endpoint entrega em ordem, então as entradas já entregues a todos formam o início da fila
+static void pop_delivered()
+{
+    while (store.count > 0 && alert_at(0)->pending == 0)
+    {
+        store.head = (store.head + 1) % WEBHOOK_QUEUE_SIZE;
+        store.count--;
+    }
+}
+
+// Lê a lista "ip[:porta][/caminho],..." de WEBHOOK_URLS; entradas inválidas são ignoradas
+static void parse_endpoints()
+{
+    static char list[] = WEBHOOK_URLS;
+    char *save = NULL;
+
+    for (char *item = strtok_r(list, ", ", &save); item; item = strtok_r(NULL, ", ", &save))
+    {
+        if (endpoint_count == WEBHOOK_ENDPOINTS_MAX)
+        {
+            printf("Webhook: mais de %d endpoints, %s ignorado\n", WEBHOOK_ENDPOINTS_MAX, item);
+            continue;
+        }
+
+        webhook_endpoint *ep = &endpoints[endpoint_count];
+        char *host = strncmp(item, "http://", 7) == 0 ? item + 7 : item;
+        char *slash = strchr(host, '/');
+        char *colon;
+
+        snprintf(ep->path, sizeof(ep->path), "%s", slash ? slash : "/");
+        if (slash)
+            *slash = '\0';
+
+        ep->port = 80;
+        colon = strchr(host, ':');
+        if (colon)
+        {
+            *colon = '\0';
+            ep->port = (u16_t)atoi(colon + 1);
+        }
+
+        if (!ipaddr_aton(host, &ep->addr) || ep->port == 0)
+        {
+            printf("Webhook: endpoint invalido %s\n", item);
+            continue;
+        }
+
+        ep->retry_delay_ms = WEBHOOK_RETRY_MIN_MS;
+        ep->next_attempt = get_absolute_time();
+        endpoint_count++;
+    }
+}
+
+// Lê WEBHOOK_URLS e recupera a fila preservada (chamar depois de restaurar as regiões)
+void configure_webhook()
+{
+    state_snapshot view;
+
+    parse_endpoints();
+
+    read_state(&view);
+    last_class[0] = classify_region(&view.regions[0]);
+    last_class[1] = classify_region(&view.regions[1]);
+
+    if (endpoint_count == 0)
+        return;
+
+    node_id = get_node_id();
+
+    if (store_valid())
+    {
+        printf("Webhook: %u alertas pendentes preservados\n", store.count);
+    }
+    else
+    {
+        memset(&store, 0, sizeof(store));
+        store.magic = WEBHOOK_MAGIC;
+        store.next_seq = 1;
+        store.endpoints = endpoint_count;
+        store_commit();
+    }
+
+    printf("Webhook: %u endpoints\n", endpoint_count);
+}
+
+// Registra uma transição, agrupando-a na última entrada da região se ela ainda não foi tentada
+static void enqueue_transition(uint8_t region, uint8_t level, uint8_t from, uint8_t to)
+{
+    uint8_t all = (1u << endpoint_count) - 1;
+    uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+
+    for (int i = store.count - 1; i >= 0; i--)
+    {
+        webhook_alert *alert = alert_at(i);
+
+        if (alert->region != region)
+            continue;
+
+        if (alert->attempted == 0)
+        {
+            alert->time_ms = now_ms;
+            alert->level = level;
+            alert->to = to;
+            if (to > alert->peak)
+                alert->peak = to;
+            if (alert->transitions < UINT8_MAX)
+                alert->transitions++;
+            metrics_inc(METRIC_WEBHOOK_COALESCED);
+            return;
+        }
+        break;
+    }
+
+    // Fila cheia: a transição mais antiga é descartada
+    if (store.count == WEBHOOK_QUEUE_SIZE)
+    {
+        store.head = (store.head + 1) % WEBHOOK_QUEUE_SIZE;
+        store.count--;
+        metrics_inc(METRIC_WEBHOOK_DROPPED);
+    }
+
+    *alert_at(store.count) = (webhook_alert){
+        .seq = store.next_seq++,
+        .time_ms = now_ms,
+        .region = region,
+        .level = level,
+        .from = from,
+        .to = to,
+        .peak = from > to ? from : to,
+        .pending = all,
+        .transitions = 1,
+    };
+    store.count++;
+}
+
+// Entradas e saídas do Alerta desde a última chamada
+static void detect_transitions()
+{
+    state_snapshot view;
+    bool changed = false;
+
+    read_state(&view);
+
+    for (uint8_t i = 0; i < 2; i++)
+    {
+        uint8_t class = classify_region(&view.regions[i]);
+
+        if (class == last_class[i])
+            continue;
+
+        if (class == LEVEL_ALERT || last_class[i] == LEVEL_ALERT)
+        {
+            enqueue_transition(i, view.regions[i].current_level, last_class[i], class);
+            changed = true;
+        }
+
+        last_class[i] = class;
+    }
+
+    if (changed)
+        store_commit();
+}
+
+// Desfaz a conexão sem disparar callbacks; false se foi preciso abortar o PCB
+static bool release_client()
+{
+    struct tcp_pcb *pcb = client_pcb;
+    bool closed = true;
+
+    if (!pcb)
+        return true;
+
+    client_pcb = NULL;
+    tcp_arg(pcb, NULL);
+    tcp_recv(pcb, NULL);
+    tcp_sent(pcb, NULL);
+    tcp_err(pcb, NULL);
+
+    if (tcp_close(pcb) != ERR_OK)
+    {
+        tcp_abort(pcb);
+        closed = false;
+    }
+
+    return closed;
+}
+
+// Conclui a entrega em andamento pelo status HTTP (0: sem resposta)
+static void finish_delivery(int status)
+{
+    webhook_endpoint *ep = &endpoints[current_endpoint];
+    webhook_alert *alert = find_alert(current_seq);
+    bool ok = status >= 200 && status < 300;
+    bool rejected = status >= 400 && status < 500 && status != 408 && status != 429;
+
+    if (ok || rejected)
+    {
+        // 4xx (fora 408/429) não melhora com novas tentativas: a entrada é dada como entregue
+        if (alert)
+            alert->pending &= ~(1u << current_endpoint);
+
+        metrics_inc(ok ? METRIC_WEBHOOK_DELIVERED : METRIC_WEBHOOK_DROPPED);
+        ep->retry_delay_ms = WEBHOOK_RETRY_MIN_MS;
+        ep->next_attempt = get_absolute_time();
+        pop_delivered();
+    }
+    else
+    {
+        metrics_inc(METRIC_WEBHOOK_RETRIES);
+        ep->next_attempt = make_timeout_time_ms(ep->retry_delay_ms);
+
+        ep->retry_delay_ms *= 2;
+        if (ep->retry_delay_ms > WEBHOOK_RETRY_MAX_MS)
+            ep->retry_delay_ms = WEBHOOK_RETRY_MAX_MS;
+    }
+
+    store_commit();
+    delivery = DELIVERY_IDLE;
+    next_endpoint = (current_endpoint + 1) % endpoint_count;
+
+    // O prazo mudou: o laço principal precisa recalcular quando acordar
+    idle_wake();
+}
+
+static err_t client_recv(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err)
+{
+    if (!p)
+    {
+        bool closed = release_client();
+
+        finish_delivery(0);
+        return closed ? ERR_OK : ERR_ABRT;
+    }
+
+    status_len += pbuf_copy_partial(p, status_line + status_len, WEBHOOK_STATUS_SIZE - status_len, 0);
+    tcp_recved(tpcb, p->tot_len);
+    pbuf_free(p);
+
+    if (status_len < WEBHOOK_STATUS_SIZE)
+        return ERR_OK;
+
+    // Só a linha de status importa: "HTTP/1.x NNN"
+    status_line[status_len] = '\0';
+    int status = strncmp(status_line, "HTTP/1.", 7) == 0 ? atoi(status_line + 9) : 0;
+    bool closed = release_client();
+
+    finish_delivery(status);
+    return closed ? ERR_OK : ERR_ABRT;
+}
+
+// Conexão perdida ou recusada: o PCB já foi liberado pelo lwIP
+static void client_err(void *arg, err_t err)
+{
+    client_pcb = NULL;
+    finish_delivery(0);
+}
+
+static int build_request(const webhook_endpoint *ep, const webhook_alert *alert)
+{
+    static char body[256];
+    int body_len = snprintf(body, sizeof(body),
+                            "{\"node\":\"%04x\",\"seq\":%lu,\"t\":%lu,\"region\":\"%c\",\"level\":%u,"
+                            "\"from\":\"%s\",\"to\":\"%s\",\"peak\":\"%s\",\"transitions\":%u}",
+                            node_id, (unsigned long)alert->seq, (unsigned long)alert->time_ms, 'A' + alert->region,
+                            alert->level, level_class_name(alert->from), level_class_name(alert->to),
+                            level_class_name(alert->peak), alert->transitions);
+
+    if (body_len < 0 || body_len >= (int)sizeof(body))
+        return -1;
+
+    int len = snprintf(request, sizeof(request),
+                       "POST %s HTTP/1.1\r\n"
+                       "Host: %s:%u\r\n"
+                       "Content-Type: application/json\r\n"
+                       "Content-Length: %d\r\n"
+                       "Connection: close\r\n"
+                       "\r\n"
+                       "%s",
+                       ep->path, ipaddr_ntoa(&ep->addr), ep->port, body_len, body);
+
+    return len < (int)sizeof(request) ? len : -1;
+}
+
+static err_t client_connected(void *arg, struct tcp_pcb *tpcb, err_t err)
+{
+    const webhook_alert *alert = find_alert(current_seq);
+    int len = alert ? build_request(&endpoints[current_endpoint], alert) : -1;
+
+    if (err != ERR_OK || len < 0 || tcp_write(tpcb, request, len, TCP_WRITE_FLAG_COPY) != ERR_OK)
+    {
+        client_pcb = NULL;
+        tcp_err(tpcb, NULL);
+        tcp_abort(tpcb);
+
+        // Entrada descartada pela fila cheia durante a conexão: nada a repetir
+        if (!alert)
+        {
+            delivery = DELIVERY_IDLE;
+            idle_wake();
+        }
+        else
+        {
+            finish_delivery(0);
+        }
+        return ERR_ABRT;
+    }
+
+    tcp_output(tpcb);
+    delivery = DELIVERY_WAITING;
+    return ERR_OK;
+}
+
+// Entrada mais antiga que o endpoint ainda não recebeu
+static webhook_alert *next_for_endpoint(uint endpoint)
+{
+    for (uint i = 0; i < store.count; i++)
+    {
+        if (alert_at(i)->pending & (1u << endpoint))
+            return alert_at(i);
+    }
+
+    return NULL;
+}
+
+// Inicia a conexão para o próximo endpoint com entrega pendente e fora do backoff
+static void start_delivery()
+{
+    for (uint k = 0; k < endpoint_count; k++)
+    {
+        uint e = (next_endpoint + k) % endpoint_count;
+        webhook_alert *alert = next_for_endpoint(e);
+
+        if (!alert || !time_reached(endpoints[e].next_attempt))
+            continue;
+
+        current_endpoint = e;
+        current_seq = alert->seq;
+        alert->attempted |= 1u << e;
+        store_commit();
+
+        status_len = 0;
+        delivery = DELIVERY_CONNECTING;
+        delivery_deadline = make_timeout_time_ms(WEBHOOK_TIMEOUT_MS);
+
+        client_pcb = tcp_new();
+        if (!client_pcb)
+        {
+            finish_delivery(0);
+            return;
+        }
+
+        tcp_arg(client_pcb, NULL);
+        tcp_recv(client_pcb, client_recv);
+        tcp_err(client_pcb, client_err);
+
+        if (tcp_connect(client_pcb, &endpoints[e].addr, endpoints[e].port, client_connected) != ERR_OK)
+        {
+            release_client();
+            finish_delivery(0);
+        }
+        return;
+    }
+}
+
+// Detecta transições e avança as entregas (chamar no laço principal)
+void webhook_poll()
+{
+    if (endpoint_count == 0)
+        return;
+
+    // As entregas alteram a fila nos callbacks do lwIP
+    bool network = wifi_stack_ready();
+
+    if (network)
+        cyw43_arch_lwip_begin();
+
+    detect_transitions();
+
+    if (delivery != DELIVERY_IDLE && time_reached(delivery_deadline))
+    {
+        release_client();
+        finish_delivery(0);
+    }
+
+    if (delivery == DELIVERY_IDLE && network && wifi_get_state() == WIFI_CONNECTED)
+        start_delivery();
+
+    if (network)
+        cyw43_arch_lwip_end();
+}
+
+// Próximo instante em que webhook_poll() tem trabalho agendado
+absolute_time_t webhook_next_deadline()
+{
+    if (endpoint_count == 0)
+        return at_the_end_of_time;
+
+    if (delivery != DELIVERY_IDLE)
+        return delivery_deadline;
+
+    // Sem enlace não há o que agendar: a volta do Wi-Fi acorda o laço
+    if (wifi_get_state() != WIFI_CONNECTED)
+        return at_the_end_of_time;
+
+    absolute_time_t deadline = at_the_end_of_time;
+
+    for (uint e = 0; e < endpoint_count; e++)
+    {
+        if (next_for_endpoint(e) && absolute_time_diff_us(endpoints[e].next_attempt, deadline) > 0)
+            deadline = endpoints[e].next_attempt;
+    }
+
+    return deadline;
+}
+
+// Transições pendentes na fila
+uint webhook_pending()
+{
+    return endpoint_count ? store.count : 0;
+}
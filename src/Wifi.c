@@ -0,0 +1,190 @@
+#include "Wifi.h"    // Gerência assíncrona do Wi-Fi
+#include "Metrics.h" // Tentativas e transições do enlace
+
+static wifi_state state = WIFI_STACK_DOWN;
+static bool stack_ready = false;
+static absolute_time_t next_action_time;  // Próxima tentativa (BACKOFF/STACK_DOWN) ou consulta
+static absolute_time_t attempt_deadline;  // Limite da associação em andamento
+static uint32_t retry_delay_ms = WIFI_RETRY_MIN_MS;
+
+static uint64_t outage_start_us = 0; // Início da queda atual (ou boot)
+static uint32_t last_connect_ms = 0;
+static uint64_t connect_total_ms = 0;
+static uint32_t connect_count = 0;
+
+static bool time_reached(absolute_time_t deadline)
+{
+    return absolute_time_diff_us(get_absolute_time(), deadline) <= 0;
+}
+
+// Agenda a próxima tentativa com backoff exponencial
+static void schedule_retry(wifi_state next)
+{
+    state = next;
+    next_action_time = make_timeout_time_ms(retry_delay_ms);
+
+    retry_delay_ms *= 2;
+    if (retry_delay_ms > WIFI_RETRY_MAX_MS)
+        retry_delay_ms = WIFI_RETRY_MAX_MS;
+}
+
+// Inicia uma associação; o resultado é acompanhado em wifi_poll()
+static void start_connect()
+{
+    metrics_inc(METRIC_WIFI_CONNECT_ATTEMPTS);
+
+    if (cyw43_arch_wifi_connect_async(WIFI_SSID, WIFI_PASSWORD, CYW43_AUTH_WPA2_AES_PSK) != 0)
+    {
+        schedule_retry(WIFI_BACKOFF);
+        return;
+    }
+
+    state = WIFI_CONNECTING;
+    attempt_deadline = make_timeout_time_ms(WIFI_CONNECT_TIMEOUT_MS);
+    next_action_time = make_timeout_time_ms(WIFI_CONNECTING_POLL_MS);
+}
+
+static bool init_stack()
+{
+    if (cyw43_arch_init())
+        return false;
+
+    // GPIO do CI CYW43 em nível baixo
+    cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 0);
+
+    // Ativa o Wi-Fi no modo Station, de modo a que possam ser feitas ligações a outros pontos de acesso Wi-Fi.
+    cyw43_arch_enable_sta_mode();
+
+    stack_ready = true;
+    return true;
+}
+
+// Função para iniciar o Wi-Fi sem bloquear (a associação continua em wifi_poll)
+void configure_wifi()
+{
+    outage_start_us = time_us_64();
+    next_action_time = get_absolute_time();
+    state = WIFI_STACK_DOWN;
+}
+
+// Avança a máquina de estados; retorna a transição ocorrida, se houver (chamar no laço principal)
+wifi_event wifi_poll()
+{
+    if (stack_ready)
+        cyw43_arch_poll(); // Necessário para manter o Wi-Fi ativo
+
+    switch (state)
+    {
+    case WIFI_STACK_DOWN:
+        if (!time_reached(next_action_time))
+            break;
+
+        if (!init_stack())
+        {
+            schedule_retry(WIFI_STACK_DOWN);
+            break;
+        }
+
+        start_connect();
+        return WIFI_EVENT_STACK_READY;
+
+    case WIFI_BACKOFF:
+        if (time_reached(next_action_time))
+        {
+            // Encerra o que tiver sobrado da tentativa anterior antes de recomeçar
+            cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+            start_connect();
+        }
+        break;
+
+    case WIFI_CONNECTING:
+    {
+        if (!time_reached(next_action_time))
+            break;
+
+        int status = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA);
+
+        if (status == CYW43_LINK_UP)
+        {
+            state = WIFI_CONNECTED;
+            retry_delay_ms = WIFI_RETRY_MIN_MS;
+            next_action_time = make_timeout_time_ms(WIFI_LINK_CHECK_MS);
+
+            last_connect_ms = (uint32_t)((time_us_64() - outage_start_us) / 1000);
+            connect_total_ms += last_connect_ms;
+            connect_count++;
+
+            metrics_inc(METRIC_WIFI_LINK_UP);
+            return WIFI_EVENT_LINK_UP;
+        }
+
+        if (status < 0 || time_reached(attempt_deadline))
+            schedule_retry(WIFI_BACKOFF); // CYW43_LINK_FAIL, NONET, BADAUTH ou tempo esgotado
+        else
+            next_action_time = make_timeout_time_ms(WIFI_CONNECTING_POLL_MS);
+        break;
+    }
+
+    case WIFI_CONNECTED:
+        if (!time_reached(next_action_time))
+            break;
+
+        next_action_time = make_timeout_time_ms(WIFI_LINK_CHECK_MS);
+
+        if (cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA) != CYW43_LINK_UP)
+        {
+            outage_start_us = time_us_64();
+            retry_delay_ms = WIFI_RETRY_MIN_MS;
+            schedule_retry(WIFI_BACKOFF);
+
+            metrics_inc(METRIC_WIFI_LINK_DOWN);
+            return WIFI_EVENT_LINK_DOWN;
+        }
+        break;
+    }
+
+    return WIFI_EVENT_NONE;
+}
+
+// Próximo instante em que wifi_poll() tem trabalho agendado
+absolute_time_t wifi_next_deadline()
+{
+    return next_action_time;
+}
+
+// Estado atual da conexão
+wifi_state wifi_get_state()
+{
+    return state;
+}
+
+// Nome do estado para display e métricas
+const char *wifi_state_name(wifi_state s)
+{
+    static const char *const names[] = {"stack_down", "backoff", "connecting", "connected"};
+
+    return s <= WIFI_CONNECTED ? names[s] : "unknown";
+}
+
+// true depois que o cyw43_arch_init funcionou (lwIP e lock disponíveis)
+bool wifi_stack_ready()
+{
+    return stack_ready;
+}
+
+// Tempo da última queda (ou do boot) até a conexão, em milissegundos
+uint32_t wifi_last_connect_ms()
+{
+    return last_connect_ms;
+}
+
+// Soma dos tempos até a conexão e número de conexões, para a média em /metrics
+uint64_t wifi_connect_total_ms()
+{
+    return connect_total_ms;
+}
+
+uint32_t wifi_connect_count()
+{
+    return connect_count;
+}
@@ -1,5 +1,10 @@
 #include "ssd1306.h"
 #include "font.h"
+#include "Trace.h"
+#include "Accel.h"
+
+// Framebuffer estático: um byte de comando (0x40) seguido das páginas do display
+static uint8_t ram_buffer[SSD1306_BUFFER_SIZE];
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
   ssd->width = width;
@@ -8,7 +13,10 @@ void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_v
   ssd->address = address;
   ssd->i2c_port = i2c;
   ssd->bufsize = ssd->pages * ssd->width + 1;
-  ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+  if (ssd->bufsize > sizeof(ram_buffer))
+    ssd->bufsize = sizeof(ram_buffer);
+  ssd->ram_buffer = ram_buffer;
+  memset(ram_buffer, 0, sizeof(ram_buffer));
   ssd->ram_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
 }
@@ -53,6 +61,7 @@ void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
 }
 
 void ssd1306_send_data(ssd1306_t *ssd) {
+  TRACE_BEGIN(TRACE_DISPLAY_REFRESH);
   ssd1306_command(ssd, SET_COL_ADDR);
   ssd1306_command(ssd, 0);
   ssd1306_command(ssd, ssd->width - 1);
@@ -66,6 +75,7 @@ void ssd1306_send_data(ssd1306_t *ssd) {
     ssd->bufsize,
     false
   );
+  TRACE_END(TRACE_DISPLAY_REFRESH);
 }
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
@@ -77,24 +87,11 @@ void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
     ssd->ram_buffer[index] &= ~(1 << pixel);
 }
 
-/*
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-  uint8_t byte = value ? 0xFF : 0x00;
-  for (uint8_t i = 1; i < ssd->bufsize; ++i)
-    ssd->ram_buffer[i] = byte;
-}*/
-
+// Limpa ou acende o display inteiro de uma vez: cada byte do framebuffer são 8 pixels
 void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
-    }
+  memset(ssd->ram_buffer + 1, value ? 0xFF : 0x00, ssd->bufsize - 1);
 }
 
-
-
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
   for (uint8_t x = left; x < left + width; ++x) {
     ssd1306_pixel(ssd, x, top, value);
@@ -153,48 +150,56 @@ void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value
     ssd1306_pixel(ssd, x, y, value);
 }
 
+// Função para obter as 8 colunas do glifo de um caractere
+const uint8_t *ssd1306_glyph(char c)
+{
+  // Caractere fora da faixa ASCII imprimível vira o glifo 0 (espaço)
+  if (c >= ' ' && c <= '~')
+    return &font[(c - ' ') * 8];
+  return &font[0];
+}
+
 // Função para desenhar um caractere
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
 {
-  uint16_t index = 0;
-
-  // Verifica o caractere e calcula o índice correspondente na fonte
-  if (c >= ' ' && c <= '~') // Verifica se o caractere está na faixa ASCII válida
-  {
-    index = (c - ' ') * 8; // Calcula o índice baseado na posição do caractere na tabela ASCII
-  }
-  else
-  {
-    // Caractere inválido, desenha um espaço (ou pode ser tratado de outra forma)
-    index = 0; // Índice 0 corresponde ao caractere "nada" (espaço)
-  }
-
-  // Desenha o caractere na tela
-  for (uint8_t i = 0; i < 8; ++i)
-  {
-    uint8_t line = font[index + i]; // Acessa a linha correspondente do caractere na fonte
-    for (uint8_t j = 0; j < 8; ++j)
-    {
-      ssd1306_pixel(ssd, x + i, y + j, line & (1 << j)); // Desenha cada pixel do caractere
-    }
-  }
+  // As colunas da fonte já têm o formato das páginas do display: copia por byte
+  accel_blit_columns(ssd->ram_buffer + 1, ssd->width, ssd->pages, ssd1306_glyph(c), 8, x, y);
 }
 
 // Função para desenhar uma string
 void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
 {
-  while (*str)
+  uint8_t columns[WIDTH];
+  bool last_line = false;
+
+  while (*str && !last_line)
   {
-    ssd1306_draw_char(ssd, *str++, x, y);
-    x += 8;
-    if (x + 8 >= ssd->width)
-    {
-      x = 0;
-      y += 8;
-    }
-    if (y + 8 >= ssd->height)
+    // Junta os glifos de uma linha de texto e copia todas as colunas de uma vez
+    uint8_t start = x;
+    uint8_t line = y;
+    uint count = 0;
+
+    while (*str && y == line)
     {
-      break;
+      if (count + 8 <= sizeof(columns))
+      {
+        memcpy(columns + count, ssd1306_glyph(*str), 8);
+        count += 8;
+      }
+      str++;
+      x += 8;
+      if (x + 8 >= ssd->width)
+      {
+        x = 0;
+        y += 8;
+      }
+      if (y + 8 >= ssd->height)
+      {
+        last_line = true;
+        break;
+      }
     }
+
+    accel_blit_columns(ssd->ram_buffer + 1, ssd->width, ssd->pages, columns, count, start, line);
   }
-}
\ No newline at end of file
+}
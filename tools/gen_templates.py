@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+"""Compila templates HTML em tabelas C para o renderizador de lib/Template.h.
+
+Uso (chamado pelo CMake):
+  tools/gen_templates.py templates/dashboard.html -o build/generated
+
+Gera <nome>_template.h e <nome>_template.c, onde <nome> é o nome do arquivo.
+
+Sintaxe do template:
+  {{campo:int}}  inteiro (int32_t)
+  {{campo:str}}  string (const char *), inserida sem escape
+  {{campo:fn}}   função template_slot_fn que escreve o conteúdo
+  {# ... #}      comentário, removido
+
+Quebras de linha e a indentação no início das linhas são removidas, então o
+template pode ser formatado livremente (quebre linhas apenas entre tags ou
+instruções terminadas em ';'). Um mesmo campo pode aparecer várias vezes, mas
+sempre com o mesmo tipo.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+SLOT = re.compile(r"\{\{\s*([A-Za-z_][A-Za-z0-9_]*)\s*:\s*(int|str|fn)\s*\}\}")
+COMMENT = re.compile(r"\{#.*?#\}", re.S)
+C_TYPES = {"int": "int32_t", "str": "const char *", "fn": "template_slot_fn"}
+KINDS = {"int": "TEMPLATE_INT", "str": "TEMPLATE_STR", "fn": "TEMPLATE_FN"}
+
+
+def minify(text):
+    text = COMMENT.sub("", text)
+    return "".join(line.strip() for line in text.splitlines())
+
+
+def parse(text, path):
+    items, fields = [], {}
+    pos = 0
+    for match in SLOT.finditer(text):
+        if match.start() > pos:
+            items.append(("text", text[pos:match.start()]))
+        name, kind = match.groups()
+        if fields.setdefault(name, kind) != kind:
+            raise SystemExit(f"{path}: campo '{name}' usado como {fields[name]} e {kind}")
+        items.append((kind, name))
+        pos = match.end()
+    if pos < len(text):
+        items.append(("text", text[pos:]))
+
+    leftover = re.search(r"\{\{.*?\}\}", "".join(v for k, v in items if k == "text"))
+    if leftover:
+        raise SystemExit(f"{path}: slot inválido {leftover.group(0)!r}")
+    return items, fields
+
+
+def c_string(text):
+    out = []
+    for byte in text.encode("utf-8"):
+        ch = chr(byte)
+        if ch in "\\\"":
+            out.append("\\" + ch)
+        elif 32 <= byte < 127:
+            out.append(ch)
+        else:
+            out.append(f"\\{byte:03o}")
+    # "??" poderia formar um trígrafo
+    return "".join(out).replace("??", "?\\?")
+
+
+def wrap_literal(text, width=100):
+    """Divide o literal em linhas, sem quebrar sequências de escape."""
+    encoded = c_string(text)
+    lines, current, i = [], "", 0
+    while i < len(encoded):
+        step = 4 if encoded[i] == "\\" and encoded[i + 1:i + 2].isdigit() else (2 if encoded[i] == "\\" else 1)
+        current += encoded[i:i + step]
+        i += step
+        if len(current) >= width:
+            lines.append(current)
+            current = ""
+    if current or not lines:
+        lines.append(current)
+    return "\n".join(f'    "{line}"' for line in lines)
+
+
+def generate(path, outdir):
+    name = os.path.splitext(os.path.basename(path))[0]
+    with open(path, encoding="utf-8") as src:
+        items, fields = parse(minify(src.read()), path)
+
+    guard = f"{name.upper()}_TEMPLATE_H"
+    header = [
+        f"// Gerado por tools/gen_templates.py a partir de {os.path.basename(path)}. Não editar.",
+        f"#ifndef {guard}",
+        f"#define {guard}",
+        "",
+        '#include "Template.h"',
+        "",
+        "typedef struct",
+        "{",
+    ]
+    for field, kind in fields.items():
+        header.append(f"    {C_TYPES[kind]}{'' if kind == 'str' else ' '}{field};")
+    header += [
+        f"}} {name}_values;",
+        "",
+        f"extern const template_def {name}_template;",
+        "",
+        "#endif",
+        "",
+    ]
+
+    source = [
+        f"// Gerado por tools/gen_templates.py a partir de {os.path.basename(path)}. Não editar.",
+        "#include <stddef.h>",
+        f'#include "{name}_template.h"',
+        "",
+    ]
+    entries = []
+    text_index = 0
+    for kind, value in items:
+        if kind == "text":
+            size = len(value.encode("utf-8"))
+            if size > 0xFFFF:
+                raise SystemExit(f"{path}: fragmento com mais de 64 KB")
+            source.append(f"static const char text_{text_index}[] =\n{wrap_literal(value)};")
+            entries.append(f"    {{TEMPLATE_TEXT, sizeof(text_{text_index}) - 1, text_{text_index}}},")
+            text_index += 1
+        else:
+            entries.append(f"    {{{KINDS[kind]}, offsetof({name}_values, {value}), NULL}},")
+
+    source += [
+        "",
+        f"static const template_item items[] = {{",
+        *entries,
+        "};",
+        "",
+        f"const template_def {name}_template = {{items, sizeof(items) / sizeof(items[0])}};",
+        "",
+    ]
+
+    os.makedirs(outdir, exist_ok=True)
+    for suffix, lines in (("h", header), ("c", source)):
+        target = os.path.join(outdir, f"{name}_template.{suffix}")
+        with open(target, "w", encoding="utf-8") as out:
+            out.write("\n".join(lines))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("templates", nargs="+", help="arquivos .html")
+    parser.add_argument("-o", "--outdir", required=True, help="diretório dos arquivos gerados")
+    args = parser.parse_args()
+
+    for path in args.templates:
+        generate(path, args.outdir)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
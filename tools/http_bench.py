@@ -0,0 +1,467 @@
+#!/usr/bin/env python3
+"""Benchmark de carga e soak do servidor HTTP do FloodSense.
+
+Dispara clientes concorrentes contra um nó (placa ou simulação em Linux) e
+mede requisições por segundo, latência p50/p99, erros e, lendo /metrics
+antes e depois, esgotamento dos pools do lwIP e marcas d'água de memória.
+
+Modos de conexão:
+  keepalive  cada cliente pede keep-alive e reutiliza a conexão enquanto a
+             resposta permitir (sem "Connection: close")
+  close      uma conexão por requisição
+  mixed      metade dos clientes em cada modo
+
+O firmware responde sempre "Connection: close": hoje o modo keepalive abre uma
+conexão por requisição como o close, e o campo "reused" do relatório (requisições
+atendidas em uma conexão já usada) fica em 0. Ele passa a medir o reúso quando o
+servidor mantiver a conexão.
+
+Exemplos:
+  tools/http_bench.py run --spawn build/Flood_Sense_host --concurrency 8 --json out.json
+  tools/http_bench.py run --target 192.168.0.50:80 --mode close --duration 30
+  tools/http_bench.py soak --spawn build/Flood_Sense_host --duration 3600 --json soak.json
+  tools/http_bench.py compare base.json novo.json
+
+O servidor não envia Content-Length: o fim da resposta é o fechamento da
+conexão ou o marcador --end-marker (</html> por padrão).
+"""
+
+import argparse
+import json
+import re
+import socket
+import subprocess
+import sys
+import threading
+import time
+
+METRIC_LINE = re.compile(r"^([a-zA-Z_:][a-zA-Z0-9_:]*(?:\{[^}]*\})?) (\S+)$")
+
+
+# ---------------------------------------------------------------------------
+# Cliente HTTP mínimo
+
+def read_response(sock, end_marker, deadline):
+    """Lê até o marcador de fim ou o fechamento; retorna (bytes, fechada)."""
+    data = bytearray()
+    while True:
+        remaining = deadline - time.monotonic()
+        if remaining <= 0:
+            raise socket.timeout("resposta incompleta")
+        sock.settimeout(remaining)
+        chunk = sock.recv(16384)
+        if not chunk:
+            return bytes(data), True
+        data += chunk
+        if end_marker and end_marker in data[-len(chunk) - len(end_marker):]:
+            return bytes(data), False
+
+
+def connection_close(data):
+    """True se os cabeçalhos da resposta pedem o fechamento da conexão."""
+    head = data.partition(b"\r\n\r\n")[0]
+    for line in head.split(b"\r\n")[1:]:
+        name, _, value = line.partition(b":")
+        if name.strip().lower() == b"connection":
+            return value.strip().lower() == b"close"
+    return False
+
+
+def build_request(host, path, keepalive):
+    connection = "keep-alive" if keepalive else "close"
+    return (f"GET {path} HTTP/1.1\r\nHost: {host}\r\nConnection: {connection}\r\n\r\n").encode()
+
+
+def fetch(host, port, path, timeout):
+    """Requisição isolada (usada para ler /metrics)."""
+    with socket.create_connection((host, port), timeout=timeout) as sock:
+        sock.sendall(build_request(host, path, False))
+        data, _ = read_response(sock, None, time.monotonic() + timeout)
+    head, _, body = data.partition(b"\r\n\r\n")
+    if not head.startswith(b"HTTP/1.1 200"):
+        raise RuntimeError(f"{path}: resposta inesperada {head[:40]!r}")
+    return body.decode("utf-8", "replace")
+
+
+def scrape(host, port, timeout):
+    """Lê /metrics e devolve {nome{rótulos}: valor}; None se indisponível."""
+    try:
+        text = fetch(host, port, "/metrics", timeout)
+    except (OSError, RuntimeError):
+        return None
+
+    metrics = {}
+    for line in text.splitlines():
+        match = METRIC_LINE.match(line)
+        if match:
+            metrics[match.group(1)] = float(match.group(2))
+    return metrics
+
+
+# ---------------------------------------------------------------------------
+# Geração de carga
+
+class Stats:
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.latencies = []
+        self.errors = {}
+        self.bytes = 0
+        self.reused = 0
+
+    def ok(self, latency, size, reused):
+        with self.lock:
+            self.latencies.append(latency)
+            self.bytes += size
+            self.reused += reused
+
+    def error(self, kind):
+        with self.lock:
+            self.errors[kind] = self.errors.get(kind, 0) + 1
+
+
+def client_loop(args, keepalive, stop, stats):
+    host, port = args.host, args.port
+    end_marker = args.end_marker.encode() if args.end_marker else None
+    request = build_request(host, args.path, keepalive)
+    sock = None
+
+    while not stop.is_set():
+        start = time.monotonic()
+        deadline = start + args.timeout
+        reused = sock is not None
+        try:
+            if sock is None:
+                sock = socket.create_connection((host, port), timeout=args.timeout)
+            sock.sendall(request)
+            data, closed = read_response(sock, end_marker, deadline)
+            if data.startswith(b"HTTP/1.1 503"):
+                # Recusado pelo controle de admissão (Retry-After)
+                stats.error("shed")
+                closed = True
+            elif not data.startswith(b"HTTP/1.1 200"):
+                stats.error("status" if data else "empty")
+                closed = True
+            else:
+                stats.ok(time.monotonic() - start, len(data), reused)
+                # O servidor pediu o fechamento: a próxima requisição abre outra conexão
+                closed = closed or connection_close(data)
+        except socket.timeout:
+            stats.error("timeout")
+            closed = True
+        except ConnectionRefusedError:
+            stats.error("refused")
+            closed = True
+        except OSError:
+            stats.error("reset")
+            closed = True
+
+        if sock is not None and (closed or not keepalive):
+            sock.close()
+            sock = None
+
+        if args.think > 0:
+            stop.wait(args.think)
+
+    if sock is not None:
+        sock.close()
+
+
+def start_clients(args, stats, stop):
+    threads = []
+    for i in range(args.concurrency):
+        keepalive = args.mode == "keepalive" or (args.mode == "mixed" and i % 2 == 0)
+        thread = threading.Thread(target=client_loop, args=(args, keepalive, stop, stats), daemon=True)
+        thread.start()
+        threads.append(thread)
+    return threads
+
+
+def percentile(sorted_values, fraction):
+    if not sorted_values:
+        return None
+    index = min(len(sorted_values) - 1, int(round(fraction * (len(sorted_values) - 1))))
+    return sorted_values[index]
+
+
+def summarize(stats, elapsed):
+    latencies = sorted(stats.latencies)
+    ms = lambda v: None if v is None else round(v * 1000, 3)
+    return {
+        "requests": len(latencies),
+        "errors": dict(stats.errors),
+        "error_total": sum(stats.errors.values()),
+        "elapsed_s": round(elapsed, 3),
+        "rps": round(len(latencies) / elapsed, 2) if elapsed > 0 else 0,
+        "bytes": stats.bytes,
+        "reused": stats.reused,
+        "latency_ms": {
+            "p50": ms(percentile(latencies, 0.50)),
+            "p90": ms(percentile(latencies, 0.90)),
+            "p99": ms(percentile(latencies, 0.99)),
+            "max": ms(latencies[-1] if latencies else None),
+        },
+    }
+
+
+def pool_report(before, after):
+    """Picos e falhas dos pools do lwIP e marcas d'água de memória."""
+    if after is None:
+        return None
+
+    report = {"pools": {}, "memory": {}}
+    for key, value in after.items():
+        match = re.match(r'floodsense_lwip_pool_(\w+)\{pool="(\w+)"\}', key)
+        if match:
+            field, pool = match.groups()
+            entry = report["pools"].setdefault(pool, {})
+            entry[field] = value
+            if field == "alloc_failures_total" and before:
+                entry["alloc_failures_delta"] = value - before.get(key, 0)
+
+    for pool, entry in report["pools"].items():
+        entry["exhausted"] = entry.get("max_used", 0) >= entry.get("size", float("inf")) or \
+            entry.get("alloc_failures_delta", 0) > 0
+
+    for name in ("floodsense_heap_used_bytes", "floodsense_heap_arena_bytes",
+                 "floodsense_lwip_heap_used_bytes", "floodsense_lwip_heap_max_used_bytes"):
+        if name in after:
+            report["memory"][name.replace("floodsense_", "")] = after[name]
+
+    if before:
+        for name in ("floodsense_tcp_write_failures_total", "floodsense_http_requests_total"):
+            if name in after:
+                report[name.replace("floodsense_", "") + "_delta"] = after[name] - before.get(name, 0)
+
+    return report
+
+
+def memory_sample(metrics, t):
+    if metrics is None:
+        return None
+    return {
+        "t_s": round(t, 1),
+        "heap_used": metrics.get("floodsense_heap_used_bytes"),
+        "heap_arena": metrics.get("floodsense_heap_arena_bytes"),
+        "lwip_heap_used": metrics.get("floodsense_lwip_heap_used_bytes"),
+        "tcp_pcb_used": metrics.get('floodsense_lwip_pool_used{pool="TCP_PCB"}'),
+        "pbuf_pool_used": metrics.get('floodsense_lwip_pool_used{pool="PBUF_POOL"}'),
+    }
+
+
+def slope_per_hour(samples, key):
+    points = [(s["t_s"], s[key]) for s in samples if s and s.get(key) is not None]
+    if len(points) < 3:
+        return None
+    n = len(points)
+    mean_t = sum(t for t, _ in points) / n
+    mean_v = sum(v for _, v in points) / n
+    var = sum((t - mean_t) ** 2 for t, _ in points)
+    if var == 0:
+        return 0.0
+    cov = sum((t - mean_t) * (v - mean_v) for t, v in points)
+    return round(cov / var * 3600, 1)
+
+
+def run_load(args, sample_interval=None):
+    before = scrape(args.host, args.port, args.timeout)
+    stats = Stats()
+    stop = threading.Event()
+    samples = []
+
+    start = time.monotonic()
+    threads = start_clients(args, stats, stop)
+    end = start + args.duration
+    next_sample = start
+
+    while time.monotonic() < end:
+        if sample_interval and time.monotonic() >= next_sample:
+            samples.append(memory_sample(scrape(args.host, args.port, args.timeout), time.monotonic() - start))
+            next_sample += sample_interval
+            if not args.json_only:
+                last = samples[-1]
+                print(f"[{last['t_s'] if last else '?'}s] {len(stats.latencies)} req, "
+                      f"heap={last and last['heap_used']} pcb={last and last['tcp_pcb_used']}",
+                      file=sys.stderr, flush=True)
+        time.sleep(min(0.2, max(0.0, end - time.monotonic())))
+
+    stop.set()
+    for thread in threads:
+        thread.join(args.timeout + 1)
+    elapsed = time.monotonic() - start
+
+    # Espera as conexões encerrarem antes da leitura final
+    time.sleep(args.settle)
+    after = scrape(args.host, args.port, args.timeout)
+
+    result = summarize(stats, elapsed)
+    result["lwip"] = pool_report(before, after)
+    return result, before, after, samples
+
+
+# ---------------------------------------------------------------------------
+# Processo da simulação
+
+def spawn_node(args):
+    command = [args.spawn, "--quiet", "--port-offset", str(args.port_offset)]
+    process = subprocess.Popen(command, stdin=subprocess.PIPE, stdout=subprocess.DEVNULL)
+    deadline = time.monotonic() + 10
+    while time.monotonic() < deadline:
+        if process.poll() is not None:
+            raise SystemExit(f"{args.spawn} terminou com código {process.returncode}")
+        try:
+            socket.create_connection((args.host, args.port), timeout=0.5).close()
+            return process
+        except OSError:
+            time.sleep(0.1)
+    process.kill()
+    raise SystemExit("a simulação não abriu a porta HTTP")
+
+
+def config(args):
+    keys = ("command", "mode", "concurrency", "duration", "path", "timeout", "think")
+    return {k: getattr(args, k) for k in keys if hasattr(args, k)}
+
+
+def emit(args, report):
+    if args.json:
+        with open(args.json, "w") as out:
+            json.dump(report, out, indent=2)
+    if args.json_only:
+        json.dump(report, sys.stdout, indent=2)
+        print()
+        return
+
+    r = report["result"]
+    lat = r["latency_ms"]
+    print(f"{r['requests']} requisições em {r['elapsed_s']} s: {r['rps']} req/s, "
+          f"p50={lat['p50']} ms p99={lat['p99']} ms max={lat['max']} ms, "
+          f"reutilizadas={r.get('reused', 0)}, erros={r['errors']}")
+    lwip = r.get("lwip")
+    if lwip:
+        for pool, entry in lwip["pools"].items():
+            flag = "  << ESGOTADO" if entry.get("exhausted") else ""
+            print(f"  {pool:<16} pico {entry.get('max_used', 0):.0f}/{entry.get('size', 0):.0f}"
+                  f" falhas {entry.get('alloc_failures_total', 0):.0f}{flag}")
+        print("  memória: " + ", ".join(f"{k}={v:.0f}" for k, v in lwip["memory"].items()))
+    if "leak" in report:
+        leak = report["leak"]
+        print(f"  soak: heap {leak['heap_used_slope_bytes_per_hour']} B/h, "
+              f"PCBs após a carga {leak['tcp_pcb_used_after']} (antes {leak['tcp_pcb_used_before']}), "
+              f"suspeita de vazamento: {leak['suspected']}")
+
+
+def cmd_run(args):
+    result, _, _, _ = run_load(args)
+    emit(args, {"config": config(args), "result": result})
+    return 0
+
+
+def cmd_soak(args):
+    result, before, after, samples = run_load(args, args.sample_interval)
+
+    # Descarta o aquecimento: alocações feitas uma única vez não são vazamento
+    warm = [s for s in samples if s and s["t_s"] >= args.warmup]
+    used_slope = slope_per_hour(warm, "heap_used")
+    lwip_slope = slope_per_hour(warm, "lwip_heap_used")
+    pcb_before = before and before.get('floodsense_lwip_pool_used{pool="TCP_PCB"}')
+    pcb_after = after and after.get('floodsense_lwip_pool_used{pool="TCP_PCB"}')
+
+    suspected = bool(
+        (used_slope is not None and used_slope > args.leak_threshold) or
+        (lwip_slope is not None and lwip_slope > args.leak_threshold) or
+        (pcb_before is not None and pcb_after is not None and pcb_after > pcb_before))
+
+    report = {
+        "config": dict(config(args), sample_interval=args.sample_interval, warmup=args.warmup),
+        "result": result,
+        "samples": samples,
+        "leak": {
+            "heap_used_slope_bytes_per_hour": used_slope,
+            "lwip_heap_used_slope_bytes_per_hour": lwip_slope,
+            "tcp_pcb_used_before": pcb_before,
+            "tcp_pcb_used_after": pcb_after,
+            "suspected": suspected,
+        },
+    }
+    emit(args, report)
+    return 1 if suspected else 0
+
+
+def cmd_compare(args):
+    """Compara dois relatórios JSON; falha se a regressão passar da tolerância."""
+    base = json.load(open(args.base))["result"]
+    new = json.load(open(args.new))["result"]
+    checks = [
+        ("rps", base["rps"], new["rps"], True),
+        ("p50_ms", base["latency_ms"]["p50"], new["latency_ms"]["p50"], False),
+        ("p99_ms", base["latency_ms"]["p99"], new["latency_ms"]["p99"], False),
+        ("error_total", base["error_total"], new["error_total"], False),
+    ]
+    failed = False
+    for name, old, cur, higher_is_better in checks:
+        if old is None or cur is None:
+            continue
+        change = (cur - old) / old * 100 if old else (0.0 if cur == old else float("inf"))
+        worse = -change if higher_is_better else change
+        regression = worse > args.tolerance
+        failed |= regression
+        print(f"{name:<12} {old:>10} -> {cur:<10} ({change:+.1f}%){'  REGRESSÃO' if regression else ''}")
+    return 1 if failed else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    def load_options(p, duration):
+        p.add_argument("--target", default="127.0.0.1:8080", help="host:porta do nó")
+        p.add_argument("--spawn", help="inicia este binário da simulação antes do teste")
+        p.add_argument("--port-offset", type=int, default=0, help="--port-offset passado à simulação")
+        p.add_argument("--mode", choices=("keepalive", "close", "mixed"), default="mixed")
+        p.add_argument("--concurrency", type=int, default=4, help="clientes simultâneos")
+        p.add_argument("--duration", type=float, default=duration, help="duração da carga (s)")
+        p.add_argument("--path", default="/", help="caminho requisitado")
+        p.add_argument("--timeout", type=float, default=5.0, help="limite por requisição (s)")
+        p.add_argument("--think", type=float, default=0.0, help="pausa entre requisições de um cliente (s)")
+        p.add_argument("--end-marker", default="</html>", help="marcador de fim da resposta ('' = esperar o fechamento)")
+        p.add_argument("--settle", type=float, default=3.0, help="espera antes da leitura final de /metrics (s)")
+        p.add_argument("--json", help="grava o relatório neste arquivo")
+        p.add_argument("--json-only", action="store_true", help="imprime só o JSON em stdout")
+
+    run = sub.add_parser("run", help="carga com duração fixa")
+    load_options(run, 10.0)
+
+    soak = sub.add_parser("soak", help="carga longa com amostragem de memória e detecção de vazamentos")
+    load_options(soak, 600.0)
+    soak.add_argument("--sample-interval", type=float, default=10.0, help="intervalo entre leituras de /metrics (s)")
+    soak.add_argument("--warmup", type=float, default=30.0, help="amostras iniciais ignoradas no ajuste (s)")
+    soak.add_argument("--leak-threshold", type=float, default=1024.0, help="crescimento tolerado (bytes/hora)")
+
+    compare = sub.add_parser("compare", help="compara dois relatórios JSON")
+    compare.add_argument("base")
+    compare.add_argument("new")
+    compare.add_argument("--tolerance", type=float, default=10.0, help="piora tolerada (%%)")
+
+    args = parser.parse_args()
+    if args.command == "compare":
+        return cmd_compare(args)
+
+    host, _, port = args.target.partition(":")
+    args.host, args.port = host, int(port or 80)
+
+    process = None
+    if args.spawn:
+        args.port = 8080 + args.port_offset
+        process = spawn_node(args)
+
+    try:
+        return cmd_run(args) if args.command == "run" else cmd_soak(args)
+    finally:
+        if process:
+            process.terminate()
+            process.wait(5)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
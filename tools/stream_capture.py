@@ -0,0 +1,211 @@
+#!/usr/bin/env python3
+"""Captura do stream binário de amostras do FloodSense (USB CDC).
+
+Lê os quadros COBS do console USB (ou de um arquivo/stdin), confere o CRC e a
+sequência e grava as amostras em CSV. Texto do console entre os quadros é
+repassado para o stderr.
+
+Exemplos:
+  tools/stream_capture.py /dev/ttyACM0 --start -o bancada.csv --seconds 60
+  tools/stream_capture.py /dev/ttyACM0 --start --trace trace.csv --bin bruto.bin
+  (sleep 1; printf S; sleep 5) | ./build/Flood_Sense_host | tools/stream_capture.py - -o sim.csv
+
+--start envia o comando 'S' ao abrir o dispositivo e de novo ao sair.
+--trace grava os níveis brutos no formato do benchmark do filtro
+(time_ms,level_a,level_b), para repetir a captura no Flood_Sense_filter_bench.
+Tanto o --trace quanto o --bin podem ser repetidos pelo pipeline inteiro no
+Flood_Sense_replay.
+
+O layout dos quadros está documentado em lib/Stream.h.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import time
+import zlib
+
+VERSION = 1
+HEADER = struct.Struct("<BBHIII")
+RECORD = struct.Struct("<HHhh")
+REJECTED = 0x8000
+RANGE_M = 32  # SENSOR_RANGE_M
+FILTER_ONE = 256.0
+
+
+def cobs_decode(data):
+    """Decodifica um bloco COBS; retorna None se ele estiver malformado."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def decode_frame(chunk):
+    """Decodifica um quadro; retorna (cabeçalho, registros) ou None."""
+    payload = cobs_decode(chunk)
+    if payload is None or len(payload) < HEADER.size + 4:
+        return None
+
+    body, crc = payload[:-4], struct.unpack("<I", payload[-4:])[0]
+    if zlib.crc32(body) != crc:
+        return None
+
+    version, count, period_us, seq, time_us, lost = HEADER.unpack_from(body)
+    if version != VERSION or len(body) != HEADER.size + count * RECORD.size:
+        return None
+
+    records = [RECORD.unpack_from(body, HEADER.size + i * RECORD.size) for i in range(count)]
+    return {"seq": seq, "period_us": period_us, "time_us": time_us, "lost": lost}, records
+
+
+def is_text(chunk):
+    try:
+        text = chunk.decode("utf-8")
+    except UnicodeDecodeError:
+        return False
+    return all(c.isprintable() or c in "\t\r\n" for c in text)
+
+
+class Capture:
+    def __init__(self, args):
+        self.csv = open(args.output, "w") if args.output else None
+        self.trace = open(args.trace, "w") if args.trace else None
+        self.frames = self.samples = self.bad = self.gaps = 0
+        self.lost = 0
+        self.last_seq = None
+        self.epoch_us = 0
+        self.last_time = None
+        self.first_us = self.end_us = None
+
+        if self.csv:
+            self.csv.write("time_us,raw_a,raw_b,filtered_a,filtered_b,rejected_a,rejected_b\n")
+        if self.trace:
+            self.trace.write("time_ms,level_a,level_b\n")
+
+    def chunk(self, chunk):
+        if not chunk:
+            return
+
+        frame = decode_frame(chunk)
+        if frame is None:
+            if is_text(chunk):
+                sys.stderr.write("console: " + chunk.decode("utf-8", "replace").strip() + "\n")
+            else:
+                self.bad += 1
+            return
+
+        header, records = frame
+        if header["seq"] == 0:
+            self.last_seq = None  # Stream religado
+        if self.last_seq is not None and header["seq"] != self.last_seq + 1:
+            self.gaps += header["seq"] - self.last_seq - 1
+        self.last_seq = header["seq"]
+        self.lost = header["lost"]
+
+        # Instante em 32 bits: desfaz a volta do contador (~71 min)
+        if self.last_time is not None and header["time_us"] < self.last_time:
+            self.epoch_us += 1 << 32
+        self.last_time = header["time_us"]
+        start = self.epoch_us + header["time_us"]
+
+        for i, (raw_a, raw_b, filt_a, filt_b) in enumerate(records):
+            t = start + i * header["period_us"]
+            a, b = raw_a & 0x0FFF, raw_b & 0x0FFF
+
+            if self.csv:
+                self.csv.write(f"{t},{a},{b},{filt_a / FILTER_ONE:.4f},{filt_b / FILTER_ONE:.4f},"
+                               f"{int(bool(raw_a & REJECTED))},{int(bool(raw_b & REJECTED))}\n")
+            if self.trace:
+                self.trace.write(f"{t / 1000:.3f},{a * RANGE_M / 4095:.3f},{b * RANGE_M / 4095:.3f}\n")
+
+        if self.first_us is None:
+            self.first_us = start
+        self.end_us = start + len(records) * header["period_us"]
+        self.frames += 1
+        self.samples += len(records)
+
+    def summary(self):
+        elapsed = (self.end_us - self.first_us) / 1e6 if self.frames else 0
+        rate = self.samples / elapsed if elapsed else 0
+        print(f"{self.frames} quadros, {self.samples} amostras ({rate:.0f} amostras/s no relógio do nó); "
+              f"quadros inválidos {self.bad}, perdidos no caminho {self.gaps}, "
+              f"amostras perdidas no nó {self.lost}", file=sys.stderr)
+
+        for f in (self.csv, self.trace):
+            if f:
+                f.close()
+
+
+def open_source(path):
+    if path == "-":
+        return sys.stdin.buffer.raw if hasattr(sys.stdin.buffer, "raw") else sys.stdin.buffer, None
+
+    fd = os.open(path, os.O_RDWR | os.O_NOCTTY) if os.path.exists(path) else None
+    if fd is None:
+        raise SystemExit(f"{path}: não encontrado")
+
+    if os.isatty(fd):
+        import termios
+        import tty
+        tty.setraw(fd)
+        attrs = termios.tcgetattr(fd)
+        attrs[3] &= ~termios.ECHO
+        termios.tcsetattr(fd, termios.TCSANOW, attrs)
+
+    return os.fdopen(fd, "rb", buffering=0), fd
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("source", help="dispositivo serial, arquivo ou - (stdin)")
+    parser.add_argument("-o", "--output", help="CSV com as amostras brutas e filtradas")
+    parser.add_argument("--trace", help="CSV time_ms,level_a,level_b para o benchmark do filtro")
+    parser.add_argument("--bin", help="cópia dos bytes recebidos, para repetir a decodificação")
+    parser.add_argument("--start", action="store_true", help="envia 'S' ao abrir e ao sair")
+    parser.add_argument("--seconds", type=float, help="encerra depois de N segundos")
+    args = parser.parse_args()
+
+    source, fd = open_source(args.source)
+    dump = open(args.bin, "wb") if args.bin else None
+    capture = Capture(args)
+    deadline = time.monotonic() + args.seconds if args.seconds else None
+    pending = bytearray()
+
+    if args.start and fd is not None:
+        os.write(fd, b"S")
+
+    try:
+        while deadline is None or time.monotonic() < deadline:
+            data = source.read(4096)
+            if not data:
+                break
+            if dump:
+                dump.write(data)
+
+            pending += data
+            *chunks, rest = pending.split(b"\x00")
+            pending = bytearray(rest)
+            for chunk in chunks:
+                capture.chunk(bytes(chunk))
+    except KeyboardInterrupt:
+        pass
+    finally:
+        capture.chunk(bytes(pending))
+        if args.start and fd is not None:
+            os.write(fd, b"S")
+        if dump:
+            dump.close()
+        capture.summary()
+
+
+if __name__ == "__main__":
+    main()
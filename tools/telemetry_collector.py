@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""Coletor de referência da telemetria UDP do FloodSense.
+
+Modos:
+  poll   envia requisições para um ou mais nós e imprime as respostas
+  listen recebe os relatórios periódicos (broadcast/multicast)
+
+Exemplos:
+  tools/telemetry_collector.py poll 192.168.0.50
+  tools/telemetry_collector.py poll 127.0.0.1:5005 127.0.0.1:5006 --count 5
+  tools/telemetry_collector.py listen --port 5006 --json
+  tools/telemetry_collector.py listen --group 239.255.70.83
+
+O layout dos pacotes está documentado em lib/Telemetry.h.
+"""
+
+import argparse
+import json
+import socket
+import struct
+import sys
+import time
+
+VERSION = 1
+TYPE_REQUEST = 0x01
+TYPE_REPORT = 0x02
+
+NODE_PORT = 5005
+COLLECTOR_PORT = 5006
+
+HEADER = struct.Struct("<2sBBIIIHBB")
+REGION = struct.Struct("<BBBBBBH")
+
+CLASSES = ("Normal", "Atenção", "Alerta")
+LEDS = ("apagado", "verde", "laranja", "vermelho", "outro")
+
+
+def build_request(seq):
+    return HEADER.pack(b"FS", VERSION, TYPE_REQUEST, seq, 0, 0, 0, 0, 0)
+
+
+def decode_report(data):
+    """Decodifica um relatório; retorna None se o pacote não for válido."""
+    if len(data) < HEADER.size:
+        return None
+
+    magic, version, kind, seq, ack, uptime_ms, node_id, flags, count = HEADER.unpack_from(data)
+    if magic != b"FS" or version != VERSION or kind != TYPE_REPORT:
+        return None
+    if len(data) < HEADER.size + count * REGION.size:
+        return None
+
+    regions = []
+    for i in range(count):
+        level, cls, led, buzzer, attention, alert, _ = REGION.unpack_from(data, HEADER.size + i * REGION.size)
+        regions.append({
+            "region": chr(ord("A") + i),
+            "level": level,
+            "class": CLASSES[cls] if cls < len(CLASSES) else cls,
+            "led": LEDS[led] if led < len(LEDS) else led,
+            "buzzer": bool(buzzer),
+            "attention_threshold": attention,
+            "alert_threshold": alert,
+        })
+
+    return {
+        "node_id": node_id,
+        "seq": seq,
+        "ack": ack,
+        "uptime_ms": uptime_ms,
+        "selected": "A" if flags & 0x01 else "B",
+        "regions": regions,
+    }
+
+
+def format_report(report, source, as_json):
+    if as_json:
+        return json.dumps(dict(report, source=source), ensure_ascii=False)
+
+    parts = [f"{source} node={report['node_id']:04x} seq={report['seq']} "
+             f"uptime={report['uptime_ms'] / 1000:.1f}s sel={report['selected']}"]
+    for r in report["regions"]:
+        parts.append(f"{r['region']}: {r['level']}m {r['class']} led={r['led']} "
+                     f"buzzer={'on' if r['buzzer'] else 'off'}")
+    return " | ".join(parts)
+
+
+def parse_node(text):
+    host, _, port = text.partition(":")
+    return host, int(port) if port else NODE_PORT
+
+
+def cmd_poll(args):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.settimeout(args.timeout)
+    nodes = [parse_node(n) for n in args.nodes]
+    seq = 1
+    failures = 0
+
+    for round_index in range(args.count):
+        # Envia todas as requisições de uma vez e depois coleta as respostas
+        pending = {}
+        for node in nodes:
+            addr = (socket.gethostbyname(node[0]), node[1])
+            sock.sendto(build_request(seq), addr)
+            pending[seq] = (addr, time.monotonic())
+            seq += 1
+
+        deadline = time.monotonic() + args.timeout
+        while pending and time.monotonic() < deadline:
+            sock.settimeout(max(0.001, deadline - time.monotonic()))
+            try:
+                data, source = sock.recvfrom(512)
+            except socket.timeout:
+                break
+            report = decode_report(data)
+            if report is None or report["ack"] not in pending:
+                continue
+            _, sent_at = pending.pop(report["ack"])
+            report["rtt_ms"] = round((time.monotonic() - sent_at) * 1000, 3)
+            print(format_report(report, f"{source[0]}:{source[1]}", args.json), flush=True)
+
+        for addr, _ in pending.values():
+            failures += 1
+            print(f"{addr[0]}:{addr[1]} sem resposta", file=sys.stderr)
+
+        if round_index + 1 < args.count:
+            time.sleep(args.interval)
+
+    return 1 if failures else 0
+
+
+def cmd_listen(args):
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    sock.bind(("", args.port))
+
+    if args.group:
+        mreq = struct.pack("4s4s", socket.inet_aton(args.group), socket.inet_aton("0.0.0.0"))
+        sock.setsockopt(socket.IPPROTO_IP, socket.IP_ADD_MEMBERSHIP, mreq)
+
+    last_seq = {}
+    received = 0
+    while args.count == 0 or received < args.count:
+        data, source = sock.recvfrom(512)
+        report = decode_report(data)
+        if report is None:
+            continue
+
+        # Lacunas na sequência indicam relatórios perdidos
+        previous = last_seq.get(report["node_id"])
+        if previous is not None and report["seq"] > previous + 1:
+            report["lost"] = report["seq"] - previous - 1
+        last_seq[report["node_id"]] = report["seq"]
+
+        print(format_report(report, f"{source[0]}:{source[1]}", args.json), flush=True)
+        received += 1
+
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    poll = sub.add_parser("poll", help="requisita o estado de nós específicos")
+    poll.add_argument("nodes", nargs="+", help="host[:porta] (porta padrão %d)" % NODE_PORT)
+    poll.add_argument("--count", type=int, default=1, help="número de rodadas")
+    poll.add_argument("--interval", type=float, default=1.0, help="intervalo entre rodadas (s)")
+    poll.add_argument("--timeout", type=float, default=1.0, help="espera por resposta (s)")
+    poll.add_argument("--json", action="store_true", help="uma linha JSON por relatório")
+
+    listen = sub.add_parser("listen", help="recebe os relatórios periódicos")
+    listen.add_argument("--port", type=int, default=COLLECTOR_PORT)
+    listen.add_argument("--group", help="grupo multicast a ingressar")
+    listen.add_argument("--count", type=int, default=0, help="encerra após N relatórios (0 = infinito)")
+    listen.add_argument("--json", action="store_true", help="uma linha JSON por relatório")
+
+    args = parser.parse_args()
+    return cmd_poll(args) if args.command == "poll" else cmd_listen(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
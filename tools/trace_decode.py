@@ -0,0 +1,143 @@
+#!/usr/bin/env python3
+"""Decodificador do anel de trace do FloodSense.
+
+Converte o despejo do comando 'T' do console USB no formato de trace do
+Chrome (abrir em chrome://tracing ou https://ui.perfetto.dev). Linhas que
+não pertencem ao despejo (logs do firmware) são ignoradas.
+
+Exemplos:
+  tools/trace_decode.py captura.txt -o trace.json
+  tools/trace_decode.py --serial /dev/ttyACM0 -o trace.json   (requer pyserial)
+  printf 'T' | ./Flood_Sense_host | tools/trace_decode.py - -o trace.json
+
+O formato dos registros está documentado em lib/Trace.h.
+"""
+
+import argparse
+import json
+import struct
+import sys
+import time
+
+RECORD = struct.Struct("<IBBH")
+PHASES = {0: "B", 1: "E"}
+
+
+def read_dump(lines):
+    """Extrai eventos e registros do último despejo completo encontrado."""
+    events, records, dropped = {}, [], 0
+    inside = False
+    done = None
+
+    for line in lines:
+        line = line.strip()
+        if line.startswith("# floodsense-trace"):
+            events, records, dropped, inside = {}, [], 0, True
+        elif not inside:
+            continue
+        elif line.startswith("# records"):
+            dropped = int(line.split()[4])
+        elif line.startswith("E "):
+            _, event_id, context, name = line.split(maxsplit=3)
+            events[int(event_id)] = (context, name)
+        elif line.startswith("D "):
+            raw = bytes.fromhex(line[2:])
+            records.extend(RECORD.iter_unpack(raw[:len(raw) - len(raw) % RECORD.size]))
+        elif line == "# end":
+            done = (events, records, dropped)
+            inside = False
+
+    if done is None:
+        raise SystemExit("despejo de trace não encontrado (ou incompleto)")
+    return done
+
+
+def to_chrome(events, records):
+    """Gera os eventos do Chrome, desembrulhando o timer de 32 bits."""
+    contexts = sorted({context for context, _ in events.values()})
+    tids = {context: i + 1 for i, context in enumerate(contexts)}
+    out = [{"name": "thread_name", "ph": "M", "pid": 1, "tid": tid, "args": {"name": context}}
+           for context, tid in tids.items()]
+
+    stacks = {tid: [] for tid in tids.values()}
+    spans = []
+    base = records[0][0] if records else 0
+    offset, previous = 0, base
+
+    for timestamp, event_id, phase, arg in records:
+        if timestamp < previous and previous - timestamp > 1 << 31:
+            offset += 1 << 32
+        previous = timestamp
+        ts = timestamp + offset - base
+
+        context, name = events.get(event_id, ("?", f"evento_{event_id}"))
+        tid = tids.setdefault(context, len(tids) + 1)
+        stack = stacks.setdefault(tid, [])
+
+        if PHASES.get(phase) == "B":
+            stack.append((event_id, ts))
+        elif PHASES.get(phase) == "E":
+            # Fim sem início: o início foi sobrescrito no anel
+            if not stack or stack[-1][0] != event_id:
+                continue
+            spans.append((ts - stack.pop()[1], name, ts))
+        else:
+            continue
+
+        entry = {"name": name, "ph": PHASES[phase], "ts": ts, "pid": 1, "tid": tid}
+        if arg:
+            entry["args"] = {"arg": arg}
+        out.append(entry)
+
+    return out, spans
+
+
+def read_serial(port, timeout):
+    import serial  # pyserial
+
+    with serial.Serial(port, timeout=0.5) as link:
+        link.reset_input_buffer()
+        link.write(b"T")
+        lines, deadline = [], time.monotonic() + timeout
+        while time.monotonic() < deadline:
+            line = link.readline().decode("utf-8", "replace")
+            lines.append(line)
+            if line.strip() == "# end":
+                break
+        return lines
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", nargs="?", default="-", help="arquivo com o despejo ('-' = stdin)")
+    parser.add_argument("--serial", help="porta do console USB; envia 'T' e lê o despejo")
+    parser.add_argument("--timeout", type=float, default=10.0, help="espera pelo despejo na serial (s)")
+    parser.add_argument("-o", "--output", help="arquivo JSON de saída (padrão: stdout)")
+    parser.add_argument("--top", type=int, default=5, help="intervalos mais longos listados no resumo")
+    args = parser.parse_args()
+
+    if args.serial:
+        lines = read_serial(args.serial, args.timeout)
+    elif args.input == "-":
+        lines = sys.stdin
+    else:
+        lines = open(args.input, encoding="utf-8", errors="replace")
+
+    events, records, dropped = read_dump(lines)
+    trace, spans = to_chrome(events, records)
+
+    output = open(args.output, "w") if args.output else sys.stdout
+    json.dump({"traceEvents": trace, "displayTimeUnit": "ms"}, output)
+    if args.output:
+        output.close()
+
+    # Resumo: os intervalos mais longos costumam ser os travamentos
+    print(f"{len(records)} registros, {dropped} sobrescritos", file=sys.stderr)
+    for duration, name, ts in sorted(spans, reverse=True)[:args.top]:
+        print(f"  {name:<16} {duration / 1000:9.3f} ms  em t={ts / 1000:.3f} ms", file=sys.stderr)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+"""Receptor de referência dos webhooks de alerta do FloodSense.
+
+Servidor HTTP local que imprime cada POST recebido. Serve para testar as
+entregas, o backoff e o agrupamento contra a simulação (ou um nó real) sem
+depender de um serviço externo.
+
+Exemplos:
+  tools/webhook_sink.py --port 9000
+  tools/webhook_sink.py --port 9001 --fail 3            # 503 nos 3 primeiros
+  tools/webhook_sink.py --port 9002 --status 404        # rejeição permanente
+
+Com a simulação:
+  cmake -S . -B build-wh -DCMAKE_C_FLAGS='-DWEBHOOK_URLS=\\"127.0.0.1:9000/alerta\\"'
+  cmake --build build-wh && ./build-wh/Flood_Sense_host
+"""
+
+import argparse
+import json
+import sys
+import time
+from http.server import BaseHTTPRequestHandler, HTTPServer
+
+
+def make_handler(args):
+    state = {"count": 0, "start": time.monotonic()}
+
+    class Handler(BaseHTTPRequestHandler):
+        def do_POST(self):
+            state["count"] += 1
+            length = int(self.headers.get("Content-Length", 0))
+            body = self.rfile.read(length).decode("utf-8", "replace")
+            status = args.status
+
+            if state["count"] <= args.fail:
+                status = 503
+
+            elapsed = time.monotonic() - state["start"]
+            try:
+                payload = json.dumps(json.loads(body), ensure_ascii=False)
+            except ValueError:
+                payload = repr(body)
+            print(f"{elapsed:8.3f} #{state['count']} {self.path} -> {status} {payload}", flush=True)
+
+            self.send_response(status)
+            self.send_header("Content-Length", "0")
+            self.send_header("Connection", "close")
+            self.end_headers()
+
+        def log_message(self, format, *args):
+            pass
+
+    return Handler
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--bind", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=9000)
+    parser.add_argument("--status", type=int, default=200, help="status das respostas (padrão 200)")
+    parser.add_argument("--fail", type=int, default=0, help="responde 503 aos N primeiros POSTs")
+    args = parser.parse_args()
+
+    server = HTTPServer((args.bind, args.port), make_handler(args))
+    print(f"webhook_sink em {args.bind}:{args.port}", file=sys.stderr, flush=True)
+
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()